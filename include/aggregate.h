@@ -0,0 +1,58 @@
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "SoilSensor.h"
+
+/**
+ * @file aggregate.h
+ * @brief Cascading minute/hour/day statistics of selected channels.
+ * @details Samples accumulate into an open minute bucket. When a minute
+ *          closes it is merged into the open hour bucket and pushed onto the
+ *          minute ring; hours cascade into days the same way. Each step is
+ *          O(1) per sample. Periods without samples are skipped rather than
+ *          stored as empty buckets.
+ *
+ *          Open buckets keep exact running sums (a 64-bit sum of squares);
+ *          a closing bucket is reduced to its Summary, which is all the
+ *          minute, hour and day rings store.
+ */
+namespace aggregate {
+
+enum class Level : uint8_t { MINUTE = 0, HOUR = 1, DAY = 2 };
+constexpr uint8_t LEVEL_COUNT = 3U;
+
+/**
+ * @brief Statistics of one bucket, in the channel's fixed-point units.
+ */
+struct Summary {
+    uint16_t count;   ///< Samples in the bucket (0: no data).
+    int16_t min;
+    int16_t max;
+    int16_t mean;     ///< Rounded to the channel's resolution.
+    uint16_t stddev;  ///< Population standard deviation.
+};
+
+} // namespace aggregate
+
+/**
+ * @brief Adds one sample (timestamped in ms) to every aggregated channel.
+ * @details Called from the idle loop for every sample in order; missing
+ *          channel values are ignored.
+ */
+void aggregate_add(uint32_t timestamp_ms, const SoilSensor::SensorData& data) noexcept;
+
+/**
+ * @brief Looks up one bucket.
+ * @param slot Index into aggregates::CHANNELS.
+ * @param age 0: the open (partial) bucket, including lower levels not yet
+ *            cascaded; 1..: closed buckets, newest first.
+ * @return false if @p slot or @p age is out of range or the bucket is empty.
+ */
+bool aggregate_get(uint8_t slot, aggregate::Level level, uint8_t age, aggregate::Summary& out) noexcept;
+
+/// Number of closed buckets kept for @p level.
+uint8_t aggregate_depth(aggregate::Level level) noexcept;
+
+#endif // AGGREGATE_H
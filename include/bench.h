@@ -0,0 +1,19 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include "config.h"
+
+class Print;
+
+/**
+ * @brief Runs the start-up micro-benchmarks and prints one line per result.
+ * @details Measurements are taken with interrupts disabled against the
+ *          Timer1 timebase, so they exclude ISR time but are quantised to
+ *          its resolution; each figure is averaged over a batch of calls.
+ *          Call once after sei(), before entering the idle loop; it blocks
+ *          for a few tens of milliseconds.
+ */
+void bench_run(Print& out) noexcept;
+
+#endif // BENCH_H
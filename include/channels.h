@@ -0,0 +1,56 @@
+#ifndef CHANNELS_H
+#define CHANNELS_H
+
+#include <stdint.h>
+#include "SoilSensor.h"
+
+/**
+ * @file channels.h
+ * @brief Uniform per-channel access to SoilSensor::SensorData.
+ * @details Filters, trends, pages and logs treat a reading as seven int16
+ *          channels in the sensor's fixed-point units, with GAP standing in
+ *          for a field whose register block failed to read.
+ */
+namespace channels {
+
+// Channel indices (SensorData field order)
+constexpr uint8_t MOISTURE = 0;
+constexpr uint8_t TEMPERATURE = 1;
+constexpr uint8_t CONDUCTIVITY = 2;
+constexpr uint8_t PH = 3;
+constexpr uint8_t NITROGEN = 4;
+constexpr uint8_t PHOSPHORUS = 5;
+constexpr uint8_t POTASSIUM = 6;
+constexpr uint8_t COUNT = 7;
+
+/// Channel value of a field that failed to read.
+constexpr int16_t GAP = -32768;
+
+/**
+ * @brief Display metadata of one channel.
+ */
+struct Info {
+    const char* label;  ///< Short name for a 16-column line (PROGMEM).
+    uint8_t decimals;   ///< Fixed-point decimals of the SensorData field.
+};
+
+/**
+ * @brief Value of channel @p ch in @p data, or GAP if invalid or unknown.
+ * @details Values above INT16_MAX (not produced by the sensor's documented
+ *          ranges) are clamped.
+ */
+int16_t value(const SoilSensor::SensorData& data, uint8_t ch) noexcept;
+
+/**
+ * @brief Stores @p v into channel @p ch of @p data.
+ * @details GAP becomes the field's INVALID marker; negative values of
+ *          unsigned fields are clamped to 0.
+ */
+void setValue(SoilSensor::SensorData& data, uint8_t ch, int16_t v) noexcept;
+
+/// Metadata for @p ch (index clamped to the last channel), copied from flash.
+Info info(uint8_t ch) noexcept;
+
+} // namespace channels
+
+#endif // CHANNELS_H
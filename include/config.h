@@ -10,6 +10,24 @@
 #if !defined(ENABLE_SENSOR)
 #define ENABLE_SENSOR 1
 #endif
+#if !defined(ENABLE_PROFILER)
+#define ENABLE_PROFILER 1
+#endif
+#if !defined(ENABLE_FILTERS)
+#define ENABLE_FILTERS 1
+#endif
+#if !defined(ENABLE_BENCHMARKS)
+#define ENABLE_BENCHMARKS 0
+#endif
+#if !defined(ENABLE_EEPROM_LOG)
+#define ENABLE_EEPROM_LOG 1
+#endif
+#if !defined(ENABLE_TELEMETRY)
+#define ENABLE_TELEMETRY 1
+#endif
+#if !defined(ENABLE_CONSOLE)
+#define ENABLE_CONSOLE 1
+#endif
 
 
 // JSF AV C++ Rule 10: The #define directive shall not be used to create constants.
@@ -38,17 +56,96 @@ namespace pins {
     constexpr uint8_t LED_PIN_B5 = 13; // Standard Arduino Uno LED
 }
 
+// Sensor bus discovery (console "discover" command)
+namespace sensor_bus {
+    // Baud rates tried in order, each with slave addresses 1..DISCOVERY_MAX_ADDRESS;
+    // a silent address costs the 2 s Modbus timeout
+    constexpr uint8_t DISCOVERY_BAUD_COUNT = 3;
+    constexpr uint16_t DISCOVERY_BAUDS[DISCOVERY_BAUD_COUNT] = { 9600, 4800, 2400 };
+    constexpr uint8_t DISCOVERY_MAX_ADDRESS = 5;
+}
+
 // Task scheduling periods in milliseconds
 namespace timing {
     constexpr uint32_t LED_TOGGLE_PERIOD_MS = 100;
     constexpr uint32_t SENSOR_READ_PERIOD_MS = 2000;
     constexpr uint32_t LCD_UPDATE_PERIOD_MS = 4000; // Slower update to reduce flicker
+    constexpr uint32_t PROFILER_REPORT_PERIOD_MS = 60000; // Idle-loop profiler dump
+}
+
+// Inter-task buffers
+namespace buffers {
+    // Samples queued from the sensor task to the idle-loop consumer (power of two)
+    constexpr uint8_t SAMPLE_QUEUE_DEPTH = 2;
+    // Deferred log messages awaiting the idle loop (power of two, 15 bytes each)
+    constexpr uint8_t LOG_QUEUE_DEPTH = 4;
+}
+
+// Logging (logger.h)
+namespace logging {
+    // Highest level compiled in: 0 error, 1 warn, 2 info, 3 debug
+    constexpr uint8_t MAX_LEVEL = 2;
+}
+
+// Rolling statistics (aggregate.h)
+namespace aggregates {
+    // Channels aggregated (channels.h indices); each costs ~200 bytes of RAM
+    constexpr uint8_t CHANNEL_COUNT = 1;
+    constexpr uint8_t CHANNELS[CHANNEL_COUNT] = { 0 }; // Moisture
+
+    // Closed buckets kept per level
+    constexpr uint8_t MINUTE_SLOTS = 5;
+    constexpr uint8_t HOUR_SLOTS = 6;
+    constexpr uint8_t DAY_SLOTS = 3;
+
+    // Hard cap on the engine's static RAM, checked at compile time
+    constexpr uint16_t RAM_BUDGET_BYTES = 224;
+}
+
+// Persistent sample log (eelog.h)
+namespace storage {
+    constexpr uint16_t EEPROM_BYTES = 1024; // ATmega328P
+    constexpr uint16_t LOG_BASE = 0;
+    constexpr uint16_t LOG_PAGE_BYTES = 128;
+    constexpr uint8_t LOG_PAGE_COUNT = 8;
+
+    // Minimum spacing of records; at one record per 60 s a cell is rewritten
+    // about every two hours, which keeps the 100k-cycle endurance beyond 20 years
+    constexpr uint32_t LOG_PERIOD_MS = 60000;
+    // Longest gap between records while every channel stays in its deadband
+    constexpr uint32_t LOG_HEARTBEAT_MS = 900000;
+}
+
+// Binary telemetry on the USB serial port (telemetry.h)
+namespace telemetry {
+    constexpr long BAUD_RATE = 57600; // Replaces pins::SERIAL_BAUD_RATE on the USB port
+
+    // Samples per SAMPLES frame; a frame must fit the 64-byte UART TX buffer
+    constexpr uint8_t BATCH_SAMPLES = 2;
+    constexpr uint32_t HEALTH_PERIOD_MS = 10000;
+
+    // Samples are sent by exception (deadband.h); this bounds the silence
+    constexpr uint32_t HEARTBEAT_MS = 60000;
+    // A partial batch is sent once its first sample has waited this long
+    constexpr uint32_t BATCH_WAIT_MS = 5000;
+}
+
+// Serial command console (console.h)
+namespace console {
+    // Longest command line, terminator excluded; longer lines are rejected
+    constexpr uint8_t LINE_BYTES = 24;
+    // Longest reply line
+    constexpr uint8_t REPLY_BYTES = 32;
 }
 
 // UI configuration
 namespace ui {
     // Total number of LCD pages to cycle through
-    constexpr uint8_t LCD_PAGE_COUNT = 4; // (1) Temp/Moist, (2) pH/Cond, (3) NPK, (4) Status
+    constexpr uint8_t LCD_PAGE_COUNT = 5; // (1) Temp/Moist, (2) pH/Cond, (3) NPK, (4) Trend, (5) Status
+
+    // Trend page: channel index (see channels.h) and samples kept, one per LCD column
+    constexpr uint8_t TREND_CHANNEL = 0; // Moisture
+    constexpr uint8_t TREND_SAMPLES = 16;
 }
 
 namespace scheduler {
@@ -66,6 +163,18 @@ namespace scheduler {
     constexpr uint8_t TOTAL_TASKS_NUM = 3; // LED, Sensor, and LCD tasks
     constexpr uint8_t TOTAL_TASKS_RUNNING_NUM = TOTAL_TASKS_NUM + 1;
     constexpr uint8_t IDLE_TASK_RUNNING_INDICATOR = 255;
+
+    /**
+    * @brief Run the phase planner at start-up to spread task releases.
+    * @details When false, every task keeps the offset given in tasks[].
+    */
+    constexpr bool AUTO_PHASE_PLAN = true;
+
+    /**
+    * @brief Upper bound on the hyperperiod (in ticks) the phase planner accepts.
+    * @details Sizes the planner's on-stack load table, one byte per tick.
+    */
+    constexpr uint8_t PHASE_PLAN_MAX_TICKS = 64;
 }
 
 #endif // CONFIG_H
\ No newline at end of file
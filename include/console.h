@@ -0,0 +1,33 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @file console.h
+ * @brief Line-oriented command console on the USB serial port.
+ * @details console_poll() runs in the idle loop. It consumes whatever bytes
+ *          have arrived and, on CR or LF, looks the first word up in a
+ *          command table kept in flash. Replies are produced one line per
+ *          pass and only when the UART has room for it, so a long dump never
+ *          blocks the loop; input waits in the RX buffer meanwhile. With
+ *          ENABLE_TELEMETRY the replies travel as REPLY frames between the
+ *          binary telemetry, otherwise as text lines.
+ *
+ *          Numbers are decimal or 0x-prefixed hex. "help" lists the commands.
+ *          rd, wr and discover are handed to Task_SoilSensor, which owns the
+ *          RS485 link; their reply follows once the transaction completes.
+ *
+ * @code
+ * > rd 0x0006
+ * 0x6 = 652
+ * > period 1 5000
+ * sensor 5000 ms
+ * @endcode
+ */
+
+/// Idle loop: reads input, runs the current command, sends one reply line.
+void console_poll() noexcept;
+
+#endif // CONSOLE_H
@@ -0,0 +1,81 @@
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+/**
+ * @file coroutine.h
+ * @brief Stackless, protothread-style resumable tasks.
+ * @details A TickFunction already receives its previous state and returns the
+ *          next one. These macros turn that integer into a resume point: the
+ *          task body becomes a switch on the state, each yield returns the
+ *          current line number, and the next call jumps straight back to it.
+ *
+ *          While a task returns a non-zero state the scheduler resumes it on
+ *          every tick instead of waiting for its period; returning 0 (via
+ *          TASK_END) completes the sequence and the task sleeps until its
+ *          next release.
+ *
+ *          Rules of use:
+ *          - Locals do not survive a yield; keep cross-yield data static.
+ *          - Do not yield from inside another switch statement.
+ *          - At most one yield per source line.
+ *
+ * @code
+ * int Task_Example(int state) {
+ *     static uint8_t i;
+ *     TASK_BEGIN(state);
+ *     for (i = 0U; i < 4U; ++i) {
+ *         startSomething(i);
+ *         TASK_WAIT_UNTIL(state, somethingDone());
+ *     }
+ *     TASK_END(state);
+ * }
+ * @endcode
+ */
+
+// JSF AV C++ Rule 29 deviation: function-like macros are the only way to
+// place case labels at the yield site; each expands to a compound statement.
+
+/// Marks the resume label in TASK_WAIT_UNTIL as reached by falling through
+/// (-Wimplicit-fallthrough; a comment does not count inside a macro).
+#if defined(__GNUC__) && (__GNUC__ >= 7)
+#define TASK_FALLTHROUGH __attribute__((fallthrough))
+#else
+#define TASK_FALLTHROUGH ((void)0)
+#endif
+
+/// Opens the resumable body; must be the first statement of the task.
+#define TASK_BEGIN(state) switch (state) { case 0:
+
+/// Returns to the scheduler; execution continues here on the next tick.
+#define TASK_YIELD(state)                                   \
+    do {                                                    \
+        (state) = __LINE__;                                 \
+        return (state);                                     \
+        case __LINE__:;                                     \
+    } while (0)
+
+/// Yields on every tick until @p cond holds (checked immediately first).
+#define TASK_WAIT_UNTIL(state, cond)                        \
+    do {                                                    \
+        (state) = __LINE__;                                 \
+        TASK_FALLTHROUGH;                                   \
+        case __LINE__:                                      \
+        if (!(cond)) {                                      \
+            return (state);                                 \
+        }                                                   \
+    } while (0)
+
+/// Yields on every tick while @p cond holds.
+#define TASK_WAIT_WHILE(state, cond) TASK_WAIT_UNTIL(state, !(cond))
+
+/// Abandons the sequence; the next release starts again from TASK_BEGIN.
+#define TASK_RESTART(state)                                 \
+    do {                                                    \
+        (state) = 0;                                        \
+        return (state);                                     \
+    } while (0)
+
+/// Closes the resumable body and completes the sequence.
+#define TASK_END(state) } (state) = 0; return (state)
+
+#endif // COROUTINE_H
@@ -0,0 +1,84 @@
+#ifndef DEADBAND_H
+#define DEADBAND_H
+
+#include <stdint.h>
+#include "config.h"
+#include "channels.h"
+
+struct Sample;
+
+/**
+ * @file deadband.h
+ * @brief Report-by-exception: pass a sample on only when it says something new.
+ * @details Each downstream consumer (telemetry, EEPROM log) owns a Gate that
+ *          remembers the last sample it emitted. A new sample is due when
+ *          any channel has left its deadband around that value, a value
+ *          appeared or went missing, or the poll status changed, but never
+ *          sooner than the gate's minimum interval. A heartbeat forces a
+ *          sample after the maximum silence so consumers can tell a quiet
+ *          sensor from a dead link. Deadbands are shared by all gates.
+ */
+namespace deadband {
+
+enum class Mode : uint8_t {
+    ABSOLUTE,  ///< threshold in channel units
+    RELATIVE   ///< threshold in 1/1000 of the last emitted value
+};
+
+/**
+ * @brief Change a channel must exceed to be reported.
+ */
+struct Band {
+    Mode mode;
+    uint16_t threshold;  ///< 0: any change is reported.
+};
+
+/**
+ * @class Gate
+ * @brief Change detector for one consumer.
+ */
+class Gate {
+public:
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit Gate(uint32_t min_interval_ms, uint32_t heartbeat_ms) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Gate(const Gate&) = delete;
+    Gate& operator=(const Gate&) = delete;
+    ~Gate() = default;
+
+    /// True if @p sample should be emitted (nothing emitted yet counts as due).
+    bool due(const Sample& sample) const noexcept;
+
+    /// Records @p sample as emitted; call only once the consumer accepted it.
+    void mark(const Sample& sample) noexcept;
+
+    /// Samples offered to due() that were held back.
+    uint16_t suppressedCount() const noexcept { return suppressed; }
+
+    /// Convenience for consumers that never refuse: due() then mark().
+    bool pass(const Sample& sample) noexcept;
+
+private:
+    // JSF AV C++ Rule 23: All data members shall be private.
+    int16_t last[channels::COUNT];  ///< Channel values last emitted.
+    uint32_t lastMs;                ///< Timestamp of the last emitted sample.
+    uint32_t minIntervalMs;         ///< Changes closer than this wait.
+    uint32_t heartbeatMs;           ///< Longest silence.
+    bool lastOk;                    ///< Poll status last emitted.
+    bool primed;                    ///< Something was emitted.
+    mutable uint16_t suppressed;    ///< Held-back samples (wraps).
+};
+
+} // namespace deadband
+
+/**
+ * @brief Replaces the deadband of channel @p ch.
+ * @return false if @p ch is not a channel index.
+ */
+bool deadband_configure(uint8_t ch, const deadband::Band& band) noexcept;
+
+/// Deadband of channel @p ch (index clamped to the last channel).
+deadband::Band deadband_get(uint8_t ch) noexcept;
+
+#endif // DEADBAND_H
@@ -0,0 +1,143 @@
+#ifndef EELOG_H
+#define EELOG_H
+
+#include <stdint.h>
+#include "config.h"
+#include "channels.h"
+#include "SoilSensor.h"
+
+struct Sample;
+
+/**
+ * @file eelog.h
+ * @brief Persistent, wear-levelled sample log in the on-chip EEPROM.
+ * @details The log area is a ring of storage::LOG_PAGE_COUNT pages written
+ *          strictly in turn, so every cell is rewritten once per pass of the
+ *          ring. A page opens with a key record (absolute values) under a
+ *          header carrying a 16-bit sequence number; the records after it are
+ *          deltas from their predecessor, zig-zag varint encoded, each opened
+ *          by its length and closed by a CRC-8 seeded with the page's
+ *          sequence number.
+ *
+ *          Pages are never erased. Instead every record is followed by an
+ *          END_MARKER byte (unless the page is full), which no record can
+ *          start with, so replay stops exactly where this pass's data ends and
+ *          never decodes leftovers of an older pass. Each record is written
+ *          last byte first: the previous marker is only overwritten by the
+ *          record's length byte, once the rest of it and its own marker are in
+ *          place, so the page always reads as complete records. A reused page
+ *          is skipped by replay until its new header is complete. Boot recovery
+ *          only reads the page headers to find the newest sequence number;
+ *          logging after a reset starts on the next page because uptime
+ *          timestamps restart at zero.
+ *
+ *          Records are written by exception (deadband.h): when a channel
+ *          leaves its deadband, at most once per storage::LOG_PERIOD_MS, and
+ *          at least every storage::LOG_HEARTBEAT_MS.
+ *
+ *          EEPROM writes take ~3.4 ms per byte, so records are staged in RAM
+ *          and written one byte per eelog_pump() call from the idle loop.
+ */
+namespace eelog {
+
+/**
+ * @brief One logged sample: uptime in seconds and the channel values.
+ */
+struct Record {
+    uint32_t seconds;
+    int16_t values[channels::COUNT];  ///< channels:: units, GAP if missing.
+};
+
+/// Page header: sequence (2) + key record (4 + 2 per channel) + CRC (1).
+constexpr uint8_t HEADER_BYTES = 2U + 4U + (2U * channels::COUNT) + 1U;
+/// Longest delta record: length, 5-byte time delta, 3 bytes per channel, CRC.
+constexpr uint8_t MAX_DELTA_BYTES = 1U + 5U + (3U * channels::COUNT) + 1U;
+/// Shortest delta record: length, one byte per varint, CRC.
+constexpr uint8_t MIN_DELTA_BYTES = 1U + 1U + channels::COUNT + 1U;
+constexpr uint8_t MAX_STAGE_BYTES = (HEADER_BYTES > MAX_DELTA_BYTES) ? HEADER_BYTES : MAX_DELTA_BYTES;
+/// Written after the newest record of a page; never a valid length byte.
+constexpr uint8_t END_MARKER = 0xFFU;
+
+// JSF AV C++ Rule 10: constexpr instead of macros (C++11 single-return form).
+constexpr uint32_t zigzag(int32_t v) noexcept {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+constexpr int32_t unzigzag(uint32_t v) noexcept {
+    return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1UL);
+}
+
+/**
+ * @brief Writes @p v as a little-endian base-128 varint.
+ * @return Bytes written (1..5); @p out must have room for 5.
+ */
+uint8_t putVarint(uint8_t* out, uint32_t v) noexcept;
+
+/**
+ * @brief Reads a varint from the first @p len bytes of @p in.
+ * @return Bytes consumed, or 0 if truncated or longer than 5 bytes.
+ */
+uint8_t getVarint(const uint8_t* in, uint8_t len, uint32_t& v) noexcept;
+
+/**
+ * @brief Encodes a page header holding @p key.
+ * @return HEADER_BYTES.
+ */
+uint8_t encodeHeader(uint8_t* out, uint16_t seq, const Record& key) noexcept;
+
+/**
+ * @brief Decodes a page header.
+ * @return false if the CRC fails or the page was never written.
+ */
+bool decodeHeader(const uint8_t* in, uint16_t& seq, Record& key) noexcept;
+
+/**
+ * @brief Encodes @p cur as a delta from @p prev, CRC seeded with @p seq.
+ * @return Bytes written (at most MAX_DELTA_BYTES).
+ */
+uint8_t encodeDelta(uint8_t* out, uint16_t seq, const Record& prev, const Record& cur) noexcept;
+
+/**
+ * @brief Decodes a delta record from the first @p len bytes of @p in.
+ * @return Bytes consumed, or 0 at END_MARKER, or if the record is truncated,
+ *         its length byte disagrees with its contents or the CRC fails.
+ */
+uint8_t decodeDelta(const uint8_t* in, uint8_t len, uint16_t seq, const Record& prev, Record& cur) noexcept;
+
+/// Called for each logged record by eelog_replay(), oldest first.
+using Visitor = void (*)(const Record& record, void* context);
+
+} // namespace eelog
+
+/**
+ * @brief Boot recovery: locates the newest page so logging resumes after it.
+ */
+void eelog_init() noexcept;
+
+/**
+ * @brief Logs @p sample if its deadband gate says it is due.
+ * @details Called from the idle loop for every sample; the record is only
+ *          staged here and reaches the EEPROM through eelog_pump().
+ * @return true if a record was staged.
+ */
+bool eelog_offer(const Sample& sample) noexcept;
+
+/**
+ * @brief Writes the next staged byte if the EEPROM is idle.
+ * @return true if a byte was written.
+ */
+bool eelog_pump() noexcept;
+
+/**
+ * @brief Decodes the whole log, oldest page first, calling @p visit per record.
+ * @return Number of records visited.
+ */
+uint16_t eelog_replay(eelog::Visitor visit, void* context) noexcept;
+
+/// Records skipped because the previous one was still being written.
+uint16_t eelog_dropped() noexcept;
+
+/// Samples held back by the deadband gate.
+uint16_t eelog_suppressed() noexcept;
+
+#endif // EELOG_H
@@ -0,0 +1,85 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <stdint.h>
+#include "SoilSensor.h"
+
+/**
+ * @file filter.h
+ * @brief Per-channel streaming filters in integer arithmetic.
+ * @details Each channel runs a fixed chain: an optional 3- or 5-tap median
+ *          (spike rejection) followed by an optional exponential moving
+ *          average or scalar Kalman stage (smoothing). Every update is O(1)
+ *          and the state per channel is a constant few bytes. Missing
+ *          readings (channels::GAP) pass through without touching state.
+ */
+namespace filter {
+
+enum class Smoothing : uint8_t {
+    NONE,   ///< Median output only.
+    EMA,    ///< y += (x - y) / 2^emaShift.
+    KALMAN  ///< Scalar random-walk Kalman filter.
+};
+
+/**
+ * @brief Filter chain settings of one channel.
+ */
+struct Config {
+    uint8_t medianTaps;   ///< 1 (off), 3 or 5.
+    Smoothing smoothing;  ///< Second stage.
+    uint8_t emaShift;     ///< EMA weight 2^-emaShift (1-7).
+    uint16_t kalmanQ;     ///< Process noise variance per sample, channel units^2.
+    uint16_t kalmanR;     ///< Measurement noise variance, channel units^2.
+};
+
+constexpr uint8_t MEDIAN_MAX_TAPS = 5U;
+
+/**
+ * @class Chain
+ * @brief State of one channel's filter chain.
+ */
+class Chain {
+public:
+    Chain() noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Chain(const Chain&) = delete;
+    Chain& operator=(const Chain&) = delete;
+    ~Chain() = default;
+
+    /**
+     * @brief Feeds one raw sample and returns the filtered value.
+     * @return channels::GAP if @p raw is GAP (state unchanged).
+     */
+    int16_t update(int16_t raw, const Config& cfg) noexcept;
+
+    /// Forgets all history; the next sample primes the chain.
+    void reset() noexcept;
+
+private:
+    // JSF AV C++ Rule 23: All data members shall be private.
+    int16_t window[MEDIAN_MAX_TAPS]; ///< Last raw samples (ring).
+    uint8_t next;                    ///< Ring slot for the next sample.
+    uint8_t filled;                  ///< Valid entries in window.
+    int32_t estimate;                ///< Smoothed value, Q4 fixed point.
+    uint32_t variance;               ///< Kalman error variance, channel units^2, Q8 fixed point.
+    bool primed;                     ///< estimate holds a value.
+
+    int16_t median(uint8_t taps) const noexcept;
+};
+
+} // namespace filter
+
+/**
+ * @brief Filters every channel of @p data in place.
+ * @details Called by the sensor task once per poll (single context).
+ */
+void filter_apply(SoilSensor::SensorData& data) noexcept;
+
+/**
+ * @brief Replaces the configuration of channel @p ch and resets its state.
+ * @return false if @p ch or the configuration is invalid.
+ */
+bool filter_configure(uint8_t ch, const filter::Config& cfg) noexcept;
+
+#endif // FILTER_H
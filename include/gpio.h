@@ -0,0 +1,156 @@
+#ifndef GPIO_H
+#define GPIO_H
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+/**
+ * @file gpio.h
+ * @brief Compile-time pin access for the Arduino Uno (ATmega328P).
+ * @details digitalWrite()/digitalRead() look the pin up in flash tables and
+ *          check for PWM on every call (~50 cycles). Here the Arduino pin
+ *          number is a template argument, so port, bit and mask are resolved
+ *          by the compiler: set/clear on a constant register become single
+ *          sbi/cbi instructions and toggle a single write to PINx.
+ *
+ *          Uno mapping: D0-D7 -> PORTD0-7, D8-D13 -> PORTB0-5, A0-A5 (14-19) -> PORTC0-5.
+ */
+namespace gpio {
+
+enum class Port : uint8_t { B, C, D };
+
+// JSF AV C++ Rule 10: constexpr instead of macros (C++11 single-return form).
+constexpr Port portOf(uint8_t pin) noexcept {
+    return (pin < 8U) ? Port::D : ((pin < 14U) ? Port::B : Port::C);
+}
+
+constexpr uint8_t bitOf(uint8_t pin) noexcept {
+    return (pin < 8U) ? pin : static_cast<uint8_t>((pin < 14U) ? (pin - 8U) : (pin - 14U));
+}
+
+/**
+ * @brief PORTx/DDRx/PINx of one port.
+ * @details JSF AV C++ Rule 70 deviation: hardware registers are volatile by
+ *          definition (avr/io.h); nothing else in this header is.
+ */
+template <Port P> struct Registers;
+
+template <> struct Registers<Port::B> {
+    static volatile uint8_t& port() noexcept { return PORTB; }
+    static volatile uint8_t& ddr() noexcept { return DDRB; }
+    static volatile uint8_t& pin() noexcept { return PINB; }
+};
+
+template <> struct Registers<Port::C> {
+    static volatile uint8_t& port() noexcept { return PORTC; }
+    static volatile uint8_t& ddr() noexcept { return DDRC; }
+    static volatile uint8_t& pin() noexcept { return PINC; }
+};
+
+template <> struct Registers<Port::D> {
+    static volatile uint8_t& port() noexcept { return PORTD; }
+    static volatile uint8_t& ddr() noexcept { return DDRD; }
+    static volatile uint8_t& pin() noexcept { return PIND; }
+};
+
+/**
+ * @class Pin
+ * @brief One digital pin, resolved at compile time.
+ * @tparam N Arduino Uno pin number (0-19).
+ */
+template <uint8_t N>
+struct Pin {
+    static_assert(N < 20U, "gpio::Pin: not an Arduino Uno digital pin");
+
+    static constexpr Port PORT = portOf(N);
+    static constexpr uint8_t MASK = static_cast<uint8_t>(1U << bitOf(N));
+    using Regs = Registers<PORT>;
+
+    // Single-bit read-modify-writes on I/O registers compile to sbi/cbi,
+    // which are atomic, so no interrupt guard is needed.
+    static void output() noexcept { Regs::ddr() |= MASK; }
+    static void input() noexcept { Regs::ddr() &= static_cast<uint8_t>(~MASK); }
+    static void set() noexcept { Regs::port() |= MASK; }
+    static void clear() noexcept { Regs::port() &= static_cast<uint8_t>(~MASK); }
+    static void toggle() noexcept { Regs::pin() = MASK; }  // Writing 1 to PINx toggles PORTx
+    static bool read() noexcept { return (Regs::pin() & MASK) != 0U; }
+
+    static void write(bool level) noexcept {
+        if (level) {
+            set();
+        } else {
+            clear();
+        }
+    }
+};
+
+/**
+ * @brief Pin-to-bit mapping of a Bus, peeled one pin at a time.
+ */
+template <uint8_t... PINS> struct BusMap;
+
+template <> struct BusMap<> {
+    static constexpr uint8_t mask(Port) noexcept { return 0U; }
+    static uint8_t spread(Port, uint8_t) noexcept { return 0U; }
+};
+
+template <uint8_t FIRST, uint8_t... REST>
+struct BusMap<FIRST, REST...> {
+    static_assert(FIRST < 20U, "gpio::Bus: not an Arduino Uno digital pin");
+
+    /// Bits of @p port driven by the bus.
+    static constexpr uint8_t mask(Port port) noexcept {
+        return static_cast<uint8_t>(((portOf(FIRST) == port) ? (1U << bitOf(FIRST)) : 0U) |
+                                    BusMap<REST...>::mask(port));
+    }
+
+    /// Moves bit 0 of @p value to FIRST's position (if on @p port), bit 1 to the next pin, ...
+    static uint8_t spread(Port port, uint8_t value) noexcept {
+        return static_cast<uint8_t>((((portOf(FIRST) == port) && ((value & 1U) != 0U)) ? (1U << bitOf(FIRST)) : 0U) |
+                                    BusMap<REST...>::spread(port, static_cast<uint8_t>(value >> 1)));
+    }
+};
+
+/**
+ * @class Bus
+ * @brief Several pins written together from the low bits of one value.
+ * @details Bit i of the value drives PINS[i]. Pins sharing a port are
+ *          updated by a single masked write, so a bus that fits one port
+ *          changes all its lines on the same clock edge.
+ * @tparam PINS Arduino Uno pin numbers, least significant bit first.
+ */
+template <uint8_t... PINS>
+struct Bus {
+    using Map = BusMap<PINS...>;
+
+    static void output() noexcept {
+        Registers<Port::B>::ddr() |= Map::mask(Port::B);
+        Registers<Port::C>::ddr() |= Map::mask(Port::C);
+        Registers<Port::D>::ddr() |= Map::mask(Port::D);
+    }
+
+    static void write(uint8_t value) noexcept {
+        // Multi-bit read-modify-write: guard against ISRs touching the same port.
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            writePort<Port::B>(value);
+            writePort<Port::C>(value);
+            writePort<Port::D>(value);
+        }
+    }
+
+private:
+    template <Port P>
+    static void writePort(uint8_t value) noexcept {
+        if (Map::mask(P) != 0U) {
+            volatile uint8_t& reg = Registers<P>::port();
+            reg = static_cast<uint8_t>((reg & static_cast<uint8_t>(~Map::mask(P))) | Map::spread(P, value));
+        } else {
+            // Bus has no pin on this port: folded away
+        }
+    }
+};
+
+} // namespace gpio
+
+#endif // GPIO_H
@@ -0,0 +1,256 @@
+#ifndef LOCKFREE_H
+#define LOCKFREE_H
+
+#include <stdint.h>
+
+/**
+ * @file lockfree.h
+ * @brief Interrupt-safe data exchange between tasks without disabling interrupts.
+ * @details Tasks run nested inside the Timer1 ISR, so a consumer can be
+ *          preempted by its producer (and vice versa) at any instruction.
+ *          Both primitives below only rely on single-byte loads and stores
+ *          being atomic on AVR; the __atomic builtins provide the ordering
+ *          (compiler barriers on a single core) instead of volatile.
+ */
+namespace lockfree {
+
+/**
+ * @class SpscRing
+ * @brief Fixed-capacity single-producer/single-consumer FIFO.
+ * @details Head and tail are free-running 8-bit counters, so the capacity
+ *          must be a power of two no larger than 128. Exactly one context may
+ *          push and exactly one (other) context may pop.
+ * @tparam T Element type; copied by value.
+ * @tparam N Capacity in elements.
+ */
+template <typename T, uint8_t N>
+class SpscRing {
+    static_assert((N >= 2U) && (N <= 128U) && ((N & (N - 1U)) == 0U),
+                  "SpscRing capacity must be a power of two in [2, 128]");
+public:
+    SpscRing() noexcept : slots(), head(0U), tail(0U), dropped(0U) {}
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    ~SpscRing() = default;
+
+    /**
+     * @brief Producer side: appends a copy of @p item.
+     * @return false (and counts a drop) if the ring is full.
+     */
+    bool push(const T& item) noexcept {
+        const uint8_t h = head;
+        const uint8_t t = __atomic_load_n(&tail, __ATOMIC_ACQUIRE);
+        if (static_cast<uint8_t>(h - t) >= N) {
+            ++dropped;
+            return false;
+        }
+        slots[h & (N - 1U)] = item;
+        __atomic_store_n(&head, static_cast<uint8_t>(h + 1U), __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side: removes the oldest element into @p out.
+     * @return false if the ring is empty.
+     */
+    bool pop(T& out) noexcept {
+        const uint8_t t = tail;
+        const uint8_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+        if (h == t) {
+            return false;
+        }
+        out = slots[t & (N - 1U)];
+        __atomic_store_n(&tail, static_cast<uint8_t>(t + 1U), __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side: pointer to the oldest element without removing it.
+     * @return nullptr if the ring is empty.
+     */
+    const T* peek() const noexcept {
+        const uint8_t t = tail;
+        const uint8_t h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+        return (h == t) ? nullptr : &slots[t & (N - 1U)];
+    }
+
+    /// Consumer side: discards the element returned by peek().
+    void discard() noexcept {
+        const uint8_t t = tail;
+        if (__atomic_load_n(&head, __ATOMIC_ACQUIRE) != t) {
+            __atomic_store_n(&tail, static_cast<uint8_t>(t + 1U), __ATOMIC_RELEASE);
+        }
+    }
+
+    uint8_t size() const noexcept {
+        return static_cast<uint8_t>(__atomic_load_n(&head, __ATOMIC_ACQUIRE) -
+                                    __atomic_load_n(&tail, __ATOMIC_ACQUIRE));
+    }
+    bool empty() const noexcept { return size() == 0U; }
+    static constexpr uint8_t capacity() noexcept { return N; }
+
+    /// Pushes rejected because the ring was full (producer-owned, wraps).
+    uint16_t droppedCount() const noexcept { return dropped; }
+
+private:
+    // JSF AV C++ Rule 23: All data members shall be private.
+    T slots[N];       ///< Element storage.
+    uint8_t head;     ///< Next slot to write; written by the producer only.
+    uint8_t tail;     ///< Next slot to read; written by the consumer only.
+    uint16_t dropped; ///< Full-ring rejections; written by the producer only.
+};
+
+/**
+ * @class SeqLockBuffer
+ * @brief Latest-value publisher: one writer, any number of readers.
+ * @details Double-buffered seqlock. The writer fills the inactive slot while
+ *          its sequence is odd, then flips the active index, so a reader that
+ *          preempts the writer always finds a complete, stable slot. A reader
+ *          preempted by the writer detects the change through the sequence
+ *          and retries; retries are bounded so a reader never spins.
+ * @tparam T Value type; copied by value.
+ */
+template <typename T>
+class SeqLockBuffer {
+public:
+    SeqLockBuffer() noexcept : slots(), active(0U), generation(0U) {}
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    SeqLockBuffer(const SeqLockBuffer&) = delete;
+    SeqLockBuffer& operator=(const SeqLockBuffer&) = delete;
+    ~SeqLockBuffer() = default;
+
+    /// Writer side: publishes a new value.
+    void publish(const T& value) noexcept {
+        const uint8_t next = static_cast<uint8_t>(active ^ 1U);
+        Slot& s = slots[next];
+        const uint8_t seq = s.seq;
+        __atomic_store_n(&s.seq, static_cast<uint8_t>(seq + 1U), __ATOMIC_RELAXED);
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        s.value = value;
+        __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        __atomic_store_n(&s.seq, static_cast<uint8_t>(seq + 2U), __ATOMIC_RELEASE);
+        __atomic_store_n(&active, next, __ATOMIC_RELEASE);
+        const uint8_t gen = static_cast<uint8_t>(generation + 1U);
+        __atomic_store_n(&generation, (gen != 0U) ? gen : static_cast<uint8_t>(1U), __ATOMIC_RELEASE);
+    }
+
+    /**
+     * @brief Reader side: copies the latest published value into @p out.
+     * @return false if no consistent copy was obtained within MAX_READ_ATTEMPTS
+     *         (@p out may then hold a torn value and should be discarded).
+     */
+    bool read(T& out) const noexcept {
+        for (uint8_t attempt = 0U; attempt < MAX_READ_ATTEMPTS; ++attempt) {
+            const Slot& s = slots[__atomic_load_n(&active, __ATOMIC_ACQUIRE)];
+            const uint8_t before = __atomic_load_n(&s.seq, __ATOMIC_ACQUIRE);
+            if ((before & 1U) != 0U) {
+                continue;
+            }
+            __atomic_signal_fence(__ATOMIC_SEQ_CST);
+            out = s.value;
+            __atomic_signal_fence(__ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&s.seq, __ATOMIC_ACQUIRE) == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Publish counter (wraps from 255 to 1).
+     * @details Readers compare it with a remembered value to detect new data
+     *          without copying; 0 means nothing has been published yet.
+     */
+    uint8_t getGeneration() const noexcept {
+        return __atomic_load_n(&generation, __ATOMIC_ACQUIRE);
+    }
+
+    static constexpr uint8_t MAX_READ_ATTEMPTS = 4U;
+
+private:
+    struct Slot {
+        T value;     ///< Published value.
+        uint8_t seq; ///< Odd while the writer is updating value.
+    };
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    Slot slots[2];      ///< Active slot and writer scratch slot.
+    uint8_t active;     ///< Index of the slot readers should use.
+    uint8_t generation; ///< Number of publishes (wraps).
+};
+
+template <typename T>
+constexpr uint8_t SeqLockBuffer<T>::MAX_READ_ATTEMPTS;
+
+/**
+ * @class Mailbox
+ * @brief One request/response slot between a client and a server context.
+ * @details The slot cycles FREE -> QUEUED (client post) -> RUNNING (server
+ *          take) -> DONE (server complete) -> FREE (client collect). Each
+ *          side only writes the value while it owns the slot, and ownership
+ *          moves with a single-byte release store.
+ * @tparam T Job type, carrying both the request and its result.
+ */
+template <typename T>
+class Mailbox {
+public:
+    Mailbox() noexcept : job(), stage(FREE) {}
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+    ~Mailbox() = default;
+
+    /// Client side: submits @p request. @return false if a job is still open.
+    bool post(const T& request) noexcept {
+        if (__atomic_load_n(&stage, __ATOMIC_ACQUIRE) != FREE) {
+            return false;
+        }
+        job = request;
+        __atomic_store_n(&stage, QUEUED, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /// Server side: copies a queued request into @p out and marks it running.
+    bool take(T& out) noexcept {
+        if (__atomic_load_n(&stage, __ATOMIC_ACQUIRE) != QUEUED) {
+            return false;
+        }
+        out = job;
+        __atomic_store_n(&stage, RUNNING, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /// Server side: publishes the result of the running job.
+    void complete(const T& result) noexcept {
+        job = result;
+        __atomic_store_n(&stage, DONE, __ATOMIC_RELEASE);
+    }
+
+    /// Client side: copies a finished job into @p out and frees the slot.
+    bool collect(T& out) noexcept {
+        if (__atomic_load_n(&stage, __ATOMIC_ACQUIRE) != DONE) {
+            return false;
+        }
+        out = job;
+        __atomic_store_n(&stage, FREE, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    static constexpr uint8_t FREE = 0U;
+    static constexpr uint8_t QUEUED = 1U;
+    static constexpr uint8_t RUNNING = 2U;
+    static constexpr uint8_t DONE = 3U;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    T job;         ///< Request, then result; owned by whoever holds the stage.
+    uint8_t stage; ///< FREE, QUEUED, RUNNING or DONE.
+};
+
+} // namespace lockfree
+
+#endif // LOCKFREE_H
@@ -0,0 +1,60 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @file logger.h
+ * @brief Deferred, non-blocking logging safe to call from tasks.
+ * @details A log call only copies the level, a PROGMEM format string, two
+ *          integer arguments and a timestamp into a fixed ring (a few dozen
+ *          cycles with interrupts off); formatting and output happen later
+ *          in logger_drain() on the idle loop. When the ring is full the
+ *          message is dropped and counted instead of waiting, so logging from
+ *          a task running in the Timer1 ISR never adds UART latency.
+ *
+ *          Formats understand %d (signed), %u (unsigned), %x (hex) and %%;
+ *          each conversion consumes the next argument.
+ *
+ * @code
+ * logger_write(logger::Level::WARN, PSTR("Sensor block %u failed: %x"), block, result);
+ * @endcode
+ */
+namespace logger {
+
+enum class Level : uint8_t { ERROR = 0, WARN = 1, INFO = 2, DEBUG = 3 };
+
+/// Longest formatted message; longer ones are truncated.
+constexpr uint8_t MAX_TEXT = 40U;
+
+} // namespace logger
+
+/**
+ * @brief Queues one message (callable from any context).
+ * @param format_P PROGMEM format string; must outlive the drain (use PSTR()).
+ */
+void logger_enqueue(logger::Level level, const char* format_P, int32_t a, int32_t b) noexcept;
+
+/**
+ * @brief Queues a message if @p level passes logging::MAX_LEVEL.
+ * @details Inline so calls above the compile-time level fold away.
+ */
+inline void logger_write(logger::Level level, const char* format_P, int32_t a = 0L, int32_t b = 0L) noexcept {
+    if (static_cast<uint8_t>(level) <= logging::MAX_LEVEL) {
+        logger_enqueue(level, format_P, a, b);
+    }
+}
+
+/**
+ * @brief Idle loop: formats and outputs queued messages while the UART has room.
+ * @details With ENABLE_TELEMETRY messages travel as LOG frames, otherwise
+ *          as "[W 12345] text" lines. A message that does not fit the TX
+ *          buffer stays queued for the next pass.
+ */
+void logger_drain() noexcept;
+
+/// Messages dropped because the ring was full.
+uint16_t logger_dropped() noexcept;
+
+#endif // LOGGER_H
@@ -0,0 +1,55 @@
+#ifndef PAGES_H
+#define PAGES_H
+
+#include <stdint.h>
+#include "config.h"
+
+class LCD;
+struct Sample;
+
+namespace pages {
+
+/**
+ * @brief What a layout field shows.
+ */
+enum class Kind : uint8_t {
+    TEXT,           ///< Static PROGMEM text.
+    READING,        ///< Sensor channel as a right-aligned fixed-point number, then a PROGMEM unit.
+    BAUD,           ///< Serial baud rate.
+    STATUS,         ///< "OK"/"ERR" for the last poll.
+    TREND_SUMMARY,  ///< Tracked channel: label, latest value and change.
+    TREND_BARS      ///< Tracked channel: one CGRAM bar per sample.
+};
+
+/**
+ * @brief One field of a page layout.
+ * @details Layouts are arrays of these in PROGMEM; the renderer walks them,
+ *          so a new page is a table entry rather than new code.
+ */
+struct Field {
+    Kind kind;
+    uint8_t col;       ///< First column (0-15).
+    uint8_t row;       ///< Row (0-1).
+    uint8_t width;     ///< Cells for the value (TEXT: whole text).
+    uint8_t channel;   ///< channels:: index (READING).
+    uint8_t decimals;  ///< Fixed-point scale of the value (READING).
+    const char* text;  ///< PROGMEM label (TEXT) or unit suffix (READING), may be nullptr.
+};
+
+/**
+ * @brief One page: a PROGMEM field array and its length.
+ */
+struct Page {
+    const Field* fields;
+    uint8_t count;
+};
+
+} // namespace pages
+
+/**
+ * @brief Draws page @p index (modulo ui::LCD_PAGE_COUNT) into @p lcd's shadow buffer.
+ * @details The caller clears the buffer first and renders afterwards.
+ */
+void pages_draw(uint8_t index, LCD& lcd, const Sample& sample) noexcept;
+
+#endif // PAGES_H
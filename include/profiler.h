@@ -0,0 +1,36 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include "config.h"
+
+class Print;
+
+namespace profiler {
+
+/**
+ * @brief Snapshot of the scheduler tick statistics.
+ * @details loadHistogram[n] counts ticks that released exactly n tasks; the
+ *          last bin also absorbs anything larger. Durations are measured with
+ *          the Timer1 timebase and include time spent in nested interrupts.
+ */
+struct TickStats {
+    uint32_t ticks;                                           ///< Ticks observed.
+    uint32_t loadHistogram[scheduler::TOTAL_TASKS_NUM + 1U];  ///< Ticks per release count.
+    uint32_t totalTickUs;                                     ///< Sum of tick durations (wraps).
+    uint32_t maxTickUs;                                       ///< Longest tick seen.
+    uint32_t overruns;                                        ///< Ticks that started inside another tick.
+};
+
+} // namespace profiler
+
+// C-style hooks called from the scheduler tick (ISR context)
+uint32_t profiler_tick_begin() noexcept;
+void profiler_tick_end(uint32_t start_us, uint8_t released) noexcept;
+
+// Idle-loop helpers
+void profiler_snapshot(profiler::TickStats& out) noexcept;
+void profiler_reset() noexcept;
+void profiler_report(Print& out) noexcept;
+
+#endif // PROFILER_H
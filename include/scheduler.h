@@ -4,13 +4,16 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "config.h"
+#include "timerwheel.h"
 
 namespace scheduler {
 
 /**
  * @brief Function pointer type for a task's tick function.
  * @param state The current state of the task's state machine.
- * @return The next state of the task's state machine.
+ * @return The next state of the task's state machine. A non-zero state
+ *         requests resumption on the next tick (see coroutine.h); return 0
+ *         to wait for the next periodic release.
  */
 using TickFunction = int (*)(int);
 
@@ -24,7 +27,9 @@ using TickFunction = int (*)(int);
 class Task {
 public:
     // JSF AV C++ Rule 39: All constructors shall be declared explicit.
-    explicit Task(uint32_t period, TickFunction tick_fct) noexcept;
+    // The release offset (ms) shifts every release of the task to
+    // k * period + offset, so tasks sharing a hyperperiod need not co-fire.
+    explicit Task(uint32_t period, TickFunction tick_fct, uint32_t offset = 0U) noexcept;
 
     // JSF AV C++ Rule 30: A class that has a destructor shall also have a copy constructor and an assignment operator.
     // Default copy constructor, assignment operator, and destructor are sufficient here.
@@ -39,7 +44,23 @@ public:
     int getState() const noexcept { return state; }
     void setState(int new_state) noexcept { state = new_state; }
 
+    bool isEnabled() const noexcept { return enabled; }
+    void setEnabled(bool is_enabled) noexcept { enabled = is_enabled; }
+
     uint32_t getPeriod() const noexcept { return period; }
+    /**
+     * @brief Changes the period and restarts the task's phase from now.
+     * @details The offset is reduced modulo the new period; the next release
+     *          is that offset from now, or one full period if it is zero.
+     */
+    void setPeriod(uint32_t new_period) noexcept;
+    uint32_t getOffset() const noexcept { return offset; }
+    /**
+     * @brief Sets the release offset and re-phases the task accordingly.
+     * @details The offset is reduced modulo the period. Must not be called
+     *          while the scheduler tick can run (e.g. before sei()).
+     */
+    void setOffset(uint32_t new_offset) noexcept;
     uint32_t getElapsedTime() const noexcept { return elapsedTime; }
     void resetElapsedTime() noexcept { elapsedTime = 0; }
     void incrementElapsedTime(uint32_t time) noexcept { elapsedTime += time; }
@@ -49,8 +70,10 @@ public:
 private:
     // JSF AV C++ Rule 23: All data members shall be private.
     bool running;           ///< True if the task is currently executing.
+    bool enabled;           ///< False while the task is suspended.
     int state;              ///< The current state of the task's state machine.
-    const uint32_t period;  ///< The rate at which the task should tick, in milliseconds.
+    uint32_t period;        ///< The rate at which the task should tick, in milliseconds.
+    uint32_t offset;        ///< Release offset within the period, in milliseconds.
     uint32_t elapsedTime;   ///< Time elapsed since the task's last tick.
     TickFunction tickFct;   ///< Pointer to the function to call for this task's tick.
 };
@@ -81,6 +104,45 @@ public:
      */
     void tick() noexcept;
 
+    // Runtime task control. Indices refer to the array given at construction;
+    // all calls are safe from tasks, callbacks and the idle loop.
+
+    /**
+     * @brief Stops releasing a task. A sequence in progress (non-zero state)
+     *        is frozen and continues after resumeTask().
+     * @return false if the index is out of range.
+     */
+    bool suspendTask(uint8_t index) noexcept;
+
+    /**
+     * @brief Re-enables a suspended task. Its phase kept running while
+     *        suspended, so an overdue task is released on the next tick.
+     * @return false if the index is out of range.
+     */
+    bool resumeTask(uint8_t index) noexcept;
+
+    /**
+     * @brief Changes a task's period with a phase reset (see Task::setPeriod).
+     * @return false if the index is out of range or the period is zero or
+     *         not a multiple of TASK_TICKS_GCD_IN_MS.
+     */
+    bool setTaskPeriod(uint8_t index, uint32_t period_ms) noexcept;
+
+    /**
+     * @brief Posts a one-shot deferred callback @p delay_ms from now.
+     * @details The delay is rounded up to whole ticks (minimum one). The
+     *          callback runs from the tick, before the tasks, with interrupts
+     *          enabled. O(1) regardless of the number of pending events.
+     * @return false if the event is already pending.
+     */
+    bool post(TimerEvent& event, uint32_t delay_ms) noexcept;
+
+    /**
+     * @brief Cancels a pending one-shot callback.
+     * @return true if the event was pending.
+     */
+    bool cancel(TimerEvent& event) noexcept;
+
 private:
     // JSF AV C++ Rule 23: All data members shall be private.
     Task* const g_tasks;         ///< Pointer to the array of tasks.
@@ -90,12 +152,32 @@ private:
     // Instead, atomicity is handled by the caller (e.g., in the ISR).
     uint8_t runningTasks[scheduler::TOTAL_TASKS_RUNNING_NUM]; ///< Array to track running task indices.
     uint8_t currentTask;                           ///< Index of the currently executing task.
+    TimerWheel timers;                             ///< Pending one-shot callbacks.
 };
 
+/**
+ * @brief Spreads task release offsets across the hyperperiod.
+ * @details Greedy planner: tasks are placed in order of increasing period,
+ *          each at the offset (a multiple of the tick) that minimises the peak
+ *          number of releases sharing a tick, ties broken by the lowest total
+ *          overlap and then the earliest offset. Call before the scheduler
+ *          starts ticking.
+ * @param tasks The task array to re-phase in place.
+ * @param num_tasks Number of tasks in the array.
+ * @return The resulting peak releases per tick, or 0 if the hyperperiod
+ *         exceeds PHASE_PLAN_MAX_TICKS (offsets are left unchanged).
+ */
+uint8_t planPhases(Task* tasks, uint8_t num_tasks) noexcept;
+
 } // namespace scheduler
 
 // C-style wrapper functions for compatibility with existing C code (e.g., ISRs)
 void scheduler_init(scheduler::Task* tasks, uint8_t tasks_num) noexcept;
 void scheduler_tick() noexcept;
+bool scheduler_task_suspend(uint8_t index) noexcept;
+bool scheduler_task_resume(uint8_t index) noexcept;
+bool scheduler_task_set_period(uint8_t index, uint32_t period_ms) noexcept;
+bool scheduler_post(scheduler::TimerEvent& event, uint32_t delay_ms) noexcept;
+bool scheduler_cancel(scheduler::TimerEvent& event) noexcept;
 
 #endif // SCHEDULER_H
\ No newline at end of file
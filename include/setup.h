@@ -13,9 +13,20 @@ extern SoftwareSerial mySerial;
 extern ModbusMaster node;
 extern SoilSensor gSensor;
 extern LCD gLcd;
+// Direct-port LCD access installed by setupHardware() (gpio.h)
+extern const LCD::PinHooks gLcdPinHooks;
 
 // Setup APIs
 void setupHardware();
 void setupScheduler();
 
+/**
+ * @brief Starts mySerial at @p baud and records it as the sensor bus rate.
+ * @details The one place the bus rate changes (setup, discovery), so that
+ *          sensorBusBaud() always tells what the link is running at.
+ */
+void sensorBusBegin(uint16_t baud) noexcept;
+/// Current sensor bus rate (safe from any context).
+uint16_t sensorBusBaud() noexcept;
+
 #endif // SETUP_H
@@ -5,15 +5,59 @@
 #include "scheduler.h"
 #include "config.h"
 #include "SoilSensor.h"
+#include "lockfree.h"
 
 // Expose task functions
 int Task_ToggleLED(int state);
 int Task_SoilSensor(int state);
 int Task_LcdUpdate(int state);
 
-// Expose shared sensor data and status flag
-extern SoilSensor::SensorData gSensorData;
-extern bool gLastReadOk;
+/**
+ * @brief One completed sensor poll, as handed from producer to consumers.
+ */
+struct Sample {
+    uint32_t timestampMs;         ///< timebase_millis() when the poll completed.
+    bool ok;                      ///< True if every register block was read.
+    SoilSensor::SensorData data;  ///< Decoded values (error values where a block failed).
+};
+
+/**
+ * @brief One on-demand sensor bus operation and its outcome.
+ * @details Task_SoilSensor owns the RS485 link, so other contexts post a
+ *          job to gBusJobs; the task runs it before its next poll and
+ *          completes it in place.
+ */
+struct BusJob {
+    enum class Op : uint8_t {
+        READ,     ///< Read holding register reg into value.
+        WRITE,    ///< Write value to holding register reg.
+        DISCOVER  ///< Scan sensor_bus::DISCOVERY_* for a responding slave.
+    };
+    Op op;
+    uint16_t reg;
+    uint16_t value;
+    uint8_t status;   ///< Result: Modbus status (ku8MBSuccess on success).
+    uint8_t address;  ///< Result: slave address in use afterwards.
+    uint16_t baud;    ///< Result: bus baud rate in use afterwards.
+};
+
+// Idle-loop consumers (run outside the scheduler ISR)
+void Idle_DrainSamples();
+
+// Bus jobs from the idle loop (console) to the sensor task
+extern lockfree::Mailbox<BusJob> gBusJobs;
+
+// Latest sample for readers that only need the current value (LCD)
+extern lockfree::SeqLockBuffer<Sample> gLatestSample;
+// Every sample, in order, for the idle-loop consumer
+extern lockfree::SpscRing<Sample, buffers::SAMPLE_QUEUE_DEPTH> gSampleQueue;
+
+// Indices into tasks[] for the runtime control API (scheduler_task_*)
+namespace task_id {
+    constexpr uint8_t LED = 0;
+    constexpr uint8_t SENSOR = 1;
+    constexpr uint8_t LCD = 2;
+}
 
 // Expose tasks array to scheduler
 extern scheduler::Task tasks[scheduler::TOTAL_TASKS_NUM];
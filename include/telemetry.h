@@ -0,0 +1,58 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include "config.h"
+#include "telemetry_protocol.h"
+
+struct Sample;
+
+namespace profiler {
+struct TickStats;
+}
+
+/**
+ * @file telemetry.h
+ * @brief Binary telemetry on the USB serial port (see telemetry_protocol.h).
+ * @details All calls belong to the idle loop. Samples are batched
+ *          telemetry::BATCH_SAMPLES to a frame; a frame is only sent when the
+ *          UART TX buffer has room for all of it, otherwise it is dropped and
+ *          counted, so telemetry never blocks the loop. A sample costs 19
+ *          bytes on the wire against ~90 for the equivalent text line.
+ */
+
+/**
+ * @brief Adds @p sample to the current batch if its deadband gate lets it
+ *        through, and sends the batch when full.
+ * @details Unchanged samples are held back until telemetry::HEARTBEAT_MS;
+ *          failed polls and recoveries always pass.
+ */
+void telemetry_sample(const Sample& sample) noexcept;
+
+/// Sends a partial sample batch, if any.
+void telemetry_flush() noexcept;
+
+/**
+ * @brief Sends a HEALTH frame every telemetry::HEALTH_PERIOD_MS and any
+ *        sample batch older than telemetry::BATCH_WAIT_MS.
+ * @param now_ms Current timebase_millis().
+ */
+void telemetry_poll(uint32_t now_ms) noexcept;
+
+/// Sends one PROFILER frame with @p stats.
+void telemetry_profiler(const profiler::TickStats& stats) noexcept;
+
+/**
+ * @brief Sends one LOG frame (used by logger_drain()).
+ * @return false, without consuming a sequence number, if the TX buffer has
+ *         no room yet; the caller keeps the message and retries.
+ */
+bool telemetry_log(uint8_t level, uint32_t timestamp_ms, const char* text, uint8_t length) noexcept;
+
+/**
+ * @brief Sends one REPLY frame (used by console_poll()).
+ * @return false if the TX buffer has no room yet; retry later.
+ */
+bool telemetry_reply(const char* text, uint8_t length) noexcept;
+
+#endif // TELEMETRY_H
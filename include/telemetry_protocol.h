@@ -0,0 +1,76 @@
+#ifndef TELEMETRY_PROTOCOL_H
+#define TELEMETRY_PROTOCOL_H
+
+#include <stdint.h>
+
+/**
+ * @file telemetry_protocol.h
+ * @brief Wire format of the binary telemetry stream (firmware and host tools).
+ * @details Every frame is COBS-encoded (lib/cobs) and followed by a 0x00
+ *          delimiter. Decoded, a frame is
+ *
+ *              type (1) | sequence (1) | body | CRC-16/CCITT-FALSE (2)
+ *
+ *          with the CRC over type..body. All multi-byte fields are little
+ *          endian. The sequence increments per frame sent, so a receiver can
+ *          count frames lost to overruns or line noise.
+ *
+ *          SAMPLES body: count (1), then per sample timestamp ms (4),
+ *          status (1, STATUS_OK bit) and CHANNELS int16 values in channels.h
+ *          order and units, -32768 for a missing value.
+ *
+ *          HEALTH body: uptime ms (4), then the HealthCounter fields (2 each).
+ *
+ *          PROFILER body: ticks (4), total tick us (4), max tick us (4),
+ *          overruns (4), bin count (1), bins (4 each; releases per tick).
+ *
+ *          LOG body: level (1; 0 error .. 3 debug), timestamp ms (4), then
+ *          the message text without terminator.
+ *
+ *          REPLY body: one line of console output (console.h), without
+ *          terminator. The host sends commands as plain text lines.
+ *
+ *          This header has no dependencies so host tools can include it.
+ */
+namespace telemetry {
+
+enum class FrameType : uint8_t {
+    SAMPLES = 0x01,
+    HEALTH = 0x02,
+    PROFILER = 0x03,
+    LOG = 0x04,
+    REPLY = 0x05
+};
+
+constexpr uint8_t HEADER_BYTES = 2U;   ///< type + sequence
+constexpr uint8_t CRC_BYTES = 2U;
+constexpr uint8_t CHANNELS = 7U;       ///< Values per sample (channels::COUNT)
+constexpr uint8_t SAMPLE_BYTES = 4U + 1U + (2U * CHANNELS);
+constexpr uint8_t STATUS_OK = 0x01U;   ///< Every register block was read.
+
+/**
+ * @brief Health counters, in wire order.
+ */
+enum HealthCounter : uint8_t {
+    SENSOR_FAILURES = 0,   ///< Polls with at least one failed block.
+    QUEUE_DROPS,           ///< Samples dropped by the sensor-to-idle queue.
+    LCD_DROPS,             ///< LCD commands dropped by a full queue.
+    LOG_DROPS,             ///< EEPROM log records skipped while busy.
+    FRAME_DROPS,           ///< Telemetry frames dropped for lack of TX room.
+    MESSAGE_DROPS,         ///< Log messages dropped by a full logger ring.
+    SAMPLES_SUPPRESSED,    ///< Samples held back by the deadband gate.
+    HEALTH_COUNTER_COUNT
+};
+
+constexpr uint8_t HEALTH_BODY_BYTES = 4U + (2U * HEALTH_COUNTER_COUNT);
+
+constexpr uint8_t LOG_HEADER_BYTES = 1U + 4U;  ///< level + timestamp
+
+/// Size of a SAMPLES frame carrying @p count samples, before COBS.
+constexpr uint16_t samplesFrameBytes(uint8_t count) noexcept {
+    return static_cast<uint16_t>(HEADER_BYTES + 1U + (static_cast<uint16_t>(SAMPLE_BYTES) * count) + CRC_BYTES);
+}
+
+} // namespace telemetry
+
+#endif // TELEMETRY_PROTOCOL_H
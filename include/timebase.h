@@ -0,0 +1,37 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Configures Timer1 as the system timebase and the scheduler tick source.
+ * @details Timer1 free-runs in normal mode. The overflow interrupt extends the
+ *          16-bit counter into a 32-bit microsecond clock, and compare match A
+ *          is advanced by one period per interrupt to dispatch the scheduler tick.
+ *          The smallest prescaler whose compare step fits 16 bits is selected,
+ *          which gives the finest clock resolution for the requested period.
+ * @param period_us The scheduler tick period in microseconds.
+ * @return true if Timer1 was (re)configured, false if the period cannot be
+ *         represented at any prescaler (Timer1 is left untouched).
+ */
+bool timebase_init(uint32_t period_us) noexcept;
+
+/**
+ * @brief Returns the monotonic microsecond clock.
+ * @details Safe to call from tasks and ISRs. Wraps every 2^32 us (~71.6 min);
+ *          use unsigned subtraction to compute intervals.
+ */
+uint32_t timebase_micros() noexcept;
+
+/**
+ * @brief Returns the monotonic millisecond clock derived from the same counter.
+ * @details Wraps every 2^32 ms (~49.7 days). Intended for sample timestamps.
+ */
+uint32_t timebase_millis() noexcept;
+
+/**
+ * @brief Returns the clock resolution selected by timebase_init(), in nanoseconds.
+ */
+uint16_t timebase_resolution_ns() noexcept;
+
+#endif // TIMEBASE_H
@@ -1,8 +0,0 @@
-#ifndef TIMER_H
-#define TIMER_H
-
-#include <stdint.h>
-
-void timer1_set_period_ms(uint16_t period_ms) noexcept;
-
-#endif // TIMER_H
\ No newline at end of file
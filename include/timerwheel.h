@@ -0,0 +1,122 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace scheduler {
+
+/**
+ * @brief Callback type for one-shot timer events.
+ * @param arg The user pointer given when the event was constructed.
+ */
+using TimerCallback = void (*)(void*);
+
+/**
+ * @class TimerEvent
+ * @brief A caller-owned, intrusive one-shot timeout.
+ * @details Events are linked directly into the wheel's slot lists, so posting
+ *          and cancelling need no allocation and cost O(1) regardless of how
+ *          many events are pending. An event may re-post itself from its own
+ *          callback to become periodic.
+ */
+class TimerEvent {
+public:
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit TimerEvent(TimerCallback callback, void* arg = nullptr) noexcept
+        : next(nullptr), pprev(nullptr), expiry(0U), callback(callback), arg(arg), pending(false) {}
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment
+    // (a copy would alias the intrusive links).
+    TimerEvent(const TimerEvent&) = delete;
+    TimerEvent& operator=(const TimerEvent&) = delete;
+    ~TimerEvent() = default;
+
+    bool isPending() const noexcept { return pending; }
+
+private:
+    friend class TimerWheel;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    TimerEvent* next;       ///< Next event in the same slot (or expired list).
+    TimerEvent** pprev;     ///< The link pointing at this event (slot head or prev->next).
+    uint32_t expiry;        ///< Absolute wheel tick at which the event fires.
+    TimerCallback callback; ///< Function to run on expiry.
+    void* arg;              ///< User pointer passed to the callback.
+    bool pending;           ///< True while linked into the wheel or an expired list.
+};
+
+/**
+ * @class TimerWheel
+ * @brief Three-level hierarchical timing wheel (16 slots per level).
+ * @details Level 0 resolves single ticks up to 16 ahead, level 1 blocks of
+ *          16 ticks up to 256 ahead and level 2 blocks of 256 ticks up to
+ *          4096 ahead; longer timeouts park in the furthest level-2 slot and
+ *          are re-filed when it cascades. Insert and cancel are O(1); each
+ *          advance touches one level-0 slot plus, every 16th tick, one
+ *          cascaded slot. Not interrupt-safe by itself: the scheduler calls
+ *          it with interrupts disabled.
+ */
+class TimerWheel {
+public:
+    TimerWheel() noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    ~TimerWheel() = default;
+
+    /**
+     * @brief Schedules @p event to fire @p delay_ticks ticks from now (min 1).
+     * @return false if the event is already pending (it is left unchanged).
+     */
+    bool schedule(TimerEvent& event, uint32_t delay_ticks) noexcept;
+
+    /**
+     * @brief Removes @p event from the wheel if pending.
+     * @return true if the event was pending.
+     */
+    bool cancel(TimerEvent& event) noexcept;
+
+    /**
+     * @brief Advances the wheel by one tick.
+     * @details Moves the events due this tick onto @p expired (which must be
+     *          empty and stay in scope until it is drained with pop()). They
+     *          stay pending there, so cancel() removes them and schedule()
+     *          refuses them until their own callback is about to run.
+     */
+    void advance(TimerEvent*& expired) noexcept;
+
+    /**
+     * @brief Unlinks the first event of @p expired and marks it not pending.
+     * @return The event to fire(), or nullptr once the list is empty.
+     */
+    TimerEvent* pop(TimerEvent*& expired) noexcept;
+
+    /**
+     * @brief Runs the callback of an event returned by pop().
+     * @details May be called with interrupts enabled; the callback may re-post
+     *          its own event and post or cancel others, including those still
+     *          waiting on the same expired list.
+     */
+    static void fire(TimerEvent& event) noexcept;
+
+    uint32_t now() const noexcept { return current; }
+
+    static constexpr uint8_t LEVELS = 3U;
+    static constexpr uint8_t SLOT_BITS = 4U;
+    static constexpr uint8_t SLOTS = 1U << SLOT_BITS;
+
+private:
+    // JSF AV C++ Rule 23: All data members shall be private.
+    TimerEvent* slots[LEVELS][SLOTS]; ///< Heads of the per-slot event lists.
+    uint32_t current;                 ///< Current wheel tick.
+
+    void insert(TimerEvent& event) noexcept;
+    void unlink(TimerEvent& event) noexcept;
+    void cascade(uint8_t level, uint8_t slot) noexcept;
+};
+
+} // namespace scheduler
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,30 @@
+#ifndef TREND_H
+#define TREND_H
+
+#include <stdint.h>
+#include "config.h"
+#include "SoilSensor.h"
+
+/**
+ * @brief Producer side: appends the tracked channel of @p data.
+ * @details Called once per completed poll; interrupt-safe with respect to
+ *          trend_snapshot() running in a preempted task.
+ */
+void trend_record(const SoilSensor::SensorData& data) noexcept;
+
+/**
+ * @brief Copies the history, oldest first (channels::GAP for failed reads).
+ * @return Number of valid entries in @p out (0..ui::TREND_SAMPLES).
+ */
+uint8_t trend_snapshot(int16_t (&out)[ui::TREND_SAMPLES]) noexcept;
+
+/// Channel being tracked (channels:: index).
+uint8_t trend_channel() noexcept;
+
+/**
+ * @brief Switches the tracked channel and clears the history.
+ * @return false if @p ch is not a valid channel index.
+ */
+bool trend_set_channel(uint8_t ch) noexcept;
+
+#endif // TREND_H
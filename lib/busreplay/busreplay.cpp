@@ -0,0 +1,136 @@
+#include "busreplay.h"
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace busreplay {
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+/// Longest line: "rx" and a 20-digit time plus MAX_FRAME bytes of " hh".
+constexpr size_t LINE_BYTES = 32U + (3U * MAX_FRAME) + 2U;
+
+const char* skipSpace(const char* p) noexcept {
+    while ((*p == ' ') || (*p == '\t')) {
+        ++p;
+    }
+    return p;
+}
+
+bool atEnd(const char* p) noexcept {
+    p = skipSpace(p);
+    return (*p == '\0') || (*p == '\n') || (*p == '\r') || (*p == '#');
+}
+
+int hexDigit(char c) noexcept {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    return ((c >= 'a') && (c <= 'f')) ? (c - 'a' + 10) : -1;
+}
+
+bool fail(char* error, size_t errorSize, uint32_t line, const char* what) noexcept {
+    if ((error != nullptr) && (errorSize != 0U)) {
+        (void)snprintf(error, errorSize, "line %lu: %s", static_cast<unsigned long>(line), what);
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+bool parse(FILE* in, Trace& trace, char* error, size_t errorSize) noexcept {
+    trace.frames.clear();
+    char text[LINE_BYTES];
+    uint32_t line = 0UL;
+    uint32_t baud = 0UL;
+    uint64_t previousEndUs = 0ULL;
+    while (fgets(text, sizeof(text), in) != nullptr) {
+        ++line;
+        if ((strchr(text, '\n') == nullptr) && !feof(in)) {
+            return fail(error, errorSize, line, "line too long");
+        }
+        const char* p = skipSpace(text);
+        if (atEnd(p)) {
+            continue;
+        }
+        char* end = nullptr;
+        if (strncmp(p, "baud", 4U) == 0) {
+            const unsigned long value = strtoul(p + 4, &end, 10);
+            if ((end == (p + 4)) || (value == 0UL) || !atEnd(end)) {
+                return fail(error, errorSize, line, "expected: baud <rate>");
+            }
+            baud = static_cast<uint32_t>(value);
+            continue;
+        }
+
+        Frame frame;
+        if ((strncmp(p, "tx", 2U) == 0) || (strncmp(p, "rx", 2U) == 0)) {
+            frame.dir = (*p == 't') ? Frame::Dir::TX : Frame::Dir::RX;
+        } else {
+            return fail(error, errorSize, line, "expected baud, tx or rx");
+        }
+        if (baud == 0UL) {
+            return fail(error, errorSize, line, "frame before the first baud line");
+        }
+        p = skipSpace(p + 2);
+        const bool relative = (*p == '+');
+        const char* digits = relative ? (p + 1) : p;
+        const unsigned long long time = strtoull(digits, &end, 10);
+        if ((end == digits) || ((*end != ' ') && (*end != '\t'))) {
+            return fail(error, errorSize, line, "expected a time in us or +us");
+        }
+        frame.baud = baud;
+        frame.startUs = relative ? (previousEndUs + time) : time;
+        frame.line = line;
+        p = end;
+        while (!atEnd(p)) {
+            p = skipSpace(p);
+            const int high = hexDigit(p[0]);
+            const int low = (high >= 0) ? hexDigit(p[1]) : -1;
+            if ((low < 0) || ((p[2] != ' ') && (p[2] != '\t') && !atEnd(p + 2))) {
+                return fail(error, errorSize, line, "bytes are two hex digits each");
+            }
+            if (frame.bytes.size() == MAX_FRAME) {
+                return fail(error, errorSize, line, "frame longer than 256 bytes");
+            }
+            frame.bytes.push_back(static_cast<uint8_t>((high << 4) | low));
+            p += 2;
+        }
+        if (frame.bytes.empty()) {
+            return fail(error, errorSize, line, "frame without bytes");
+        }
+        previousEndUs = endUs(frame);
+        trace.frames.push_back(frame);
+    }
+    return true;
+}
+
+bool load(const char* path, Trace& trace, char* error, size_t errorSize) noexcept {
+    FILE* in = fopen(path, "r");
+    if (in == nullptr) {
+        if ((error != nullptr) && (errorSize != 0U)) {
+            (void)snprintf(error, errorSize, "cannot open %s", path);
+        }
+        return false;
+    }
+    const bool ok = parse(in, trace, error, errorSize);
+    (void)fclose(in);
+    return ok;
+}
+
+void writeFrame(FILE* out, Frame::Dir dir, uint64_t startUs, const uint8_t* bytes, size_t n) noexcept {
+    (void)fprintf(out, "%s %" PRIu64, (dir == Frame::Dir::TX) ? "tx" : "rx", startUs);
+    for (size_t i = 0U; i < n; ++i) {
+        (void)fprintf(out, " %02X", bytes[i]);
+    }
+    (void)fputc('\n', out);
+}
+
+void writeBaud(FILE* out, uint32_t baud) noexcept {
+    (void)fprintf(out, "baud %lu\n", static_cast<unsigned long>(baud));
+}
+
+} // namespace busreplay
@@ -0,0 +1,77 @@
+#ifndef BUSREPLAY_H
+#define BUSREPLAY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+/**
+ * @file busreplay.h
+ * @brief Timed byte traces of a Modbus RTU link, as text.
+ * @details A trace is the master's side of a session: what it sent (tx) and
+ *          what it received (rx), frame by frame, with the time each frame's
+ *          first start bit went on the wire. One frame per line:
+ *
+ * @code
+ * # comment
+ * baud 9600
+ * tx 0 01 03 00 06 00 01 64 0B
+ * rx 10333 01 03 02 02 BC B8 95
+ * tx +2000000 01 03 00 12 00 02 64 0E
+ * @endcode
+ *
+ *          Times are microseconds from the start of the capture; "+N" means N
+ *          microseconds after the end of the previous frame, which keeps
+ *          hand-written scenarios readable. Bytes are two hex digits and go
+ *          back to back at the current baud rate; a gap inside a reply is
+ *          written as two rx lines. "baud" applies to the frames after it.
+ *
+ *          busreplay_recorder.h writes traces from a live Stream (the Linux
+ *          gateway's --trace), busreplay_hal.h plays them back into a
+ *          native_hal serial port. Plain C++ with no Arduino dependency.
+ */
+namespace busreplay {
+
+/// Longest frame a line may carry (one Modbus RTU ADU).
+constexpr uint16_t MAX_FRAME = 256U;
+
+struct Frame {
+    enum class Dir : uint8_t { TX, RX };
+    Dir dir;
+    uint32_t baud;               ///< Line rate in force for this frame.
+    uint64_t startUs;            ///< First start bit, capture time.
+    uint32_t line;               ///< Source line, for messages.
+    std::vector<uint8_t> bytes;
+};
+
+struct Trace {
+    std::vector<Frame> frames;
+};
+
+/// Wire time of @p bytes characters (8N1) at @p baud, in microseconds.
+inline uint64_t wireUs(size_t bytes, uint32_t baud) noexcept {
+    return (baud == 0UL) ? 0ULL : ((static_cast<uint64_t>(bytes) * 10000000ULL) / baud);
+}
+
+/// End of @p frame's last stop bit, capture time.
+inline uint64_t endUs(const Frame& frame) noexcept {
+    return frame.startUs + wireUs(frame.bytes.size(), frame.baud);
+}
+
+/**
+ * @brief Reads a trace.
+ * @param[out] error Message for the first bad line, with its number.
+ * @return false on a syntax error or a frame before any "baud" line.
+ */
+bool parse(FILE* in, Trace& trace, char* error, size_t errorSize) noexcept;
+
+/// parse() of the file at @p path.
+bool load(const char* path, Trace& trace, char* error, size_t errorSize) noexcept;
+
+/// Writes one frame line in the format parse() reads.
+void writeFrame(FILE* out, Frame::Dir dir, uint64_t startUs, const uint8_t* bytes, size_t n) noexcept;
+void writeBaud(FILE* out, uint32_t baud) noexcept;
+
+} // namespace busreplay
+
+#endif // BUSREPLAY_H
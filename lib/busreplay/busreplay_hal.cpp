@@ -0,0 +1,71 @@
+#include "busreplay_hal.h"
+
+namespace busreplay {
+
+Player::Player(const Trace& trace) noexcept : script(trace), next(0U), matched(0U), counters(), reason() {}
+
+void Player::start(hal::FakeStream& port) noexcept {
+    next = 0U;
+    matched = 0U;
+    counters = PlayerStats();
+    reason[0] = '\0';
+    // Leading input is anchored to capture time 0.
+    scheduleReplies(port, hal::cycles(), 0ULL);
+}
+
+void Player::scheduleReplies(hal::FakeStream& port, uint64_t anchor_cycle, uint64_t anchor_us) noexcept {
+    const uint64_t character = port.byteCycles();
+    uint64_t at = anchor_cycle;
+    while ((next < script.frames.size()) && (script.frames[next].dir == Frame::Dir::RX)) {
+        const Frame& frame = script.frames[next];
+        // A recorder's estimate may put a reply start before the request end.
+        const uint64_t offset = (frame.startUs > anchor_us) ? (frame.startUs - anchor_us) : 0ULL;
+        const uint64_t start = anchor_cycle + (offset * hal::CYCLES_PER_US);
+        at = (start > at) ? start : at;
+        for (uint8_t value : frame.bytes) {
+            at += character;
+            port.injectByte(at, value);
+        }
+        ++counters.replies;
+        ++next;
+    }
+}
+
+void Player::diverge(const Frame& frame, const char* what, uint8_t value) noexcept {
+    (void)snprintf(reason, sizeof(reason), "line %lu byte %lu: %s (sent %02X)",
+                   static_cast<unsigned long>(frame.line), static_cast<unsigned long>(matched), what, value);
+}
+
+void Player::onTransmit(hal::FakeStream& port, uint8_t value, uint64_t end_cycle) {
+    if (diverged()) {
+        return;
+    }
+    if (finished()) {
+        ++counters.extra;
+        return;
+    }
+    // start() and every matched request consume the rx frames that follow.
+    const Frame& frame = script.frames[next];
+    if (port.baud() != frame.baud) {
+        char what[48];
+        (void)snprintf(what, sizeof(what), "port at %lu baud, trace at %lu", static_cast<unsigned long>(port.baud()),
+                       static_cast<unsigned long>(frame.baud));
+        diverge(frame, what, value);
+        return;
+    }
+    if (frame.bytes[matched] != value) {
+        char what[32];
+        (void)snprintf(what, sizeof(what), "expected %02X", frame.bytes[matched]);
+        diverge(frame, what, value);
+        return;
+    }
+    if (++matched < frame.bytes.size()) {
+        return;
+    }
+    matched = 0U;
+    ++counters.requests;
+    ++next;
+    scheduleReplies(port, end_cycle, endUs(frame));
+}
+
+} // namespace busreplay
@@ -0,0 +1,70 @@
+#ifndef BUSREPLAY_HAL_H
+#define BUSREPLAY_HAL_H
+
+#include "native_hal.h"
+#include "busreplay.h"
+
+/**
+ * @file busreplay_hal.h
+ * @brief Plays a trace into a native_hal serial port as the far end of the link.
+ * @details The Player stands in for the slaves: attach it with
+ *          port.setPeer(&player) and call start(). Every byte the firmware
+ *          transmits must match the next tx frame of the trace, bit for bit
+ *          and at the trace's baud rate. Once a tx frame is complete, the rx
+ *          frames recorded after it are scheduled into the port, each at the
+ *          same offset from the end of the request as in the capture. Replies
+ *          therefore follow the firmware's own timing, not the capture's, and
+ *          a slow reply, a timeout or a torn frame reaches ModbusMaster just
+ *          as it did in the field. rx frames before the first tx are
+ *          scheduled at their capture time from start().
+ *
+ *          The first byte that differs from the trace ends the replay: the
+ *          Player stops answering and records where the firmware went its own
+ *          way. Bytes sent after the last frame are only counted.
+ */
+namespace busreplay {
+
+struct PlayerStats {
+    uint32_t requests;   ///< tx frames matched.
+    uint32_t replies;    ///< rx frames scheduled.
+    uint32_t extra;      ///< Bytes transmitted after the end of the trace.
+};
+
+class Player : public hal::SerialPeer {
+public:
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit Player(const Trace& trace) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Player(const Player&) = delete;
+    Player& operator=(const Player&) = delete;
+    ~Player() override = default;
+
+    /// Rewinds to the first frame and schedules leading rx frames from now.
+    void start(hal::FakeStream& port) noexcept;
+
+    void onTransmit(hal::FakeStream& port, uint8_t value, uint64_t end_cycle) override;
+
+    /// True once every frame has been played.
+    bool finished() const noexcept { return next == script.frames.size(); }
+    bool diverged() const noexcept { return reason[0] != '\0'; }
+    /// What differed and where (empty if nothing did).
+    const char* divergence() const noexcept { return reason; }
+    const PlayerStats& stats() const noexcept { return counters; }
+
+private:
+    /// Schedules rx frames from next on, relative to a matched request.
+    void scheduleReplies(hal::FakeStream& port, uint64_t anchor_cycle, uint64_t anchor_us) noexcept;
+    void diverge(const Frame& frame, const char* what, uint8_t value) noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    const Trace& script;   ///< Frames to play.
+    size_t next;           ///< Frame the link is at.
+    size_t matched;        ///< Bytes of frame next already transmitted.
+    PlayerStats counters;
+    char reason[128];      ///< Divergence message.
+};
+
+} // namespace busreplay
+
+#endif // BUSREPLAY_HAL_H
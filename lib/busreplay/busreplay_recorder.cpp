@@ -0,0 +1,81 @@
+#include "busreplay_recorder.h"
+#include "native_hal.h"
+
+namespace busreplay {
+
+Recorder::Recorder(Stream& port, uint32_t baud, FILE* out) noexcept
+    : inner(port), sink(out), originUs(hal::micros64()), rate(baud), tx(), txLength(0U), rx(), rxLength(0U),
+      rxStartUs(0ULL), rxLastUs(0ULL) {
+    writeBaud(sink, rate);
+}
+
+Recorder::~Recorder() {
+    sync();
+    if (txLength != 0U) {
+        writeFrame(sink, Frame::Dir::TX, nowUs(), tx, txLength);
+    }
+    (void)fflush(sink);
+}
+
+uint64_t Recorder::nowUs() const noexcept {
+    return hal::micros64() - originUs;
+}
+
+void Recorder::setBaud(uint32_t baud) noexcept {
+    sync();
+    if (baud != rate) {
+        rate = baud;
+        writeBaud(sink, rate);
+    }
+}
+
+void Recorder::sync() noexcept {
+    if (rxLength != 0U) {
+        writeFrame(sink, Frame::Dir::RX, rxStartUs, rx, rxLength);
+        rxLength = 0U;
+    }
+}
+
+size_t Recorder::write(uint8_t value) {
+    sync();
+    if (txLength < MAX_FRAME) {
+        tx[txLength++] = value;
+    }
+    return inner.write(value);
+}
+
+void Recorder::flush() {
+    inner.flush();
+    if (txLength != 0U) {
+        const uint64_t now = nowUs();
+        const uint64_t wire = wireUs(txLength, rate);
+        writeFrame(sink, Frame::Dir::TX, (now > wire) ? (now - wire) : 0ULL, tx, txLength);
+        txLength = 0U;
+        (void)fflush(sink);
+    }
+}
+
+int Recorder::read() {
+    const int value = inner.read();
+    if (value < 0) {
+        return value;
+    }
+    const uint64_t now = nowUs();
+    // Modbus RTU frames end at 3.5 characters of silence.
+    if ((rxLength != 0U) && ((now - rxLastUs) > ((wireUs(7U, rate) + 1U) / 2U))) {
+        sync();
+    }
+    if (rxLength == 0U) {
+        // This byte and everything queued behind it have already arrived.
+        const int queued = inner.available();
+        const uint64_t wire = wireUs(1U + static_cast<size_t>((queued > 0) ? queued : 0), rate);
+        rxStartUs = (now > wire) ? (now - wire) : 0ULL;
+    }
+    if (rxLength < MAX_FRAME) {
+        rx[rxLength++] = static_cast<uint8_t>(value);
+    }
+    rxLastUs = now;
+    return value;
+}
+
+} // namespace busreplay
@@ -0,0 +1,64 @@
+#ifndef BUSREPLAY_RECORDER_H
+#define BUSREPLAY_RECORDER_H
+
+#include <Arduino.h>
+#include "busreplay.h"
+
+/**
+ * @file busreplay_recorder.h
+ * @brief Stream wrapper that writes a trace of everything passing through it.
+ * @details Put it between ModbusMaster and the port (node.begin(id, recorder)).
+ *          A request is written when flush() returns, timed back from that
+ *          moment by its wire time; received bytes are grouped into one rx
+ *          frame until the next request or a silence of 3.5 characters, and
+ *          timed from the read of the first one, less the bytes still waiting
+ *          behind it. Times come from micros64() and are only as good as the
+ *          host's view of the port: on a Linux gateway, within the driver's
+ *          latency, which replay absorbs because it anchors replies to the
+ *          request end.
+ */
+namespace busreplay {
+
+class Recorder : public Stream {
+public:
+    /// Traces @p port at @p baud into @p out (left open).
+    Recorder(Stream& port, uint32_t baud, FILE* out) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+    ~Recorder() override;
+
+    /// Records a change of line rate (the caller changes the port itself).
+    void setBaud(uint32_t baud) noexcept;
+    /// Writes out pending received bytes.
+    void sync() noexcept;
+
+    using Print::write;
+    size_t write(uint8_t value) override;
+    int availableForWrite() override { return inner.availableForWrite(); }
+    void flush() override;
+
+    int available() override { return inner.available(); }
+    int read() override;
+    int peek() override { return inner.peek(); }
+
+private:
+    uint64_t nowUs() const noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    Stream& inner;                 ///< Traced port.
+    FILE* sink;                    ///< Trace output.
+    uint64_t originUs;             ///< micros64() at capture time 0.
+    uint32_t rate;                 ///< Current line rate.
+    uint8_t tx[MAX_FRAME];         ///< Request being written.
+    uint16_t txLength;
+    uint8_t rx[MAX_FRAME];         ///< Input since the last request or silence.
+    uint16_t rxLength;
+    uint64_t rxStartUs;            ///< Estimated first start bit of rx.
+    uint64_t rxLastUs;             ///< Read of the latest rx byte.
+};
+
+} // namespace busreplay
+
+#endif // BUSREPLAY_RECORDER_H
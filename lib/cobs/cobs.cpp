@@ -0,0 +1,89 @@
+#include "cobs.h"
+
+namespace cobs {
+
+uint16_t encode(const uint8_t* in, uint16_t len, ByteSink sink, void* context) noexcept {
+    uint16_t emitted = 0U;
+    uint16_t start = 0U;
+    // Each block: a code byte (1 + data bytes up to the next zero), then the
+    // data bytes; a code of 0xFF marks a full block with no implied zero.
+    while (true) {
+        uint16_t end = start;
+        while ((end < len) && (in[end] != 0U) && (static_cast<uint16_t>(end - start) < 254U)) {
+            ++end;
+        }
+        const uint8_t code = static_cast<uint8_t>((end - start) + 1U);
+        sink(code, context);
+        ++emitted;
+        for (uint16_t i = start; i < end; ++i) {
+            sink(in[i], context);
+            ++emitted;
+        }
+        if (end >= len) {
+            break;
+        }
+        // Skip the zero the code implies; a full block implies none.
+        start = (code == 0xFFU) ? end : static_cast<uint16_t>(end + 1U);
+        if ((code == 0xFFU) && (start >= len)) {
+            break;
+        }
+    }
+    return emitted;
+}
+
+uint16_t crc16(uint16_t crc, const uint8_t* data, uint16_t len) noexcept {
+    for (uint16_t i = 0U; i < len; ++i) {
+        crc = static_cast<uint16_t>(crc ^ (static_cast<uint16_t>(data[i]) << 8));
+        for (uint8_t bit = 0U; bit < 8U; ++bit) {
+            crc = static_cast<uint16_t>(((crc & 0x8000U) != 0U) ? ((crc << 1) ^ 0x1021U) : (crc << 1));
+        }
+    }
+    return crc;
+}
+
+Decoder::Decoder(uint8_t* buffer, uint16_t capacity) noexcept
+    : out(buffer), capacity(capacity), pos(0U), frameLength(0U),
+      remaining(0U), pendingZero(false), discarding(false) {}
+
+Decoder::Status Decoder::feed(uint8_t byte) noexcept {
+    if (byte == DELIMITER) {
+        const bool complete = !discarding && (remaining == 0U) && ((pos != 0U) || pendingZero);
+        const bool empty = !discarding && (pos == 0U) && !pendingZero && (remaining == 0U);
+        frameLength = pos;
+        pos = 0U;
+        remaining = 0U;
+        pendingZero = false;
+        discarding = false;
+        if (empty) {
+            return Status::PENDING;  // Back-to-back delimiters
+        }
+        return complete ? Status::FRAME : Status::ERROR;
+    }
+    if (discarding) {
+        return Status::PENDING;
+    }
+
+    if (remaining == 0U) {
+        // Code byte: first emit the zero implied by the previous block.
+        if (pendingZero) {
+            if (pos >= capacity) {
+                discarding = true;
+                return Status::PENDING;
+            }
+            out[pos++] = 0U;
+        }
+        remaining = static_cast<uint8_t>(byte - 1U);
+        pendingZero = (byte != 0xFFU);
+        return Status::PENDING;
+    }
+
+    if (pos >= capacity) {
+        discarding = true;
+        return Status::PENDING;
+    }
+    out[pos++] = byte;
+    --remaining;
+    return Status::PENDING;
+}
+
+} // namespace cobs
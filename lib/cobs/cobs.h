@@ -0,0 +1,82 @@
+#ifndef COBS_H
+#define COBS_H
+
+#include <stdint.h>
+
+/**
+ * @file cobs.h
+ * @brief Consistent Overhead Byte Stuffing and a frame checksum.
+ * @details COBS removes every 0x00 from a frame at a cost of one byte per
+ *          254, so 0x00 can delimit frames on a raw byte stream: a receiver
+ *          that joins mid-stream or loses bytes resynchronises at the next
+ *          delimiter. The encoder streams into a sink and needs no output
+ *          buffer; the decoder is fed one received byte at a time.
+ *
+ *          Both sides are plain C++ with no Arduino dependency, so host tools
+ *          share this library with the firmware.
+ */
+namespace cobs {
+
+/// Frame delimiter on the wire.
+constexpr uint8_t DELIMITER = 0x00U;
+
+/// Worst-case encoded size of @p len bytes, excluding the delimiter.
+constexpr uint16_t encodedSize(uint16_t len) noexcept {
+    return static_cast<uint16_t>(len + (len / 254U) + 1U);
+}
+
+/// Receives encoded bytes from encode().
+using ByteSink = void (*)(uint8_t byte, void* context);
+
+/**
+ * @brief Streams the COBS encoding of @p in (without delimiter) into @p sink.
+ * @return Bytes emitted.
+ */
+uint16_t encode(const uint8_t* in, uint16_t len, ByteSink sink, void* context) noexcept;
+
+/**
+ * @brief CRC-16/CCITT-FALSE update (polynomial 0x1021, start with CRC_INIT).
+ */
+uint16_t crc16(uint16_t crc, const uint8_t* data, uint16_t len) noexcept;
+constexpr uint16_t CRC_INIT = 0xFFFFU;
+
+/**
+ * @class Decoder
+ * @brief Incremental decoder writing frames into a caller buffer.
+ */
+class Decoder {
+public:
+    enum class Status : uint8_t {
+        PENDING,   ///< Byte consumed; frame not complete yet.
+        FRAME,     ///< Delimiter seen; length() bytes of frame are in the buffer.
+        ERROR      ///< Malformed or oversized frame dropped; resyncing.
+    };
+
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit Decoder(uint8_t* buffer, uint16_t capacity) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Decoder(const Decoder&) = delete;
+    Decoder& operator=(const Decoder&) = delete;
+    ~Decoder() = default;
+
+    /// Consumes one received byte.
+    Status feed(uint8_t byte) noexcept;
+
+    /// Length of the frame reported by the last FRAME status.
+    uint16_t length() const noexcept { return frameLength; }
+
+private:
+    // JSF AV C++ Rule 23: All data members shall be private.
+    uint8_t* out;          ///< Decoded frame storage.
+    uint16_t capacity;     ///< Size of out.
+    uint16_t pos;          ///< Decoded bytes so far.
+    uint16_t frameLength;  ///< Length of the last complete frame.
+    uint8_t remaining;     ///< Data bytes left in the current block (0: expect a code).
+    bool pendingZero;      ///< The block just finished implies a 0x00 before the next.
+    bool discarding;       ///< Dropping bytes until the next delimiter.
+};
+
+} // namespace cobs
+
+#endif // COBS_H
@@ -0,0 +1,159 @@
+#include <avr/pgmspace.h>
+#include "fmt.h"
+
+// JSF AV C++ Rule 12: static for file scope.
+namespace {
+
+constexpr uint16_t POW10[fmt::MAX_DECIMALS + 1U] = { 1U, 10U, 100U, 1000U, 10000U };
+
+/**
+ * @brief Converts @p value to decimal digits, least significant first.
+ * @return Number of digits (at least 1).
+ */
+uint8_t toDigitsReversed(uint32_t value, char (&digits)[fmt::MAX_DIGITS]) noexcept {
+    uint8_t count = 0U;
+    // 32-bit division is several times slower than 16-bit on AVR; only pay
+    // for it while the value does not fit 16 bits.
+    while ((value > 0xFFFFUL) && (count < fmt::MAX_DIGITS)) {
+        digits[count] = static_cast<char>('0' + static_cast<uint8_t>(value % 10UL));
+        value /= 10UL;
+        ++count;
+    }
+    uint16_t small = static_cast<uint16_t>(value);
+    do {
+        digits[count] = static_cast<char>('0' + static_cast<uint8_t>(small % 10U));
+        small = static_cast<uint16_t>(small / 10U);
+        ++count;
+    } while ((small != 0U) && (count < fmt::MAX_DIGITS));
+    return count;
+}
+
+/// Fills @p out with '*' to flag a number wider than its field.
+uint8_t overflow(char* out, uint8_t cap) noexcept {
+    for (uint8_t i = 0U; i < cap; ++i) {
+        out[i] = '*';
+    }
+    return cap;
+}
+
+/**
+ * @brief Lays out [pad][sign][digits][.fraction] right-aligned in @p width.
+ * @param digits Integer part, least significant first.
+ * @param frac Fraction digits, least significant first (fracCount may be 0).
+ */
+uint8_t emit(char* out, uint8_t cap, bool negative,
+             const char (&digits)[fmt::MAX_DIGITS], uint8_t digitCount,
+             const char (&frac)[fmt::MAX_DIGITS], uint8_t fracCount,
+             uint8_t width, char pad) noexcept {
+    const uint8_t body = static_cast<uint8_t>((negative ? 1U : 0U) + digitCount +
+                                              ((fracCount != 0U) ? (1U + fracCount) : 0U));
+    const uint8_t total = (width > body) ? width : body;
+    if (total > cap) {
+        return overflow(out, cap);
+    }
+
+    uint8_t n = 0U;
+    // Zero padding goes between the sign and the digits; space padding before the sign.
+    const bool signFirst = negative && (pad == '0');
+    if (signFirst) {
+        out[n] = '-';
+        ++n;
+    }
+    for (uint8_t i = body; i < total; ++i) {
+        out[n] = pad;
+        ++n;
+    }
+    if (negative && !signFirst) {
+        out[n] = '-';
+        ++n;
+    }
+    while (digitCount > 0U) {
+        --digitCount;
+        out[n] = digits[digitCount];
+        ++n;
+    }
+    if (fracCount != 0U) {
+        out[n] = '.';
+        ++n;
+        while (fracCount > 0U) {
+            --fracCount;
+            out[n] = frac[fracCount];
+            ++n;
+        }
+    }
+    return n;
+}
+
+} // anonymous namespace
+
+namespace fmt {
+
+uint8_t writeString(char* out, uint8_t cap, const char* str) noexcept {
+    uint8_t n = 0U;
+    if (str != nullptr) {
+        while ((n < cap) && (str[n] != '\0')) {  // Bounded by cap
+            out[n] = str[n];
+            ++n;
+        }
+    }
+    return n;
+}
+
+uint8_t writeString_P(char* out, uint8_t cap, const char* pstr) noexcept {
+    uint8_t n = 0U;
+    if (pstr != nullptr) {
+        while (n < cap) {  // Bounded by cap
+            const char c = static_cast<char>(pgm_read_byte(pstr + n));
+            if (c == '\0') {
+                break;
+            }
+            out[n] = c;
+            ++n;
+        }
+    }
+    return n;
+}
+
+uint8_t writeUnsigned(char* out, uint8_t cap, uint32_t value, uint8_t width, char pad) noexcept {
+    char digits[MAX_DIGITS];
+    char none[MAX_DIGITS];
+    const uint8_t count = toDigitsReversed(value, digits);
+    return emit(out, cap, false, digits, count, none, 0U, width, pad);
+}
+
+uint8_t writeSigned(char* out, uint8_t cap, int32_t value, uint8_t width) noexcept {
+    const bool negative = (value < 0L);
+    // Negate in unsigned arithmetic so INT32_MIN does not overflow.
+    const uint32_t magnitude = negative ? (0UL - static_cast<uint32_t>(value)) : static_cast<uint32_t>(value);
+    char digits[MAX_DIGITS];
+    char none[MAX_DIGITS];
+    const uint8_t count = toDigitsReversed(magnitude, digits);
+    return emit(out, cap, negative, digits, count, none, 0U, width, ' ');
+}
+
+uint8_t writeFixed(char* out, uint8_t cap, int32_t scaled, uint8_t decimals, uint8_t width) noexcept {
+    if (decimals > MAX_DECIMALS) {
+        decimals = MAX_DECIMALS;
+    }
+    const bool negative = (scaled < 0L);
+    const uint32_t magnitude = negative ? (0UL - static_cast<uint32_t>(scaled)) : static_cast<uint32_t>(scaled);
+    const uint16_t divisor = POW10[decimals];
+
+    char digits[MAX_DIGITS];
+    char frac[MAX_DIGITS];
+    const uint8_t count = toDigitsReversed(magnitude / divisor, digits);
+    uint16_t remainder = static_cast<uint16_t>(magnitude % divisor);
+    for (uint8_t i = 0U; i < decimals; ++i) {  // Fraction keeps its leading zeros
+        frac[i] = static_cast<char>('0' + static_cast<uint8_t>(remainder % 10U));
+        remainder = static_cast<uint16_t>(remainder / 10U);
+    }
+    return emit(out, cap, negative, digits, count, frac, decimals, width, ' ');
+}
+
+void terminate(char* out, uint8_t size, uint8_t length) noexcept {
+    if (size != 0U) {
+        out[(length < size) ? length : static_cast<uint8_t>(size - 1U)] = '\0';
+    }
+}
+
+} // namespace fmt
@@ -0,0 +1,74 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdint.h>
+
+/**
+ * @file fmt.h
+ * @brief Integer-only text formatting for fixed-width displays.
+ * @details Replaces dtostrf()/snprintf() in the UI path: no soft-float, no
+ *          varargs parser, and values below 65536 are converted with 16-bit
+ *          arithmetic only. Every writer appends into a caller buffer of
+ *          @p cap characters, never writes a terminator and returns the
+ *          number of characters written, so calls can be chained directly
+ *          into an LCD shadow row:
+ *
+ * @code
+ * uint8_t n = fmt::writeString(row, LCD::COLS, "Temp:");
+ * n += fmt::writeFixed(row + n, LCD::COLS - n, data.temperature, 1U);
+ * @endcode
+ *
+ *          A number that does not fit in @p cap is shown as '*' characters
+ *          instead of being truncated to a misleading value.
+ */
+namespace fmt {
+
+/// Most digits a uint32_t needs.
+constexpr uint8_t MAX_DIGITS = 10U;
+/// Most decimals writeFixed() accepts.
+constexpr uint8_t MAX_DECIMALS = 4U;
+
+/**
+ * @brief Appends @p str (truncated to @p cap).
+ * @return Characters written.
+ */
+uint8_t writeString(char* out, uint8_t cap, const char* str) noexcept;
+
+/**
+ * @brief Appends a PROGMEM string (truncated to @p cap).
+ * @return Characters written.
+ */
+uint8_t writeString_P(char* out, uint8_t cap, const char* pstr) noexcept;
+
+/**
+ * @brief Appends @p value in decimal, right-aligned in @p width using @p pad.
+ * @return Characters written.
+ */
+uint8_t writeUnsigned(char* out, uint8_t cap, uint32_t value, uint8_t width = 0U, char pad = ' ') noexcept;
+
+/**
+ * @brief Appends @p value in decimal with a leading '-' if negative,
+ *        right-aligned in @p width.
+ * @return Characters written.
+ */
+uint8_t writeSigned(char* out, uint8_t cap, int32_t value, uint8_t width = 0U) noexcept;
+
+/**
+ * @brief Appends a fixed-point number, right-aligned in @p width.
+ * @details @p scaled holds the value times 10^@p decimals, e.g. 215 with one
+ *          decimal is "21.5" and -5 is "-0.5". Decimals above MAX_DECIMALS
+ *          are clamped.
+ * @return Characters written.
+ */
+uint8_t writeFixed(char* out, uint8_t cap, int32_t scaled, uint8_t decimals, uint8_t width = 0U) noexcept;
+
+/**
+ * @brief NUL-terminates a buffer filled by the writers above.
+ * @param size Total buffer size including the terminator (> 0).
+ * @param length Characters written so far; clamped to size - 1.
+ */
+void terminate(char* out, uint8_t size, uint8_t length) noexcept;
+
+} // namespace fmt
+
+#endif // FMT_H
@@ -1,5 +1,10 @@
 #include "lcd.h"
-#include <stdlib.h>  // For dtostrf() - already available in Arduino AVR environment
+#include "fmt.h"  // Integer formatting instead of dtostrf()
+
+namespace {
+// Execution time per wait class (HD44780 datasheet, with margin), indexed by WAIT_*
+constexpr uint16_t WAIT_US[4] = { 50U, 2000U, 4500U, 0U };
+}
 
 LCD::LCD(uint8_t rs, uint8_t en, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7, uint8_t backlight) {
     _rs_pin = rs;
@@ -13,6 +18,20 @@ LCD::LCD(uint8_t rs, uint8_t en, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7,
     _display_function = LCD_4BIT_MODE | LCD_2_LINE | LCD_5x8_DOTS;
     _display_control = LCD_DISPLAY_ON | LCD_CURSOR_OFF | LCD_BLINK_OFF;
     _display_mode = LCD_ENTRY_LEFT | LCD_ENTRY_SHIFT_DEC;
+
+    _qHead = 0U;
+    _qTail = 0U;
+    _dropped = 0U;
+    _lastUs = 0UL;
+    _waitUs = 0U;
+    _hooks = nullptr;
+    _frame = 0U;
+    for (uint8_t i = 0U; i < GLYPH_SLOTS; ++i) {
+        _glyphFrame[i] = 0U;
+    }
+
+    bufferClear();
+    invalidate();
 }
 
 void LCD::begin() {
@@ -29,17 +48,18 @@ void LCD::begin() {
         // No backlight control needed
     }
 
-    // Initialization sequence (per KS0066/HD44780 datasheet for JHD162A)
-    delay(50);  // Wait for power-up (>40ms)
+    // Initialization sequence (per KS0066/HD44780 datasheet for JHD162A).
+    // Queued rather than executed: each step carries the wait that must
+    // elapse before the next one, and pump() walks the sequence in the
+    // background, so start-up does not stall for ~60 ms.
+    _lastUs = micros();
+    _waitUs = POWER_UP_WAIT_US;  // Wait for power-up (>40ms)
 
     // Send function set in 8-bit mode initially
-    write4Bits(0x03);
-    delay(5);   // >4.1ms
-    write4Bits(0x03);
-    delay(1);   // >100us
-    write4Bits(0x03);
-    delay(1);
-    write4Bits(0x02);  // Switch to 4-bit mode
+    (void)enqueue(ENTRY_NIBBLE | 0x03U | (static_cast<uint16_t>(WAIT_INIT) << ENTRY_WAIT_SHIFT));   // >4.1ms
+    (void)enqueue(ENTRY_NIBBLE | 0x03U | (static_cast<uint16_t>(WAIT_CLEAR) << ENTRY_WAIT_SHIFT));  // >100us
+    (void)enqueue(ENTRY_NIBBLE | 0x03U | (static_cast<uint16_t>(WAIT_CLEAR) << ENTRY_WAIT_SHIFT));
+    (void)enqueue(ENTRY_NIBBLE | 0x02U);  // Switch to 4-bit mode
 
     // Set function
     send(LCD_FUNCTION_SET | _display_function, 0);
@@ -55,13 +75,11 @@ void LCD::begin() {
 }
 
 void LCD::clear() {
-    send(LCD_CLEAR_DISPLAY, 0);
-    delay(2);  // >1.52ms
+    send(LCD_CLEAR_DISPLAY, 0);  // pump() holds off the next entry >1.52ms
 }
 
 void LCD::home() {
-    send(LCD_RETURN_HOME, 0);
-    delay(2);  // >1.52ms
+    send(LCD_RETURN_HOME, 0);  // pump() holds off the next entry >1.52ms
 }
 
 void LCD::setCursor(uint8_t col, uint8_t row) {
@@ -124,16 +142,23 @@ void LCD::print(int num) {
 }
 
 void LCD::print(float value, uint8_t decimals) {
-    char buf[16];  // Sufficient size: sign + digits + '.' + decimals + null (~ e.g. -123.456 → 8 chars + margin)
+    char buf[16];  // Sufficient size: sign + 10 digits + '.' + decimals + null
 
-    // Convert float to string: width=- (left align), precision=decimals
-    dtostrf(value, -10, decimals, buf);  // -10 = left justify, enough width to avoid truncation
-
-    // Trim leading/trailing spaces if any (dtostrf pads with spaces for positive width)
-    char* p = buf;
-    while (*p == ' ') ++p;  // Skip leading spaces
+    // Scale to fixed point once, then format with integer arithmetic only
+    if (decimals > fmt::MAX_DECIMALS) {
+        decimals = fmt::MAX_DECIMALS;
+    } else {
+        // Within range
+    }
+    float scaled = value;
+    for (uint8_t i = 0U; i < decimals; ++i) {  // Bounded by MAX_DECIMALS
+        scaled *= 10.0f;
+    }
+    const int32_t rounded = static_cast<int32_t>((scaled < 0.0f) ? (scaled - 0.5f) : (scaled + 0.5f));
 
-    print(p);  // Reuse existing print(const char*) - bounded and safe
+    const uint8_t len = fmt::writeFixed(buf, static_cast<uint8_t>(sizeof(buf) - 1U), rounded, decimals);
+    fmt::terminate(buf, static_cast<uint8_t>(sizeof(buf)), len);
+    print(buf);  // Reuse existing print(const char*) - bounded and safe
 }
 
 void LCD::displayOn() {
@@ -190,24 +215,255 @@ void LCD::setBacklight(uint8_t brightness) {
     }
 }
 
+void LCD::bufferClear() {
+    for (uint8_t row = 0U; row < ROWS; ++row) {
+        for (uint8_t col = 0U; col < COLS; ++col) {
+            _shadow[row][col] = ' ';
+        }
+    }
+}
+
+void LCD::bufferPut(uint8_t col, uint8_t row, char c) {
+    if ((row < ROWS) && (col < COLS)) {
+        _shadow[row][col] = c;
+    } else {
+        // Out of range: ignored
+    }
+}
+
+uint8_t LCD::bufferPrint(uint8_t col, uint8_t row, const char* str) {
+    uint8_t written = 0U;
+    if ((row < ROWS) && (str != nullptr)) {
+        while ((col < COLS) && (str[written] != '\0')) {  // Bounded by COLS
+            _shadow[row][col] = str[written];
+            ++col;
+            ++written;
+        }
+    } else {
+        // Out of range: nothing written
+    }
+    return written;
+}
+
+char* LCD::bufferRow(uint8_t row) {
+    return (row < ROWS) ? _shadow[row] : nullptr;
+}
+
+void LCD::invalidate() {
+    for (uint8_t row = 0U; row < ROWS; ++row) {
+        for (uint8_t col = 0U; col < COLS; ++col) {
+            _glass[row][col] = GLASS_UNKNOWN;
+        }
+    }
+    _addr = ADDR_UNKNOWN;
+    // CGRAM contents are unknown too (power-up, or an upload may have been dropped)
+    for (uint8_t i = 0U; i < GLYPH_SLOTS; ++i) {
+        _glyphKey[i] = GLYPH_KEY_NONE;
+    }
+}
+
+char LCD::glyph(uint8_t key, GlyphGenerator generate) {
+    // Codes 0-7 and 8-15 both address CGRAM; 8-15 keep '\0' free as the
+    // glass "unknown" marker and string terminator.
+    constexpr uint8_t GLYPH_CODE_BASE = 8U;
+    uint8_t victim = GLYPH_SLOTS;
+    uint8_t victimAge = 0U;
+    bool victimFree = false;
+    for (uint8_t slot = 0U; slot < GLYPH_SLOTS; ++slot) {
+        if ((key != GLYPH_KEY_NONE) && (_glyphKey[slot] == key)) {
+            _glyphFrame[slot] = _frame;
+            return static_cast<char>(GLYPH_CODE_BASE + slot);  // Hit: already in CGRAM
+        }
+        // Prefer a free slot, else the least recently used one; slots drawn in
+        // this frame (age 0) must keep their pattern until it is rendered.
+        const uint8_t age = static_cast<uint8_t>(_frame - _glyphFrame[slot]);
+        if (_glyphKey[slot] == GLYPH_KEY_NONE) {
+            if (!victimFree) {
+                victim = slot;
+                victimFree = true;
+            }
+        } else if ((!victimFree) && (age != 0U) && (age > victimAge)) {
+            victim = slot;
+            victimAge = age;
+        } else {
+            // Keep current candidate
+        }
+    }
+
+    // Upload: one CGRAM address command plus one data write per row
+    if ((key == GLYPH_KEY_NONE) || (generate == nullptr) || (victim == GLYPH_SLOTS) ||
+        (static_cast<uint8_t>(QUEUE_SIZE - queued()) < (1U + GLYPH_ROWS))) {
+        return '\0';
+    }
+    uint8_t rows[GLYPH_ROWS] = {};
+    generate(key, rows);
+    send(static_cast<uint8_t>(LCD_SET_CGRAM_ADDR | (victim << 3)), 0);
+    for (uint8_t row = 0U; row < GLYPH_ROWS; ++row) {
+        send(static_cast<uint8_t>(rows[row] & 0x1FU), 1);
+    }
+    _glyphKey[victim] = key;
+    _glyphFrame[victim] = _frame;
+    return static_cast<char>(GLYPH_CODE_BASE + victim);
+}
+
+uint8_t LCD::render() {
+    uint8_t sent = 0U;
+    ++_frame;  // Glyphs used so far are committed; later calls compose the next frame
+    for (uint8_t row = 0U; row < ROWS; ++row) {
+        const uint8_t rowBase = (row == 0U) ? 0x00U : 0x40U;
+        for (uint8_t col = 0U; col < COLS; ++col) {
+            if (static_cast<uint8_t>(QUEUE_SIZE - queued()) < 2U) {
+                return sent;  // Queue full: the rest stays dirty for the next render()
+            } else if (_shadow[row][col] != _glass[row][col]) {
+                // Runs of dirty cells ride the DDRAM auto-increment; only a
+                // gap (or a row change) costs an address command.
+                const uint8_t target = static_cast<uint8_t>(rowBase + col);
+                if (_addr != target) {
+                    send(LCD_SET_DDRAM_ADDR | target, 0);
+                    ++sent;
+                } else {
+                    // Already positioned
+                }
+                send(static_cast<uint8_t>(_shadow[row][col]), 1);
+                ++sent;
+            } else {
+                // Clean cell: skipped
+            }
+        }
+    }
+    return sent;
+}
+
+void LCD::track(uint8_t value, uint8_t mode) {
+    if (mode != 0U) {
+        // Data write: lands at the current DDRAM address, which then increments
+        if (_addr != ADDR_UNKNOWN) {
+            const uint8_t row = (_addr >= 0x40U) ? 1U : 0U;
+            const uint8_t col = static_cast<uint8_t>(_addr - ((row == 0U) ? 0x00U : 0x40U));
+            if (col < COLS) {
+                _glass[row][col] = static_cast<char>(value);
+            } else {
+                // Off-screen DDRAM: not tracked
+            }
+            _addr = static_cast<uint8_t>(_addr + 1U);
+        } else {
+            // Position unknown (e.g. CGRAM mode): glass unaffected
+        }
+    } else if ((value & LCD_SET_DDRAM_ADDR) != 0U) {
+        _addr = static_cast<uint8_t>(value & 0x7FU);
+    } else if ((value & LCD_SET_CGRAM_ADDR) != 0U) {
+        _addr = ADDR_UNKNOWN;
+    } else if (value == LCD_CLEAR_DISPLAY) {
+        for (uint8_t row = 0U; row < ROWS; ++row) {
+            for (uint8_t col = 0U; col < COLS; ++col) {
+                _glass[row][col] = ' ';
+            }
+        }
+        _addr = 0x00U;
+    } else if ((value & 0xFEU) == LCD_RETURN_HOME) {
+        _addr = 0x00U;
+    } else {
+        // Other commands leave the DDRAM contents and address alone
+    }
+}
+
 void LCD::send(uint8_t value, uint8_t mode) {
-    digitalWrite(_rs_pin, mode);  // 0: command, 1: data
+    uint16_t entry = value;
+    if (mode != 0U) {
+        entry |= ENTRY_DATA;
+    } else if ((value == LCD_CLEAR_DISPLAY) || ((value & 0xFEU) == LCD_RETURN_HOME)) {
+        entry |= static_cast<uint16_t>(WAIT_CLEAR) << ENTRY_WAIT_SHIFT;
+    } else {
+        // Ordinary command: WAIT_EXEC
+    }
+    if (enqueue(entry)) {
+        track(value, mode);
+    } else {
+        // Dropped: the glass no longer matches our record, redraw it all
+        invalidate();
+    }
+}
+
+bool LCD::enqueue(uint16_t entry) {
+    const uint8_t h = _qHead;
+    const uint8_t t = __atomic_load_n(&_qTail, __ATOMIC_ACQUIRE);
+    if (static_cast<uint8_t>(h - t) >= QUEUE_SIZE) {
+        ++_dropped;
+        return false;
+    }
+    _queue[h & (QUEUE_SIZE - 1U)] = entry;
+    __atomic_store_n(&_qHead, static_cast<uint8_t>(h + 1U), __ATOMIC_RELEASE);
+    return true;
+}
+
+uint8_t LCD::queued() const {
+    return static_cast<uint8_t>(__atomic_load_n(&_qHead, __ATOMIC_ACQUIRE) -
+                                __atomic_load_n(&_qTail, __ATOMIC_ACQUIRE));
+}
+
+bool LCD::pump() {
+    const uint8_t t = _qTail;
+    if (__atomic_load_n(&_qHead, __ATOMIC_ACQUIRE) == t) {
+        return false;
+    }
+    // The controller is still executing the previous entry: come back later
+    if ((micros() - _lastUs) < _waitUs) {
+        return true;
+    }
+
+    const uint16_t entry = _queue[t & (QUEUE_SIZE - 1U)];
+    const uint8_t value = static_cast<uint8_t>(entry & 0xFFU);
+    if ((entry & ENTRY_NIBBLE) != 0U) {
+        setRs(LOW);
+        write4Bits(value);
+    } else {
+        writeNow(value, ((entry & ENTRY_DATA) != 0U) ? 1U : 0U);
+    }
+    _lastUs = micros();
+    _waitUs = WAIT_US[(entry >> ENTRY_WAIT_SHIFT) & 0x03U];
+
+    __atomic_store_n(&_qTail, static_cast<uint8_t>(t + 1U), __ATOMIC_RELEASE);
+    return true;
+}
+
+void LCD::writeNow(uint8_t value, uint8_t mode) {
+    setRs((mode != 0U) ? HIGH : LOW);  // 0: command, 1: data
     write4Bits(value >> 4);       // High nibble
     write4Bits(value & 0x0F);     // Low nibble
 }
 
+void LCD::setRs(uint8_t level) {
+    if (_hooks != nullptr) {
+        _hooks->rs(level);
+    } else {
+        digitalWrite(_rs_pin, level);
+    }
+}
+
+void LCD::setEn(uint8_t level) {
+    if (_hooks != nullptr) {
+        _hooks->en(level);
+    } else {
+        digitalWrite(_en_pin, level);
+    }
+}
+
 void LCD::write4Bits(uint8_t value) {
-    for (uint8_t i = 0U; i < 4U; ++i) {
-        digitalWrite(_data_pins[i], (value >> i) & 0x01);
+    if (_hooks != nullptr) {
+        _hooks->data(value & 0x0FU);  // One masked write per port
+    } else {
+        for (uint8_t i = 0U; i < 4U; ++i) {
+            digitalWrite(_data_pins[i], (value >> i) & 0x01);
+        }
     }
     pulseEnable();
 }
 
 void LCD::pulseEnable() {
-    digitalWrite(_en_pin, LOW);
+    setEn(LOW);
     delayMicroseconds(1);
-    digitalWrite(_en_pin, HIGH);
+    setEn(HIGH);
     delayMicroseconds(1);  // >450ns enable pulse (exceeds JHD162A min 230ns)
-    digitalWrite(_en_pin, LOW);
-    delayMicroseconds(100);  // >37us command exec (covers JHD162A timings)
+    setEn(LOW);
+    // Command execution time is enforced by pump(), not busy-waited here
 }
\ No newline at end of file
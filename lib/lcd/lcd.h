@@ -45,9 +45,9 @@ class LCD {
 public:
     LCD(uint8_t rs, uint8_t en, uint8_t d4, uint8_t d5, uint8_t d6, uint8_t d7, uint8_t backlight = 255);
     
-    void begin();  // Initialize LCD
-    void clear();  // Clear display
-    void home();   // Return to home position
+    void begin();  // Queue the power-up initialisation sequence (non-blocking)
+    void clear();  // Clear display (queued; pump() waits out the 1.52ms)
+    void home();   // Return to home position (queued)
     void setCursor(uint8_t col, uint8_t row);  // Set cursor position (0-15 col, 0-1 row)
     void print(const char* str);  // Print string (bounded to 80 chars for JSF AV loop bound)
     void print(char c);           // Print single char
@@ -63,6 +63,44 @@ public:
     void backlightOff();          // Turn backlight off
     void setBacklight(uint8_t brightness);  // PWM control (0-255)
 
+    // Shadow framebuffer: draw into RAM, then render() sends only changed cells
+    static constexpr uint8_t COLS = 16U;
+    static constexpr uint8_t ROWS = 2U;
+    void bufferClear();                                       // Fill shadow with spaces
+    void bufferPut(uint8_t col, uint8_t row, char c);         // Set one cell (out of range ignored)
+    uint8_t bufferPrint(uint8_t col, uint8_t row, const char* str);  // Write text, clipped at row end; returns cells written
+    uint8_t render();                                         // Queue dirty cells; returns entries queued
+    void invalidate();                                        // Glass unknown: next render() redraws all
+    char* bufferRow(uint8_t row);                             // Direct access to one shadow row (COLS cells, no terminator), nullptr if out of range
+
+    // Asynchronous bus: every command/character above is queued, and pump()
+    // clocks them out one at a time once the previous one has executed.
+    // Producer: any single context (tasks); consumer: pump() (idle loop).
+    static constexpr uint8_t QUEUE_SIZE = 64U;                // Entries (power of two); fits a full redraw
+    bool pump();                                              // Send the next due entry; true while work remains
+    uint8_t queued() const;                                   // Entries not yet sent
+    uint16_t droppedCount() const { return _dropped; }        // Entries rejected by a full queue
+
+    // CGRAM glyph cache: the 8 user-definable characters hold generated glyphs
+    // identified by a caller-chosen non-zero key. A hit costs nothing on the
+    // bus; a miss uploads into the least recently used slot not already
+    // drawn in the frame being composed (render() closes a frame).
+    static constexpr uint8_t GLYPH_SLOTS = 8U;
+    static constexpr uint8_t GLYPH_ROWS = 8U;
+    static constexpr uint8_t GLYPH_KEY_NONE = 0U;
+    using GlyphGenerator = void (*)(uint8_t key, uint8_t (&rows)[GLYPH_ROWS]);  // Bits 0-4 of each row, top first
+    char glyph(uint8_t key, GlyphGenerator generate);  // Character for key (codes 8-15), or '\0' if no slot/queue room this frame
+
+    // Optional direct pin access (e.g. compile-time port writes); without it
+    // the driver falls back to digitalWrite() on the constructor pins.
+    struct PinHooks {
+        void (*rs)(uint8_t level);     // Register select
+        void (*en)(uint8_t level);     // Enable strobe
+        void (*data)(uint8_t nibble);  // D4-D7 from bits 0-3
+    };
+    void setPinHooks(const PinHooks* hooks) { _hooks = hooks; }  // nullptr: digitalWrite()
+    void writeNow(uint8_t value, uint8_t mode);  // Immediate bus write, bypasses queue and glass (diagnostics)
+
 private:
     uint8_t _rs_pin;
     uint8_t _en_pin;
@@ -71,8 +109,39 @@ private:
     uint8_t _display_function;
     uint8_t _display_control;
     uint8_t _display_mode;
+    char _shadow[ROWS][COLS];  // What should be on the glass
+    char _glass[ROWS][COLS];   // What is on the glass (tracked through send())
+    uint8_t _addr;             // Current DDRAM address, or ADDR_UNKNOWN
+
+    static constexpr uint8_t ADDR_UNKNOWN = 0xFFU;
+    static constexpr char GLASS_UNKNOWN = '\0';  // Never equals a drawn cell
+
+    // Queue entry: bits 0-7 value, bit 8 RS, bit 9 single nibble, bits 12-13 wait class
+    static constexpr uint16_t ENTRY_DATA = 0x0100U;
+    static constexpr uint16_t ENTRY_NIBBLE = 0x0200U;
+    static constexpr uint8_t ENTRY_WAIT_SHIFT = 12U;
+    static constexpr uint8_t WAIT_EXEC = 0U;    // Ordinary command/data (>37us)
+    static constexpr uint8_t WAIT_CLEAR = 1U;   // Clear/home (>1.52ms)
+    static constexpr uint8_t WAIT_INIT = 2U;    // First init nibble (>4.1ms)
+    static constexpr uint16_t POWER_UP_WAIT_US = 50000U;  // Vcc rise to first command (>40ms)
+
+    uint16_t _queue[QUEUE_SIZE];
+    uint8_t _qHead;            // Next slot to write; producer only
+    uint8_t _qTail;            // Next slot to send; pump() only
+    uint16_t _dropped;
+    uint32_t _lastUs;          // micros() when the last entry was clocked out
+    uint16_t _waitUs;          // Execution time that entry needs
+    const PinHooks* _hooks;    // Direct pin access, or nullptr
+    uint8_t _glyphKey[GLYPH_SLOTS];    // Key held by each CGRAM slot (GLYPH_KEY_NONE: free/unknown)
+    uint8_t _glyphFrame[GLYPH_SLOTS];  // Frame in which each slot was last used
+    uint8_t _frame;                    // Frame being composed; advanced by render()
+
 
-    void send(uint8_t value, uint8_t mode);  // Send command or data
+    void send(uint8_t value, uint8_t mode);  // Queue command or data
+    void track(uint8_t value, uint8_t mode); // Mirror a send() into _glass/_addr
+    bool enqueue(uint16_t entry);            // Producer side of the queue
+    void setRs(uint8_t level);               // RS line via hooks or digitalWrite()
+    void setEn(uint8_t level);               // EN line via hooks or digitalWrite()
     void write4Bits(uint8_t value);          // Write 4-bit nibble
     void pulseEnable();                      // Pulse enable pin
 };
@@ -43,9 +43,27 @@ Creates class object; initialize it using ModbusMaster::begin().
 */
 ModbusMaster::ModbusMaster(void)
 {
+  _u8MBFunction = 0;
   _idle = 0;
   _preTransmission = 0;
   _postTransmission = 0;
+  clearStats();
+}
+
+
+/**
+Resets the transaction counters returned by getStats().
+
+@ingroup setup
+*/
+void ModbusMaster::clearStats()
+{
+  _stats.requests = 0;
+  _stats.responses = 0;
+  _stats.exceptions = 0;
+  _stats.timeouts = 0;
+  _stats.crcErrors = 0;
+  _stats.badFrames = 0;
 }
 
 /**
@@ -83,6 +101,7 @@ void ModbusMaster::beginTransmission(uint16_t u16Address)
 // eliminate this function in favor of using existing MB request functions
 uint8_t ModbusMaster::requestFrom(uint16_t address, uint16_t quantity)
 {
+  (void)address; // Wire-style signature; nothing is read here
   uint8_t read = 0;
   // clamp to buffer length
   if (quantity > ku8MaxBufferSize)
@@ -383,6 +402,45 @@ uint8_t ModbusMaster::readHoldingRegisters(uint16_t u16ReadAddress,
 }
 
 
+/**
+Modbus function 0x03 Read Holding Registers, non-blocking.
+
+Transmits the request and returns without waiting for the response; call 
+pollTransaction() until it stops returning ku8MBPending. The register data 
+is then available through getResponseBuffer() as for readHoldingRegisters().
+
+@param u16ReadAddress address of the first holding register (0x0000..0xFFFF)
+@param u16ReadQty quantity of holding registers to read (1..125, enforced by remote device)
+@return ku8MBPending once the request is on the wire
+@ingroup register
+*/
+uint8_t ModbusMaster::startReadHoldingRegisters(uint16_t u16ReadAddress,
+  uint16_t u16ReadQty)
+{
+  _u16ReadAddress = u16ReadAddress;
+  _u16ReadQty = u16ReadQty;
+  return ModbusMasterSend(ku8MBReadHoldingRegisters);
+}
+
+
+/**
+Advance the in-flight non-blocking transaction.
+
+Consumes whatever response bytes have arrived and returns immediately.
+
+@return ku8MBPending while waiting; 0 on success; exception number on failure
+@ingroup register
+*/
+uint8_t ModbusMaster::pollTransaction()
+{
+  if (!_u8MBFunction)
+  {
+    return ku8MBInvalidFunction; // nothing in flight
+  }
+  return ModbusMasterReceive();
+}
+
+
 /**
 Modbus function 0x04 Read Input Registers.
 
@@ -452,6 +510,27 @@ uint8_t ModbusMaster::writeSingleRegister(uint16_t u16WriteAddress,
 }
 
 
+/**
+Modbus function 0x06 Write Single Register, non-blocking.
+
+Transmits the request and returns without waiting for the echo; call 
+pollTransaction() until it stops returning ku8MBPending.
+
+@param u16WriteAddress address of the holding register (0x0000..0xFFFF)
+@param u16WriteValue value to be written to holding register (0x0000..0xFFFF)
+@return ku8MBPending once the request is on the wire
+@ingroup register
+*/
+uint8_t ModbusMaster::startWriteSingleRegister(uint16_t u16WriteAddress,
+  uint16_t u16WriteValue)
+{
+  _u16WriteAddress = u16WriteAddress;
+  _u16WriteQty = 0;
+  _u16TransmitBuffer[0] = u16WriteValue;
+  return ModbusMasterSend(ku8MBWriteSingleRegister);
+}
+
+
 /**
 Modbus function 0x0F Write Multiple Coils.
 
@@ -599,13 +678,111 @@ Sequence:
 */
 uint8_t ModbusMaster::ModbusMasterTransaction(uint8_t u8MBFunction)
 {
-  uint8_t u8ModbusADU[256];
+  uint8_t u8MBStatus = ModbusMasterSend(u8MBFunction);
+  
+  while (u8MBStatus == ku8MBPending)
+  {
+    u8MBStatus = ModbusMasterReceive();
+    if (u8MBStatus == ku8MBPending && _idle)
+    {
+      _idle();
+    }
+  }
+  return u8MBStatus;
+}
+
+
+/**
+Data byte count of a read response to the current request.
+
+@param u8MBFunction Modbus function of the request
+@return bytes between the byte count field and the CRC
+*/
+uint16_t ModbusMaster::readByteCount(uint8_t u8MBFunction) const
+{
+  switch(u8MBFunction)
+  {
+    case ku8MBReadCoils:
+    case ku8MBReadDiscreteInputs:
+      return (_u16ReadQty >> 3) + ((_u16ReadQty & 7) ? 1 : 0);
+      
+    default:
+      return (_u16ReadQty > 0x7FFF) ? 0xFFFF : (_u16ReadQty << 1);
+  }
+}
+
+
+/**
+Check the current request against the buffer sizes.
+
+The request (plus the terminating zero ModbusMasterSend() appends) and its
+longest valid response must fit MODBUS_ADU_BYTES, and written data must
+come from within the transmit buffer.
+
+@param u8MBFunction Modbus function of the request
+@return true if the transaction can run
+*/
+bool ModbusMaster::frameFits(uint8_t u8MBFunction) const
+{
+  uint32_t u32Request = 8;   // slave, function, 4 bytes, CRC
+  uint32_t u32Response = 8;
+  uint32_t u32Words = 0;
+  
+  switch(u8MBFunction)
+  {
+    case ku8MBReadCoils:
+    case ku8MBReadDiscreteInputs:
+    case ku8MBReadInputRegisters:
+    case ku8MBReadHoldingRegisters:
+      u32Response = 5UL + readByteCount(u8MBFunction);
+      break;
+      
+    case ku8MBWriteMultipleCoils:
+      u32Request = 9UL + (_u16WriteQty >> 3) + ((_u16WriteQty & 7) ? 1 : 0);
+      u32Words = (_u16WriteQty >> 4) + ((_u16WriteQty & 15) ? 1 : 0);
+      break;
+      
+    case ku8MBWriteMultipleRegisters:
+      u32Request = 9UL + (2UL * _u16WriteQty);
+      u32Words = _u16WriteQty;
+      break;
+      
+    case ku8MBMaskWriteRegister:
+      u32Request = 10;
+      u32Response = 10;
+      break;
+      
+    case ku8MBReadWriteMultipleRegisters:
+      u32Request = 13UL + (2UL * _u16WriteQty);
+      u32Response = 5UL + readByteCount(u8MBFunction);
+      u32Words = _u16WriteQty;
+      break;
+  }
+  return (u32Request < MODBUS_ADU_BYTES) && (u32Response <= MODBUS_ADU_BYTES) &&
+    (u32Words <= ku8MaxBufferSize);
+}
+
+
+/**
+Transmit half of the transaction engine.
+
+Assembles the request ADU, transmits it and arms the response timeout.
+
+@param u8MBFunction Modbus function (0x01..0xFF)
+@return ku8MBPending; ku8MBIllegalDataValue, without transmitting, if the
+request does not fit the buffers (frameFits())
+*/
+uint8_t ModbusMaster::ModbusMasterSend(uint8_t u8MBFunction)
+{
+  uint8_t* u8ModbusADU = _u8ModbusADU;
   uint8_t u8ModbusADUSize = 0;
   uint8_t i, u8Qty;
   uint16_t u16CRC;
-  uint32_t u32StartTime;
-  uint8_t u8BytesLeft = 8;
-  uint8_t u8MBStatus = ku8MBSuccess;
+  
+  if (!frameFits(u8MBFunction))
+  {
+    return ku8MBIllegalDataValue;
+  }
   
   // assemble Modbus Request Application Data Unit
   u8ModbusADU[u8ModbusADUSize++] = _u8MBSlave;
@@ -721,37 +898,58 @@ uint8_t ModbusMaster::ModbusMasterTransaction(uint8_t u8MBFunction)
     _postTransmission();
   }
   
+  _u8ModbusADUSize = 0;
+  _u8BytesLeft = 8;
+  _u8MBFunction = u8MBFunction;
+  _u32StartTime = millis();
+  _stats.requests++;
+  return ku8MBPending;
+}
+
+
+/**
+Receive half of the transaction engine.
+
+Consumes available response bytes without blocking, then evaluates and
+disassembles the response once it is complete or has failed.
+
+@return ku8MBPending while waiting; 0 on success; exception number on failure
+*/
+uint8_t ModbusMaster::ModbusMasterReceive()
+{
+  uint8_t* u8ModbusADU = _u8ModbusADU;
+  uint8_t i;
+  uint16_t u16CRC;
+  uint8_t u8MBStatus = ku8MBSuccess;
+  const uint8_t u8MBFunction = _u8MBFunction;
+  
   // loop until we run out of time or bytes, or an error occurs
-  u32StartTime = millis();
-  while (u8BytesLeft && !u8MBStatus)
+  while (_u8BytesLeft && !u8MBStatus)
   {
     if (_serial->available())
     {
 #if __MODBUSMASTER_DEBUG__
       digitalWrite(__MODBUSMASTER_DEBUG_PIN_A__, true);
 #endif
-      u8ModbusADU[u8ModbusADUSize++] = _serial->read();
-      u8BytesLeft--;
+      u8ModbusADU[_u8ModbusADUSize++] = _serial->read();
+      _u8BytesLeft--;
 #if __MODBUSMASTER_DEBUG__
       digitalWrite(__MODBUSMASTER_DEBUG_PIN_A__, false);
 #endif
     }
+    else if ((millis() - _u32StartTime) > ku16MBResponseTimeout)
+    {
+      u8MBStatus = ku8MBResponseTimedOut;
+      break;
+    }
     else
     {
-#if __MODBUSMASTER_DEBUG__
-      digitalWrite(__MODBUSMASTER_DEBUG_PIN_B__, true);
-#endif
-      if (_idle)
-      {
-        _idle();
-      }
-#if __MODBUSMASTER_DEBUG__
-      digitalWrite(__MODBUSMASTER_DEBUG_PIN_B__, false);
-#endif
+      // nothing to read yet; let the caller idle or yield
+      return ku8MBPending;
     }
     
     // evaluate slave ID, function code once enough bytes have been read
-    if (u8ModbusADUSize == 5)
+    if (_u8ModbusADUSize == 5)
     {
       // verify response is for correct Modbus slave
       if (u8ModbusADU[0] != _u8MBSlave)
@@ -782,27 +980,35 @@ uint8_t ModbusMaster::ModbusMasterTransaction(uint8_t u8MBFunction)
         case ku8MBReadInputRegisters:
         case ku8MBReadHoldingRegisters:
         case ku8MBReadWriteMultipleRegisters:
-          u8BytesLeft = u8ModbusADU[2];
+          _u8BytesLeft = u8ModbusADU[2];
+          // any other count is not an answer to this request, and could overrun the ADU
+          if (u8ModbusADU[2] != readByteCount(u8MBFunction))
+          {
+            u8MBStatus = ku8MBInvalidByteCount;
+          }
           break;
           
         case ku8MBWriteSingleCoil:
         case ku8MBWriteMultipleCoils:
         case ku8MBWriteSingleRegister:
         case ku8MBWriteMultipleRegisters:
-          u8BytesLeft = 3;
+          _u8BytesLeft = 3;
           break;
           
         case ku8MBMaskWriteRegister:
-          u8BytesLeft = 5;
+          _u8BytesLeft = 5;
           break;
       }
     }
-    if ((millis() - u32StartTime) > ku16MBResponseTimeout)
+    if ((millis() - _u32StartTime) > ku16MBResponseTimeout)
     {
       u8MBStatus = ku8MBResponseTimedOut;
     }
   }
   
+  const uint8_t u8ModbusADUSize = _u8ModbusADUSize;
+  _u8MBFunction = 0;
+  
   // verify response is large enough to inspect further
   if (!u8MBStatus && u8ModbusADUSize >= 5)
   {
@@ -869,6 +1075,32 @@ uint8_t ModbusMaster::ModbusMasterTransaction(uint8_t u8MBFunction)
     }
   }
   
+  switch(u8MBStatus)
+  {
+    case ku8MBSuccess:
+      _stats.responses++;
+      break;
+      
+    case ku8MBResponseTimedOut:
+      _stats.timeouts++;
+      break;
+      
+    case ku8MBInvalidCRC:
+      _stats.crcErrors++;
+      break;
+      
+    case ku8MBInvalidSlaveID:
+    case ku8MBInvalidFunction:
+    case ku8MBInvalidByteCount:
+      _stats.badFrames++;
+      break;
+      
+    default:
+      _stats.responses++;
+      _stats.exceptions++;
+      break;
+  }
+  
   _u8TransmitBufferIndex = 0;
   u16TransmitBufferLength = 0;
   _u8ResponseBufferIndex = 0;
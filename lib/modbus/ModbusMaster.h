@@ -51,6 +51,28 @@ Set to 1 to enable debugging features within class:
 #include "Arduino.h"
 
 /* _____UTILITY MACROS_______________________________________________________ */
+/**
+@def MODBUS_BUFFER_WORDS (64)
+Size of the response and transmit word buffers. Builds that only ever
+transfer a few registers may lower it (build_flags) to save RAM.
+*/
+#ifndef MODBUS_BUFFER_WORDS
+#define MODBUS_BUFFER_WORDS (64)
+#endif
+
+/**
+@def MODBUS_ADU_BYTES (256)
+Size of the request/response ADU buffer; 256 holds any RTU frame. A smaller
+buffer only limits the quantity per request: requests whose frame or
+expected response would not fit are refused before transmission.
+*/
+#ifndef MODBUS_ADU_BYTES
+#define MODBUS_ADU_BYTES (256)
+#endif
+
+#if (MODBUS_ADU_BYTES < 16) || (MODBUS_ADU_BYTES > 256)
+#error "MODBUS_ADU_BYTES must be 16..256"
+#endif
 
 
 /* _____PROJECT INCLUDES_____________________________________________________ */
@@ -188,6 +210,44 @@ class ModbusMaster
     */
     static const uint8_t ku8MBInvalidCRC                 = 0xE3;
     
+    /**
+    ModbusMaster transaction pending.
+    
+    Returned by the non-blocking API while a request has been sent and the
+    response is still being received; poll again with pollTransaction().
+    
+    @ingroup constant
+    */
+    static const uint8_t ku8MBPending                    = 0xE4;
+    
+    /**
+    ModbusMaster invalid response byte count exception.
+    
+    The byte count of a read response is not the one the request asked for.
+    
+    @ingroup constant
+    */
+    static const uint8_t ku8MBInvalidByteCount           = 0xE5;
+
+    /**
+    Transaction counters, updated by both the blocking and the non-blocking
+    API. They wrap at 65535.
+    @ingroup constant
+    */
+    struct Stats
+    {
+      uint16_t requests;    ///< requests transmitted
+      uint16_t responses;   ///< valid responses (success or Modbus exception)
+      uint16_t exceptions;  ///< responses carrying a Modbus exception code
+      uint16_t timeouts;    ///< ku8MBResponseTimedOut
+      uint16_t crcErrors;   ///< ku8MBInvalidCRC
+      uint16_t badFrames;   ///< ku8MBInvalidSlaveID, ku8MBInvalidFunction or ku8MBInvalidByteCount
+    };
+
+    const Stats& getStats() const { return _stats; }
+    void clearStats();
+    uint8_t getSlave() const { return _u8MBSlave; }
+    
     uint16_t getResponseBuffer(uint8_t);
     void     clearResponseBuffer();
     uint8_t  setTransmitBuffer(uint8_t, uint16_t);
@@ -206,6 +266,9 @@ class ModbusMaster
     uint8_t  readCoils(uint16_t, uint16_t);
     uint8_t  readDiscreteInputs(uint16_t, uint16_t);
     uint8_t  readHoldingRegisters(uint16_t, uint16_t);
+    uint8_t  startReadHoldingRegisters(uint16_t, uint16_t);
+    uint8_t  pollTransaction();
+    uint8_t  startWriteSingleRegister(uint16_t, uint16_t);
     uint8_t  readInputRegisters(uint16_t, uint8_t);
     uint8_t  writeSingleCoil(uint16_t, uint8_t);
     uint8_t  writeSingleRegister(uint16_t, uint16_t);
@@ -220,7 +283,7 @@ class ModbusMaster
   private:
     Stream* _serial;                                             ///< reference to serial port object
     uint8_t  _u8MBSlave;                                         ///< Modbus slave (1..255) initialized in begin()
-    static const uint8_t ku8MaxBufferSize                = 64;   ///< size of response/transmit buffers    
+    static const uint8_t ku8MaxBufferSize                = MODBUS_BUFFER_WORDS; ///< size of response/transmit buffers
     uint16_t _u16ReadAddress;                                    ///< slave register from which to read
     uint16_t _u16ReadQty;                                        ///< quantity of words to read
     uint16_t _u16ResponseBuffer[ku8MaxBufferSize];               ///< buffer to store Modbus slave response; read via GetResponseBuffer()
@@ -234,6 +297,14 @@ class ModbusMaster
     uint8_t _u8ResponseBufferIndex;
     uint8_t _u8ResponseBufferLength;
     
+    // state of the in-flight transaction (non-blocking API)
+    uint8_t  _u8ModbusADU[MODBUS_ADU_BYTES];                     ///< request/response ADU; frameFits() keeps both within it
+    uint8_t  _u8ModbusADUSize;                                   ///< bytes received so far
+    uint8_t  _u8BytesLeft;                                       ///< bytes still expected
+    uint8_t  _u8MBFunction;                                      ///< function of the in-flight request; 0 when idle
+    uint32_t _u32StartTime;                                      ///< millis() when the request finished transmitting
+    Stats    _stats;                                             ///< transaction counters
+    
     // Modbus function codes for bit access
     static const uint8_t ku8MBReadCoils                  = 0x01; ///< Modbus function 0x01 Read Coils
     static const uint8_t ku8MBReadDiscreteInputs         = 0x02; ///< Modbus function 0x02 Read Discrete Inputs
@@ -253,6 +324,14 @@ class ModbusMaster
     
     // master function that conducts Modbus transactions
     uint8_t ModbusMasterTransaction(uint8_t u8MBFunction);
+    // transmit half of a transaction; returns ku8MBPending
+    uint8_t ModbusMasterSend(uint8_t u8MBFunction);
+    // receive half of a transaction; returns ku8MBPending until complete
+    uint8_t ModbusMasterReceive();
+    // data bytes a read response must carry
+    uint16_t readByteCount(uint8_t u8MBFunction) const;
+    // whether the request and its response fit the ADU and word buffers
+    bool frameFits(uint8_t u8MBFunction) const;
     
     // idle callback function; gets called during idle time between TX and RX
     void (*_idle)();
@@ -0,0 +1,117 @@
+#ifndef NATIVE_HAL_ARDUINO_H
+#define NATIVE_HAL_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the subset of the Arduino AVR core the firmware uses.
+ * @details Only selected by [env:native]. Time comes from the virtual clock
+ *          in native_hal.h, so millis(), micros() and delay() never touch the
+ *          host clock and a run is repeatable to the cycle. millis() and
+ *          micros() return uint32_t: unsigned long is 64 bits on LP64 hosts
+ *          and the firmware relies on 32-bit wrap-around. Note that int is
+ *          32 bits here, not 16.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define DEC 10
+#define HEX 16
+
+#define SERIAL_TX_BUFFER_SIZE 64
+#define SERIAL_RX_BUFFER_SIZE 64
+
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+inline uint16_t word(uint16_t w) noexcept { return w; }
+inline uint16_t word(uint8_t h, uint8_t l) noexcept { return static_cast<uint16_t>((h << 8) | l); }
+
+void init() noexcept;
+
+void pinMode(uint8_t pin, uint8_t mode) noexcept;
+void digitalWrite(uint8_t pin, uint8_t val) noexcept;
+int digitalRead(uint8_t pin) noexcept;
+/// Duty 0 and 255 drive the pin low/high; others are recorded for hal::pwmDuty().
+void analogWrite(uint8_t pin, int val) noexcept;
+
+uint32_t millis() noexcept;
+uint32_t micros() noexcept;
+void delay(unsigned long ms) noexcept;
+void delayMicroseconds(unsigned int us) noexcept;
+
+/// avr-libc stdlib.h extension: formats @p val into @p s.
+char* dtostrf(double val, signed char width, unsigned char prec, char* s) noexcept;
+
+/**
+ * @class Print
+ * @brief Byte sink with the Arduino print()/println() helpers.
+ */
+class Print {
+public:
+    virtual ~Print() = default;
+
+    virtual size_t write(uint8_t b) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* str) { return (str == nullptr) ? 0U : write(reinterpret_cast<const uint8_t*>(str), strlen(str)); }
+    size_t write(const char* buffer, size_t size) { return write(reinterpret_cast<const uint8_t*>(buffer), size); }
+
+    /// Bytes that can be written without blocking; 0 if unknown.
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char* str);
+    size_t print(char c);
+    size_t print(unsigned char n, int base = DEC);
+    size_t print(int n, int base = DEC);
+    size_t print(unsigned int n, int base = DEC);
+    size_t print(long n, int base = DEC);
+    size_t print(unsigned long n, int base = DEC);
+    size_t print(double n, int digits = 2);
+
+    size_t println();
+    size_t println(const char* str);
+    size_t println(char c);
+    size_t println(unsigned char n, int base = DEC);
+    size_t println(int n, int base = DEC);
+    size_t println(unsigned int n, int base = DEC);
+    size_t println(long n, int base = DEC);
+    size_t println(unsigned long n, int base = DEC);
+    size_t println(double n, int digits = 2);
+};
+
+/**
+ * @class Stream
+ * @brief Print plus a byte source.
+ */
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+};
+
+#include "native_hal.h"
+
+#endif // NATIVE_HAL_ARDUINO_H
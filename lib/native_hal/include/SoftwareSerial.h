@@ -0,0 +1,37 @@
+#ifndef NATIVE_HAL_SOFTWARESERIAL_H
+#define NATIVE_HAL_SOFTWARESERIAL_H
+
+/**
+ * @file SoftwareSerial.h
+ * @brief Bit-banged port: unbuffered transmit, 64-byte receive buffer.
+ * @details write() keeps interrupts off for the whole character, as the AVR
+ *          library does, so Timer1 interrupts falling inside it are delayed
+ *          until the byte is out. Only one instance listens at a time; the
+ *          others report nothing available until they listen().
+ */
+
+#include <Arduino.h>
+
+class SoftwareSerial : public hal::FakeStream {
+public:
+    SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverse_logic = false) noexcept;
+    ~SoftwareSerial() override;
+
+    void begin(long speed) noexcept;
+    bool listen() noexcept;
+    bool isListening() const noexcept { return active == this; }
+    bool stopListening() noexcept;
+    /// True (once) if received bytes were lost since the last call.
+    bool overflow() noexcept;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+
+private:
+    static SoftwareSerial* active;  ///< The listening instance.
+
+    uint32_t reportedOverflows;     ///< rxOverflows() at the last overflow() call.
+};
+
+#endif // NATIVE_HAL_SOFTWARESERIAL_H
@@ -0,0 +1,26 @@
+#ifndef NATIVE_HAL_AVR_EEPROM_H
+#define NATIVE_HAL_AVR_EEPROM_H
+
+/**
+ * @file avr/eeprom.h
+ * @brief 1 KiB EEPROM with the ATmega328P write timing.
+ * @details Each programmed byte keeps the EEPROM busy for
+ *          hal::EEPROM_WRITE_US of virtual time: eeprom_is_ready() reports
+ *          it and the write/update functions wait (advance the clock) for a
+ *          previous write like avr-libc does. Updates of an unchanged byte
+ *          cost nothing. Addresses wrap at E2END.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+uint8_t eeprom_read_byte(const uint8_t* addr) noexcept;
+void eeprom_write_byte(uint8_t* addr, uint8_t value) noexcept;
+void eeprom_update_byte(uint8_t* addr, uint8_t value) noexcept;
+void eeprom_read_block(void* dst, const void* src, size_t n) noexcept;
+void eeprom_write_block(const void* src, void* dst, size_t n) noexcept;
+void eeprom_update_block(const void* src, void* dst, size_t n) noexcept;
+bool eeprom_is_ready() noexcept;
+void eeprom_busy_wait() noexcept;
+
+#endif // NATIVE_HAL_AVR_EEPROM_H
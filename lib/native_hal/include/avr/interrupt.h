@@ -0,0 +1,25 @@
+#ifndef NATIVE_HAL_AVR_INTERRUPT_H
+#define NATIVE_HAL_AVR_INTERRUPT_H
+
+/**
+ * @file avr/interrupt.h
+ * @brief sei()/cli() on the modelled SREG.I and the ISR() definition macro.
+ * @details sei() runs interrupts that became pending while they were
+ *          disabled, highest priority first, just like the one instruction
+ *          after SEI on the target. A vector runs with SREG.I cleared and
+ *          restores it on return (RETI).
+ */
+
+#include <avr/io.h>
+
+extern "C" {
+void hal_sei(void);
+void hal_cli(void);
+}
+
+#define sei() hal_sei()
+#define cli() hal_cli()
+
+#define ISR(vector, ...) extern "C" void vector(void)
+
+#endif // NATIVE_HAL_AVR_INTERRUPT_H
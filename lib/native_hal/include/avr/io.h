@@ -0,0 +1,106 @@
+#ifndef NATIVE_HAL_AVR_IO_H
+#define NATIVE_HAL_AVR_IO_H
+
+/**
+ * @file avr/io.h
+ * @brief ATmega328P registers used by the firmware, as host variables.
+ * @details Plain bytes, except TIFR1 whose flags are cleared by writing one
+ *          (TIFR1 |= x therefore does not compile, which is the point).
+ *          Timer1 is modelled in normal mode only: TCNT1 counts with the
+ *          prescaler selected in TCCR1B, sets OCF1A on compare match and TOV1
+ *          on overflow, and runs the vectors below when enabled in TIMSK1 and
+ *          SREG.I is set. PINx is refreshed from PORTx/DDRx and the levels set
+ *          by hal::setInput() whenever the clock advances or a pin function
+ *          runs; writing 1 to PINx does not toggle PORTx.
+ */
+
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#define _BV(bit) (1U << (bit))
+
+#define E2END 0x3FF
+#define RAMEND 0x8FF
+
+namespace hal {
+
+/**
+ * @class FlagRegister
+ * @brief Interrupt flag register: reads as the flags, writing 1 clears a flag.
+ */
+class FlagRegister {
+public:
+    FlagRegister() noexcept : flags(0U) {}
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    FlagRegister(const FlagRegister&) = delete;
+    FlagRegister& operator=(const FlagRegister&) = delete;
+    ~FlagRegister() = default;
+
+    FlagRegister& operator=(unsigned int ones) noexcept {
+        flags = static_cast<uint8_t>(flags & ~ones);
+        return *this;
+    }
+    operator uint8_t() const noexcept { return flags; }
+
+    /// Hardware side: sets @p bits.
+    void raise(uint8_t bits) noexcept { flags = static_cast<uint8_t>(flags | bits); }
+
+private:
+    // JSF AV C++ Rule 23: All data members shall be private.
+    uint8_t flags; ///< Pending interrupt flags.
+};
+
+} // namespace hal
+
+extern volatile uint8_t SREG;
+
+extern volatile uint8_t PINB;
+extern volatile uint8_t DDRB;
+extern volatile uint8_t PORTB;
+extern volatile uint8_t PINC;
+extern volatile uint8_t DDRC;
+extern volatile uint8_t PORTC;
+extern volatile uint8_t PIND;
+extern volatile uint8_t DDRD;
+extern volatile uint8_t PORTD;
+
+extern volatile uint8_t TCCR1A;
+extern volatile uint8_t TCCR1B;
+extern volatile uint8_t TIMSK1;
+extern hal::FlagRegister TIFR1;
+extern volatile uint8_t TCNT1L;
+extern volatile uint8_t TCNT1H;
+extern volatile uint8_t OCR1AL;
+extern volatile uint8_t OCR1AH;
+
+// SREG
+#define SREG_I 7
+
+// TCCR1A
+#define WGM10 0
+#define WGM11 1
+
+// TCCR1B
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define WGM12 3
+#define WGM13 4
+
+// TIMSK1
+#define TOIE1 0
+#define OCIE1A 1
+
+// TIFR1
+#define TOV1 0
+#define OCF1A 1
+
+// Interrupt vectors: ISR(TIMER1_COMPA_vect) defines the C function below.
+#define TIMER1_COMPA_vect hal_vector_timer1_compa
+#define TIMER1_OVF_vect hal_vector_timer1_ovf
+
+#endif // NATIVE_HAL_AVR_IO_H
@@ -0,0 +1,30 @@
+#ifndef NATIVE_HAL_AVR_PGMSPACE_H
+#define NATIVE_HAL_AVR_PGMSPACE_H
+
+/**
+ * @file avr/pgmspace.h
+ * @brief Flash access on a host: one address space, so PROGMEM is a no-op.
+ * @details pgm_read_*() still go through the pointer they are given, so a
+ *          table read with the wrong accessor misbehaves the same way on the
+ *          host as it would on the target.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t*>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t*>(addr))
+#define pgm_read_dword(addr) (*reinterpret_cast<const uint32_t*>(addr))
+#define pgm_read_ptr(addr) (*reinterpret_cast<void* const*>(addr))
+
+#define memcpy_P memcpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+#define strncmp_P strncmp
+#define strcpy_P strcpy
+
+#endif // NATIVE_HAL_AVR_PGMSPACE_H
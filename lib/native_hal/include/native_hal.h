@@ -0,0 +1,209 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <Arduino.h>
+#include <deque>
+#include <vector>
+
+/**
+ * @file native_hal.h
+ * @brief Test and benchmark controls behind the host Arduino shims.
+ * @details Time is a 64-bit count of F_CPU cycles that only moves when
+ *          something spends it: delay(), a blocking serial write or flush, an
+ *          EEPROM write, a poll of an empty serial port, or the harness
+ *          itself through advance*(). Every advance steps Timer1 event by
+ *          event, so the timebase and scheduler ISRs run at the same virtual
+ *          instants as on the target, nested inside whatever code was
+ *          spending the time, and only while SREG.I is set.
+ *
+ *          Serial ports are FakeStreams: received bytes are scheduled at wire
+ *          speed for the configured baud rate, transmitted bytes are captured
+ *          and occupy the wire for one character time each. A SerialPeer
+ *          attached to a port sees every transmitted byte and can schedule a
+ *          reply, which is how a slave is simulated on the RS485 link.
+ *
+ * @code
+ * hal::reset();
+ * sei();
+ * timebase_init(scheduler::TASK_TICKS_GCD_IN_MS * 1000UL);
+ * hal::advanceMicros(1000000UL);   // Ten scheduler ticks run
+ * @endcode
+ */
+namespace hal {
+
+constexpr uint32_t CYCLES_PER_US = static_cast<uint32_t>(F_CPU / 1000000UL);
+
+/// EEPROM programming time per byte (erase + write, ATmega328P datasheet).
+constexpr uint32_t EEPROM_WRITE_US = 3400UL;
+constexpr uint16_t EEPROM_BYTES = E2END + 1U;
+
+/// Default cost of polling a serial port that has nothing to read.
+constexpr uint32_t DEFAULT_POLL_CYCLES = 16UL;
+
+/**
+ * @brief Returns the machine to its reset state.
+ * @details Clock at cycle 0, registers cleared (interrupts disabled), EEPROM
+ *          erased to 0xFF, no external pin levels. Serial ports keep their
+ *          state; call FakeStream::end() on the ones a test reuses.
+ */
+void reset() noexcept;
+
+uint64_t cycles() noexcept;
+uint64_t micros64() noexcept;
+
+/**
+ * @brief Moves the clock to @p target, running Timer1 and its ISRs on the way.
+ * @details May be called from an ISR (nested advance); a target in the past
+ *          is a no-op.
+ */
+void advanceTo(uint64_t target) noexcept;
+void advanceCycles(uint64_t count) noexcept;
+void advanceMicros(uint32_t us) noexcept;
+
+/**
+ * @brief Lets the clock follow the host's monotonic clock from now on.
+ * @details Reads of the time catch up with real time (running Timer1 on the
+ *          way) and advances sleep until their target, so delay(), millis()
+ *          and timeouts behave as on the target in real time. For host
+ *          programs that talk to real devices (tools/gateway); reset()
+ *          returns to virtual time.
+ */
+void setWallClock(bool enabled) noexcept;
+bool wallClock() noexcept;
+
+/// Cycles charged for each poll of an empty serial port (spin loops progress).
+void setPollCycles(uint32_t count) noexcept;
+uint32_t pollCycles() noexcept;
+
+/// Drives input pin @p pin (Arduino Uno number) to @p level.
+void setInput(uint8_t pin, bool level) noexcept;
+/// Level the firmware drives on @p pin (PORTx bit, whatever the direction).
+bool outputLevel(uint8_t pin) noexcept;
+/// Last analogWrite() value for @p pin (0 if never written).
+uint8_t pwmDuty(uint8_t pin) noexcept;
+/// Recomputes PINx from PORTx, DDRx and the external levels.
+void refreshPins() noexcept;
+
+/// Backing store of the EEPROM (EEPROM_BYTES bytes).
+uint8_t* eeprom() noexcept;
+/// Bytes physically programmed since reset (wear).
+uint32_t eepromWrites() noexcept;
+
+class FakeStream;
+
+/**
+ * @class SerialPeer
+ * @brief The other end of a FakeStream, e.g. a simulated Modbus slave.
+ */
+class SerialPeer {
+public:
+    virtual ~SerialPeer() = default;
+
+    /**
+     * @brief Called for every byte @p port transmits.
+     * @param end_cycle Cycle at which the stop bit of @p value leaves the wire
+     *        (may lie in the future); replies are scheduled relative to it.
+     */
+    virtual void onTransmit(FakeStream& port, uint8_t value, uint64_t end_cycle) = 0;
+};
+
+/**
+ * @class FakeStream
+ * @brief Serial port with wire timing, a bounded RX buffer and TX capture.
+ * @details One character is 10 bit times (8N1). Received bytes become
+ *          readable when their stop bit has arrived; if the RX buffer is full
+ *          at that moment the byte is lost and counted. Transmit is buffered
+ *          up to @c tx_buffer bytes (0: every write blocks for the whole
+ *          character with interrupts disabled, like a bit-banged port).
+ */
+class FakeStream : public Stream {
+public:
+    static constexpr uint8_t RX_BUFFER_BYTES = 64U;
+
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit FakeStream(uint8_t tx_buffer) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    FakeStream(const FakeStream&) = delete;
+    FakeStream& operator=(const FakeStream&) = delete;
+    ~FakeStream() override = default;
+
+    /// Sets the character time; bytes already scheduled keep their timing.
+    void begin(unsigned long baud) noexcept;
+    /// Drops pending RX, captured TX and wire state.
+    void end() noexcept;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t value) override;
+    using Print::write;
+    int availableForWrite() override;
+    void flush() override;
+
+    /**
+     * @brief Schedules @p n bytes to arrive back to back.
+     * @details The first start bit follows the later of now and the end of
+     *          previously scheduled input, plus @p delay_us.
+     */
+    void inject(const uint8_t* data, size_t n, uint32_t delay_us = 0UL) noexcept;
+    /// Schedules @p n bytes whose first start bit begins at @p start_cycle.
+    void injectAt(uint64_t start_cycle, const uint8_t* data, size_t n) noexcept;
+    /// Schedules one byte to finish arriving at @p end_cycle.
+    void injectByte(uint64_t end_cycle, uint8_t value) noexcept;
+
+    const std::vector<uint8_t>& transmitted() const noexcept { return tx; }
+    void clearTransmitted() noexcept { tx.clear(); }
+
+    void setPeer(SerialPeer* next) noexcept { peer = next; }
+    unsigned long baud() const noexcept { return baudRate; }
+    uint32_t byteCycles() const noexcept { return charCycles; }
+    /// Cycle at which the last transmitted byte has left the wire.
+    uint64_t txIdleCycle() const noexcept { return txIdle; }
+    /// Received bytes lost to a full RX buffer since end().
+    uint32_t rxOverflows() const noexcept { return overflows; }
+    /// Bytes scheduled but not yet arrived.
+    size_t rxScheduled() const noexcept { return incoming.size(); }
+
+private:
+    struct Arrival {
+        uint64_t cycle; ///< Stop bit received.
+        uint8_t value;
+    };
+
+    void deliver() noexcept;
+    uint8_t txQueued() const noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    std::deque<Arrival> incoming;  ///< Scheduled input, in arrival order.
+    uint8_t rx[RX_BUFFER_BYTES];   ///< Received, not yet read.
+    uint8_t rxHead;                ///< Index of the oldest received byte.
+    uint8_t rxCount;               ///< Bytes in rx.
+    std::vector<uint8_t> tx;       ///< Everything written since begin()/clear.
+    uint64_t txIdle;               ///< Wire free from this cycle on.
+    uint64_t rxIdle;               ///< End of the last scheduled input byte.
+    SerialPeer* peer;              ///< Notified of every transmitted byte.
+    unsigned long baudRate;        ///< 0 until begin(): transfers take no time.
+    uint32_t charCycles;           ///< Cycles per 10-bit character.
+    uint32_t overflows;            ///< Bytes lost to a full rx.
+    uint8_t txBuffer;              ///< Transmit buffer size in bytes.
+};
+
+} // namespace hal
+
+/**
+ * @class HardwareSerial
+ * @brief USART0 with the core's 64-byte transmit ring.
+ * @details availableForWrite() reports SERIAL_TX_BUFFER_SIZE - 1 when idle,
+ *          the same figure the AVR core gives.
+ */
+class HardwareSerial : public hal::FakeStream {
+public:
+    HardwareSerial() noexcept : hal::FakeStream(SERIAL_TX_BUFFER_SIZE) {}
+    void begin(unsigned long baud, uint8_t = 0U) noexcept { hal::FakeStream::begin(baud); }
+    explicit operator bool() const noexcept { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_HAL_H
@@ -0,0 +1,38 @@
+#ifndef NATIVE_HAL_UTIL_ATOMIC_H
+#define NATIVE_HAL_UTIL_ATOMIC_H
+
+/**
+ * @file util/atomic.h
+ * @brief avr-libc ATOMIC_BLOCK on the modelled SREG.
+ * @details Same construction as avr-libc: a for-statement whose declaration
+ *          saves SREG and is restored by a cleanup handler on every exit path,
+ *          including return and break. Restoring SREG.I runs any interrupt
+ *          that became pending inside the block.
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static inline uint8_t hal_atomic_cli(void) {
+    cli();
+    return 1U;
+}
+
+static inline void hal_atomic_restore(const uint8_t* saved) {
+    if ((*saved & _BV(SREG_I)) != 0U) {
+        sei();
+    } else {
+        cli();
+    }
+}
+
+static inline void hal_atomic_force_on(const uint8_t*) {
+    sei();
+}
+
+#define ATOMIC_BLOCK(type) for (type, hal_atomic_todo = hal_atomic_cli(); hal_atomic_todo != 0U; hal_atomic_todo = 0U)
+
+#define ATOMIC_RESTORESTATE uint8_t hal_sreg_save __attribute__((__cleanup__(hal_atomic_restore))) = SREG
+#define ATOMIC_FORCEON uint8_t hal_sreg_save __attribute__((__cleanup__(hal_atomic_force_on))) = 0U
+
+#endif // NATIVE_HAL_UTIL_ATOMIC_H
@@ -0,0 +1,218 @@
+#include <Arduino.h>
+#include <time.h>
+#include "native_hal.h"
+#include "native_internal.h"
+
+volatile uint8_t SREG = 0U;
+volatile uint8_t TCCR1A = 0U;
+volatile uint8_t TCCR1B = 0U;
+volatile uint8_t TIMSK1 = 0U;
+hal::FlagRegister TIFR1;
+volatile uint8_t TCNT1L = 0U;
+volatile uint8_t TCNT1H = 0U;
+volatile uint8_t OCR1AL = 0U;
+volatile uint8_t OCR1AH = 0U;
+
+// Defined by ISR(TIMER1_*_vect) in the firmware; null when not linked in.
+extern "C" void hal_vector_timer1_compa(void) __attribute__((weak));
+extern "C" void hal_vector_timer1_ovf(void) __attribute__((weak));
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint8_t SREG_I_MASK = _BV(SREG_I);
+constexpr uint8_t CS_MASK = _BV(CS12) | _BV(CS11) | _BV(CS10);
+constexpr uint32_t TIMER1_STEPS = 65536UL;
+
+/// Timer1 clock divider per CS12:CS10 value; 0 = stopped (or external clock).
+constexpr uint16_t PRESCALE[8] = { 0U, 1U, 8U, 64U, 256U, 1024U, 0U, 0U };
+
+uint64_t g_now = 0U;           ///< Virtual time in CPU cycles.
+uint32_t g_phase = 0UL;        ///< CPU cycles since the last Timer1 count.
+uint32_t g_pollCycles = hal::DEFAULT_POLL_CYCLES;
+bool g_wallClock = false;
+uint64_t g_wallEpochNs = 0U;   ///< Monotonic time at which g_now was 0.
+
+uint64_t monotonicNs() noexcept {
+    timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL) + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t wallCycles() noexcept {
+    return ((monotonicNs() - g_wallEpochNs) * hal::CYCLES_PER_US) / 1000ULL;
+}
+
+/// In wall-clock mode, brings virtual time up to real time.
+void catchUp() noexcept {
+    if (g_wallClock) {
+        hal::advanceTo(wallCycles());
+    }
+}
+
+uint16_t read16(volatile uint8_t& high, volatile uint8_t& low) noexcept {
+    return static_cast<uint16_t>((static_cast<uint16_t>(high) << 8) | low);
+}
+
+void write16(volatile uint8_t& high, volatile uint8_t& low, uint16_t value) noexcept {
+    high = static_cast<uint8_t>(value >> 8);
+    low = static_cast<uint8_t>(value & 0xFFU);
+}
+
+/**
+ * @brief Runs pending, enabled interrupts while SREG.I is set.
+ * @details Vector order of the ATmega328P: TIMER1_COMPA before TIMER1_OVF.
+ *          Entering a vector clears its flag and SREG.I; returning sets I.
+ */
+void dispatch() noexcept {
+    while ((SREG & SREG_I_MASK) != 0U) {
+        const uint8_t pending = static_cast<uint8_t>(TIFR1 & TIMSK1 & (_BV(OCF1A) | _BV(TOV1)));
+        void (*vector)(void) = nullptr;
+        if ((pending & _BV(OCF1A)) != 0U) {
+            TIFR1 = _BV(OCF1A);
+            vector = hal_vector_timer1_compa;
+        } else if ((pending & _BV(TOV1)) != 0U) {
+            TIFR1 = _BV(TOV1);
+            vector = hal_vector_timer1_ovf;
+        } else {
+            break;
+        }
+        if (vector != nullptr) {
+            SREG = static_cast<uint8_t>(SREG & ~SREG_I_MASK);
+            vector();
+            SREG = static_cast<uint8_t>(SREG | SREG_I_MASK);
+        }
+    }
+}
+
+} // anonymous namespace
+
+extern "C" void hal_sei(void) {
+    SREG = static_cast<uint8_t>(SREG | SREG_I_MASK);
+    dispatch();
+}
+
+extern "C" void hal_cli(void) {
+    SREG = static_cast<uint8_t>(SREG & ~SREG_I_MASK);
+}
+
+namespace hal {
+
+void reset() noexcept {
+    g_now = 0U;
+    g_phase = 0UL;
+    g_pollCycles = DEFAULT_POLL_CYCLES;
+    g_wallClock = false;
+    SREG = 0U;
+    TCCR1A = 0U;
+    TCCR1B = 0U;
+    TIMSK1 = 0U;
+    TIFR1 = 0xFFU;
+    write16(TCNT1H, TCNT1L, 0U);
+    write16(OCR1AH, OCR1AL, 0U);
+    resetIo();
+}
+
+uint64_t cycles() noexcept {
+    catchUp();
+    return g_now;
+}
+
+uint64_t micros64() noexcept {
+    catchUp();
+    return g_now / CYCLES_PER_US;
+}
+
+void advanceTo(uint64_t target) noexcept {
+    if (g_wallClock) {
+        const uint64_t real = wallCycles();
+        if (real < target) {
+            const uint64_t ns = ((target - real) * 1000ULL) / CYCLES_PER_US;
+            const timespec pause = { static_cast<time_t>(ns / 1000000000ULL), static_cast<long>(ns % 1000000000ULL) };
+            (void)nanosleep(&pause, nullptr);
+        }
+    }
+    // Re-read all timer state every step: an ISR run below may have spent
+    // time itself (nested advance) or reprogrammed the timer.
+    while (g_now < target) {
+        const uint16_t prescale = PRESCALE[TCCR1B & CS_MASK];
+        if (prescale == 0U) {
+            g_now = target;
+            break;
+        }
+        uint16_t count = read16(TCNT1H, TCNT1L);
+        const uint16_t compare = read16(OCR1AH, OCR1AL);
+        const uint32_t toCompare = (compare != count) ? static_cast<uint16_t>(compare - count) : TIMER1_STEPS;
+        const uint32_t toOverflow = TIMER1_STEPS - count;
+        const uint32_t steps = (toCompare < toOverflow) ? toCompare : toOverflow;
+        const uint64_t eventAt = g_now + (static_cast<uint64_t>(steps) * prescale) - g_phase;
+
+        if (eventAt > target) {
+            const uint64_t span = (target - g_now) + g_phase;
+            count = static_cast<uint16_t>(count + (span / prescale));
+            g_phase = static_cast<uint32_t>(span % prescale);
+            write16(TCNT1H, TCNT1L, count);
+            g_now = target;
+        } else {
+            count = static_cast<uint16_t>(count + steps);
+            g_phase = 0UL;
+            write16(TCNT1H, TCNT1L, count);
+            g_now = eventAt;
+            TIFR1.raise(static_cast<uint8_t>(((count == compare) ? _BV(OCF1A) : 0U) |
+                                             ((count == 0U) ? _BV(TOV1) : 0U)));
+            refreshPins();
+            dispatch();
+        }
+    }
+    refreshPins();
+}
+
+void advanceCycles(uint64_t count) noexcept {
+    advanceTo(g_now + count);
+}
+
+void advanceMicros(uint32_t us) noexcept {
+    advanceCycles(static_cast<uint64_t>(us) * CYCLES_PER_US);
+}
+
+void setPollCycles(uint32_t count) noexcept {
+    g_pollCycles = count;
+}
+
+uint32_t pollCycles() noexcept {
+    return g_pollCycles;
+}
+
+void setWallClock(bool enabled) noexcept {
+    catchUp();
+    g_wallClock = enabled;
+    g_wallEpochNs = monotonicNs() - ((g_now * 1000ULL) / CYCLES_PER_US);
+}
+
+bool wallClock() noexcept {
+    return g_wallClock;
+}
+
+} // namespace hal
+
+void init() noexcept {
+    sei();
+}
+
+uint32_t millis() noexcept {
+    catchUp();
+    return static_cast<uint32_t>(g_now / (F_CPU / 1000UL));
+}
+
+uint32_t micros() noexcept {
+    catchUp();
+    return static_cast<uint32_t>(g_now / hal::CYCLES_PER_US);
+}
+
+void delay(unsigned long ms) noexcept {
+    hal::advanceCycles(static_cast<uint64_t>(ms) * (F_CPU / 1000UL));
+}
+
+void delayMicroseconds(unsigned int us) noexcept {
+    hal::advanceMicros(us);
+}
@@ -0,0 +1,15 @@
+#ifndef NATIVE_INTERNAL_H
+#define NATIVE_INTERNAL_H
+
+/**
+ * @file native_internal.h
+ * @brief Hooks between the native_hal translation units.
+ */
+namespace hal {
+
+/// Clears ports, external pin levels and the EEPROM (part of reset()).
+void resetIo() noexcept;
+
+} // namespace hal
+
+#endif // NATIVE_INTERNAL_H
@@ -0,0 +1,272 @@
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include "native_hal.h"
+#include "native_internal.h"
+
+volatile uint8_t PINB = 0U;
+volatile uint8_t DDRB = 0U;
+volatile uint8_t PORTB = 0U;
+volatile uint8_t PINC = 0U;
+volatile uint8_t DDRC = 0U;
+volatile uint8_t PORTC = 0U;
+volatile uint8_t PIND = 0U;
+volatile uint8_t DDRD = 0U;
+volatile uint8_t PORTD = 0U;
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint8_t UNO_PINS = 20U;
+constexpr uint8_t PORT_COUNT = 3U;
+
+struct PortRegisters {
+    volatile uint8_t& pin;
+    volatile uint8_t& ddr;
+    volatile uint8_t& port;
+};
+
+// Indexed by portIndex(): B, C, D.
+PortRegisters PORTS[PORT_COUNT] = {
+    { PINB, DDRB, PORTB },
+    { PINC, DDRC, PORTC },
+    { PIND, DDRD, PORTD },
+};
+
+uint8_t g_driven[PORT_COUNT];    ///< Input bits with an external level.
+uint8_t g_external[PORT_COUNT];  ///< That level.
+uint8_t g_duty[UNO_PINS];        ///< Last analogWrite() value per pin.
+
+uint8_t g_eeprom[hal::EEPROM_BYTES];
+uint64_t g_eepromReadyAt = 0U;   ///< Cycle at which the current write completes.
+uint32_t g_eepromWrites = 0UL;
+
+/// Uno mapping: D0-D7 -> PORTD, D8-D13 -> PORTB, A0-A5 (14-19) -> PORTC.
+uint8_t portIndex(uint8_t pin) noexcept {
+    return (pin < 8U) ? 2U : ((pin < 14U) ? 0U : 1U);
+}
+
+uint8_t maskOf(uint8_t pin) noexcept {
+    return static_cast<uint8_t>(1U << ((pin < 8U) ? pin : ((pin < 14U) ? (pin - 8U) : (pin - 14U))));
+}
+
+uint16_t eepromIndex(const void* address) noexcept {
+    return static_cast<uint16_t>(reinterpret_cast<uintptr_t>(address) & E2END);
+}
+
+} // anonymous namespace
+
+namespace hal {
+
+void resetIo() noexcept {
+    for (uint8_t i = 0U; i < PORT_COUNT; ++i) {
+        PORTS[i].pin = 0U;
+        PORTS[i].ddr = 0U;
+        PORTS[i].port = 0U;
+        g_driven[i] = 0U;
+        g_external[i] = 0U;
+    }
+    memset(g_duty, 0, sizeof(g_duty));
+    memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+    g_eepromReadyAt = 0U;
+    g_eepromWrites = 0UL;
+}
+
+void refreshPins() noexcept {
+    for (uint8_t i = 0U; i < PORT_COUNT; ++i) {
+        const PortRegisters& r = PORTS[i];
+        const uint8_t ddr = r.ddr;
+        const uint8_t port = r.port;
+        // Outputs read back their PORT bit; undriven inputs their pull-up.
+        const uint8_t inputs = static_cast<uint8_t>((g_external[i] & g_driven[i]) | (port & ~g_driven[i]));
+        r.pin = static_cast<uint8_t>((port & ddr) | (inputs & ~ddr));
+    }
+}
+
+void setInput(uint8_t pin, bool level) noexcept {
+    if (pin >= UNO_PINS) {
+        return;
+    }
+    const uint8_t i = portIndex(pin);
+    const uint8_t mask = maskOf(pin);
+    g_driven[i] = static_cast<uint8_t>(g_driven[i] | mask);
+    g_external[i] = static_cast<uint8_t>(level ? (g_external[i] | mask) : (g_external[i] & ~mask));
+    refreshPins();
+}
+
+bool outputLevel(uint8_t pin) noexcept {
+    return (pin < UNO_PINS) && ((PORTS[portIndex(pin)].port & maskOf(pin)) != 0U);
+}
+
+uint8_t pwmDuty(uint8_t pin) noexcept {
+    return (pin < UNO_PINS) ? g_duty[pin] : 0U;
+}
+
+uint8_t* eeprom() noexcept {
+    return g_eeprom;
+}
+
+uint32_t eepromWrites() noexcept {
+    return g_eepromWrites;
+}
+
+} // namespace hal
+
+void pinMode(uint8_t pin, uint8_t mode) noexcept {
+    if (pin >= UNO_PINS) {
+        return;
+    }
+    const PortRegisters& r = PORTS[portIndex(pin)];
+    const uint8_t mask = maskOf(pin);
+    if (mode == OUTPUT) {
+        r.ddr = static_cast<uint8_t>(r.ddr | mask);
+    } else {
+        r.ddr = static_cast<uint8_t>(r.ddr & ~mask);
+        r.port = static_cast<uint8_t>((mode == INPUT_PULLUP) ? (r.port | mask) : (r.port & ~mask));
+    }
+    hal::refreshPins();
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) noexcept {
+    if (pin >= UNO_PINS) {
+        return;
+    }
+    const PortRegisters& r = PORTS[portIndex(pin)];
+    const uint8_t mask = maskOf(pin);
+    r.port = static_cast<uint8_t>((val != LOW) ? (r.port | mask) : (r.port & ~mask));
+    hal::refreshPins();
+}
+
+int digitalRead(uint8_t pin) noexcept {
+    if (pin >= UNO_PINS) {
+        return LOW;
+    }
+    hal::refreshPins();
+    return ((PORTS[portIndex(pin)].pin & maskOf(pin)) != 0U) ? HIGH : LOW;
+}
+
+void analogWrite(uint8_t pin, int val) noexcept {
+    if (pin >= UNO_PINS) {
+        return;
+    }
+    const uint8_t duty = static_cast<uint8_t>((val < 0) ? 0 : ((val > 255) ? 255 : val));
+    g_duty[pin] = duty;
+    pinMode(pin, OUTPUT);
+    // The level of a PWM pin is not modelled; it reads high from the first edge.
+    digitalWrite(pin, (duty != 0U) ? HIGH : LOW);
+}
+
+char* dtostrf(double val, signed char width, unsigned char prec, char* s) noexcept {
+    (void)sprintf(s, "%*.*f", width, prec, val);
+    return s;
+}
+
+// EEPROM: every access waits for a write in progress, like avr-libc.
+
+bool eeprom_is_ready() noexcept {
+    return hal::cycles() >= g_eepromReadyAt;
+}
+
+void eeprom_busy_wait() noexcept {
+    hal::advanceTo(g_eepromReadyAt);
+}
+
+uint8_t eeprom_read_byte(const uint8_t* addr) noexcept {
+    eeprom_busy_wait();
+    return g_eeprom[eepromIndex(addr)];
+}
+
+void eeprom_write_byte(uint8_t* addr, uint8_t value) noexcept {
+    eeprom_busy_wait();
+    g_eeprom[eepromIndex(addr)] = value;
+    g_eepromReadyAt = hal::cycles() + (static_cast<uint64_t>(hal::EEPROM_WRITE_US) * hal::CYCLES_PER_US);
+    ++g_eepromWrites;
+}
+
+void eeprom_update_byte(uint8_t* addr, uint8_t value) noexcept {
+    if (eeprom_read_byte(addr) != value) {
+        eeprom_write_byte(addr, value);
+    }
+}
+
+void eeprom_read_block(void* dst, const void* src, size_t n) noexcept {
+    eeprom_busy_wait();
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    const uintptr_t base = reinterpret_cast<uintptr_t>(src);
+    for (size_t i = 0U; i < n; ++i) {
+        out[i] = g_eeprom[eepromIndex(reinterpret_cast<const void*>(base + i))];
+    }
+}
+
+void eeprom_write_block(const void* src, void* dst, size_t n) noexcept {
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    const uintptr_t base = reinterpret_cast<uintptr_t>(dst);
+    for (size_t i = 0U; i < n; ++i) {
+        eeprom_write_byte(reinterpret_cast<uint8_t*>(base + i), in[i]);
+    }
+}
+
+void eeprom_update_block(const void* src, void* dst, size_t n) noexcept {
+    const uint8_t* in = static_cast<const uint8_t*>(src);
+    const uintptr_t base = reinterpret_cast<uintptr_t>(dst);
+    for (size_t i = 0U; i < n; ++i) {
+        eeprom_update_byte(reinterpret_cast<uint8_t*>(base + i), in[i]);
+    }
+}
+
+// Print: number formatting as in the Arduino core.
+
+namespace {
+
+size_t printNumber(Print& out, unsigned long n, int base) {
+    char buf[8U * sizeof(long) + 1U];
+    char* p = &buf[sizeof(buf) - 1U];
+    *p = '\0';
+    const unsigned long radix = (base < 2) ? 10UL : static_cast<unsigned long>(base);
+    do {
+        const unsigned long digit = n % radix;
+        n /= radix;
+        *--p = static_cast<char>((digit < 10UL) ? ('0' + digit) : ('A' + digit - 10UL));
+    } while (n != 0UL);
+    return out.write(p);
+}
+
+size_t printSigned(Print& out, long n, int base) {
+    if ((base == DEC) && (n < 0L)) {
+        return out.print('-') + printNumber(out, 0UL - static_cast<unsigned long>(n), DEC);
+    }
+    return printNumber(out, static_cast<unsigned long>(n), base);
+}
+
+} // anonymous namespace
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0U;
+    while ((n < size) && (write(buffer[n]) != 0U)) {
+        ++n;
+    }
+    return n;
+}
+
+size_t Print::print(const char* str) { return write(str); }
+size_t Print::print(char c) { return write(static_cast<uint8_t>(c)); }
+size_t Print::print(unsigned char n, int base) { return printNumber(*this, n, base); }
+size_t Print::print(int n, int base) { return printSigned(*this, n, base); }
+size_t Print::print(unsigned int n, int base) { return printNumber(*this, n, base); }
+size_t Print::print(long n, int base) { return printSigned(*this, n, base); }
+size_t Print::print(unsigned long n, int base) { return printNumber(*this, n, base); }
+
+size_t Print::print(double n, int digits) {
+    char buf[32];
+    const int len = snprintf(buf, sizeof(buf), "%.*f", digits, n);
+    return write(buf, (len < 0) ? 0U : static_cast<size_t>(len));
+}
+
+size_t Print::println() { return write("\r\n"); }
+size_t Print::println(const char* str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(unsigned char n, int base) { return print(n, base) + println(); }
+size_t Print::println(int n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned int n, int base) { return print(n, base) + println(); }
+size_t Print::println(long n, int base) { return print(n, base) + println(); }
+size_t Print::println(unsigned long n, int base) { return print(n, base) + println(); }
+size_t Print::println(double n, int digits) { return print(n, digits) + println(); }
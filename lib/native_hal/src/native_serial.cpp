@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "native_hal.h"
+
+HardwareSerial Serial;
+
+namespace hal {
+
+constexpr uint8_t FakeStream::RX_BUFFER_BYTES;
+
+FakeStream::FakeStream(uint8_t tx_buffer) noexcept
+    : incoming(), rx(), rxHead(0U), rxCount(0U), tx(), txIdle(0U), rxIdle(0U), peer(nullptr),
+      baudRate(0UL), charCycles(0UL), overflows(0UL), txBuffer(tx_buffer) {}
+
+void FakeStream::begin(unsigned long baud) noexcept {
+    baudRate = baud;
+    // 8N1: start bit, eight data bits, stop bit.
+    charCycles = (baud != 0UL) ? static_cast<uint32_t>(((10ULL * F_CPU) + (baud / 2UL)) / baud) : 0UL;
+}
+
+void FakeStream::end() noexcept {
+    incoming.clear();
+    rxHead = 0U;
+    rxCount = 0U;
+    tx.clear();
+    txIdle = 0U;
+    rxIdle = 0U;
+    overflows = 0UL;
+}
+
+void FakeStream::deliver() noexcept {
+    const uint64_t now = cycles();
+    while (!incoming.empty() && (incoming.front().cycle <= now)) {
+        if (rxCount < RX_BUFFER_BYTES) {
+            rx[(rxHead + rxCount) % RX_BUFFER_BYTES] = incoming.front().value;
+            ++rxCount;
+        } else {
+            ++overflows;
+        }
+        incoming.pop_front();
+    }
+}
+
+int FakeStream::available() {
+    deliver();
+    if (rxCount == 0U) {
+        // A spin loop on an idle port must still let time pass.
+        advanceCycles(pollCycles());
+    }
+    return rxCount;
+}
+
+int FakeStream::read() {
+    deliver();
+    if (rxCount == 0U) {
+        return -1;
+    }
+    const uint8_t value = rx[rxHead];
+    rxHead = static_cast<uint8_t>((rxHead + 1U) % RX_BUFFER_BYTES);
+    --rxCount;
+    return value;
+}
+
+int FakeStream::peek() {
+    deliver();
+    return (rxCount == 0U) ? -1 : rx[rxHead];
+}
+
+uint8_t FakeStream::txQueued() const noexcept {
+    const uint64_t now = cycles();
+    if ((charCycles == 0UL) || (txIdle <= now)) {
+        return 0U;
+    }
+    // Characters not fully sent, less the one in the shift register.
+    const uint64_t inFlight = ((txIdle - now) + charCycles - 1U) / charCycles;
+    return static_cast<uint8_t>(inFlight - 1U);
+}
+
+int FakeStream::availableForWrite() {
+    return (txBuffer == 0U) ? 0 : static_cast<int>((txBuffer - 1U) - txQueued());
+}
+
+size_t FakeStream::write(uint8_t value) {
+    tx.push_back(value);
+    if (charCycles == 0UL) {
+        if (peer != nullptr) {
+            peer->onTransmit(*this, value, cycles());
+        }
+        return 1U;
+    }
+
+    if (txBuffer == 0U) {
+        const uint8_t sreg = SREG;
+        cli();
+        const uint64_t end = std::max(cycles(), txIdle) + charCycles;
+        txIdle = end;
+        if (peer != nullptr) {
+            peer->onTransmit(*this, value, end);
+        }
+        advanceTo(end);
+        if ((sreg & _BV(SREG_I)) != 0U) {
+            sei();
+        }
+        return 1U;
+    }
+
+    // Buffer full: wait until the oldest queued character starts.
+    const uint64_t backlog = static_cast<uint64_t>(txBuffer - 1U) * charCycles;
+    if (txIdle > (cycles() + backlog)) {
+        advanceTo(txIdle - backlog);
+    }
+    const uint64_t end = std::max(cycles(), txIdle) + charCycles;
+    txIdle = end;
+    if (peer != nullptr) {
+        peer->onTransmit(*this, value, end);
+    }
+    return 1U;
+}
+
+void FakeStream::flush() {
+    advanceTo(txIdle);
+}
+
+void FakeStream::inject(const uint8_t* data, size_t n, uint32_t delay_us) noexcept {
+    const uint64_t start = std::max(cycles(), rxIdle) + (static_cast<uint64_t>(delay_us) * CYCLES_PER_US);
+    injectAt(start, data, n);
+}
+
+void FakeStream::injectAt(uint64_t start_cycle, const uint8_t* data, size_t n) noexcept {
+    for (size_t i = 0U; i < n; ++i) {
+        injectByte(start_cycle + ((i + 1U) * static_cast<uint64_t>(charCycles)), data[i]);
+    }
+}
+
+void FakeStream::injectByte(uint64_t end_cycle, uint8_t value) noexcept {
+    const Arrival a = { end_cycle, value };
+    const auto later = std::upper_bound(incoming.begin(), incoming.end(), a,
+                                        [](const Arrival& x, const Arrival& y) { return x.cycle < y.cycle; });
+    incoming.insert(later, a);
+    rxIdle = std::max(rxIdle, end_cycle);
+}
+
+} // namespace hal
+
+SoftwareSerial* SoftwareSerial::active = nullptr;
+
+SoftwareSerial::SoftwareSerial(uint8_t, uint8_t, bool) noexcept
+    : hal::FakeStream(0U), reportedOverflows(0UL) {}
+
+SoftwareSerial::~SoftwareSerial() {
+    (void)stopListening();
+}
+
+void SoftwareSerial::begin(long speed) noexcept {
+    hal::FakeStream::begin(static_cast<unsigned long>(speed));
+    (void)listen();
+}
+
+bool SoftwareSerial::listen() noexcept {
+    const bool changed = (active != this);
+    active = this;
+    return changed;
+}
+
+bool SoftwareSerial::stopListening() noexcept {
+    if (active != this) {
+        return false;
+    }
+    active = nullptr;
+    return true;
+}
+
+bool SoftwareSerial::overflow() noexcept {
+    const bool lost = (rxOverflows() != reportedOverflows);
+    reportedOverflows = rxOverflows();
+    return lost;
+}
+
+int SoftwareSerial::available() {
+    return isListening() ? hal::FakeStream::available() : 0;
+}
+
+int SoftwareSerial::read() {
+    return isListening() ? hal::FakeStream::read() : -1;
+}
+
+int SoftwareSerial::peek() {
+    return isListening() ? hal::FakeStream::peek() : -1;
+}
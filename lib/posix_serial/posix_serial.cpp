@@ -0,0 +1,198 @@
+#include "posix_serial.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/serial.h>
+#endif
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+speed_t toSpeed(uint32_t baud) noexcept {
+    switch (baud) {
+        case 1200UL: return B1200;
+        case 2400UL: return B2400;
+        case 4800UL: return B4800;
+        case 9600UL: return B9600;
+        case 19200UL: return B19200;
+        case 38400UL: return B38400;
+        case 57600UL: return B57600;
+        case 115200UL: return B115200;
+        default: return B0;
+    }
+}
+
+/// Hands DE to the kernel; false if the driver has no RS485 mode.
+bool enableKernelRs485(int fd) noexcept {
+#if defined(__linux__) && defined(TIOCSRS485)
+    serial_rs485 conf = {};
+    conf.flags = SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND;
+    return ioctl(fd, TIOCSRS485, &conf) == 0;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+} // anonymous namespace
+
+PosixSerial::PosixSerial() noexcept
+    : rx(), tx(), rxHead(0U), rxTail(0U), txLength(0U), handle(-1), rate(0UL), rs485(false), transmitting(false) {}
+
+PosixSerial::~PosixSerial() {
+    close();
+}
+
+bool PosixSerial::open(const char* path, uint32_t baud) noexcept {
+    close();
+    if (toSpeed(baud) == B0) {
+        errno = EINVAL;
+        return false;
+    }
+    handle = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (handle < 0) {
+        return false;
+    }
+    if (!setBaud(baud)) {
+        const int error = errno;
+        close();
+        errno = error;
+        return false;
+    }
+    rs485 = enableKernelRs485(handle);
+    setTransmit(false);
+    return true;
+}
+
+void PosixSerial::close() noexcept {
+    if (handle >= 0) {
+        (void)::close(handle);
+    }
+    handle = -1;
+    rxHead = 0U;
+    rxTail = 0U;
+    txLength = 0U;
+    rs485 = false;
+    transmitting = false;
+}
+
+bool PosixSerial::setBaud(uint32_t baud) noexcept {
+    const speed_t speed = toSpeed(baud);
+    termios tio;
+    if ((handle < 0) || (speed == B0) || (tcgetattr(handle, &tio) != 0)) {
+        if (speed == B0) {
+            errno = EINVAL;
+        }
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag = static_cast<tcflag_t>((tio.c_cflag & ~(CSTOPB | PARENB | CRTSCTS)) | CLOCAL | CREAD | CS8);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if ((cfsetispeed(&tio, speed) != 0) || (cfsetospeed(&tio, speed) != 0) || (tcsetattr(handle, TCSANOW, &tio) != 0)) {
+        return false;
+    }
+    (void)tcflush(handle, TCIOFLUSH);
+    rate = baud;
+    return true;
+}
+
+void PosixSerial::setTransmit(bool transmit) noexcept {
+    if (rs485 || (handle < 0)) {
+        return;
+    }
+    // Not every device has modem lines (a pty has none); that is fine.
+    int bits = TIOCM_RTS;
+    (void)ioctl(handle, transmit ? TIOCMBIS : TIOCMBIC, &bits);
+    transmitting = transmit;
+}
+
+size_t PosixSerial::write(uint8_t value) {
+    return write(&value, 1U);
+}
+
+size_t PosixSerial::write(const uint8_t* buffer, size_t size) {
+    if (handle < 0) {
+        return 0U;
+    }
+    if (!transmitting && (size != 0U)) {
+        setTransmit(true);
+    }
+    size_t n = 0U;
+    while (n < size) {
+        if ((txLength == TX_BYTES) && !drainTx()) {
+            break;
+        }
+        tx[txLength++] = buffer[n++];
+    }
+    return n;
+}
+
+int PosixSerial::availableForWrite() {
+    return static_cast<int>(TX_BYTES - txLength);
+}
+
+bool PosixSerial::drainTx() noexcept {
+    uint16_t sent = 0U;
+    while (sent < txLength) {
+        const ssize_t n = ::write(handle, &tx[sent], txLength - sent);
+        if (n > 0) {
+            sent = static_cast<uint16_t>(sent + n);
+        } else if ((n < 0) && ((errno == EAGAIN) || (errno == EINTR))) {
+            pollfd pfd = { handle, POLLOUT, 0 };
+            (void)poll(&pfd, 1, -1);
+        } else {
+            txLength = 0U;
+            return false;
+        }
+    }
+    txLength = 0U;
+    return true;
+}
+
+void PosixSerial::flush() {
+    if (handle < 0) {
+        return;
+    }
+    (void)drainTx();
+    (void)tcdrain(handle);
+    if (transmitting) {
+        setTransmit(false);
+    }
+}
+
+uint16_t PosixSerial::fill() noexcept {
+    if (rxHead == rxTail) {
+        rxHead = 0U;
+        rxTail = 0U;
+    }
+    if ((handle >= 0) && (rxTail < RX_BYTES)) {
+        const ssize_t n = ::read(handle, &rx[rxTail], RX_BYTES - rxTail);
+        if (n > 0) {
+            rxTail = static_cast<uint16_t>(rxTail + n);
+        }
+    }
+    return static_cast<uint16_t>(rxTail - rxHead);
+}
+
+int PosixSerial::available() {
+    return fill();
+}
+
+int PosixSerial::read() {
+    if ((rxHead == rxTail) && (fill() == 0U)) {
+        return -1;
+    }
+    return rx[rxHead++];
+}
+
+int PosixSerial::peek() {
+    if ((rxHead == rxTail) && (fill() == 0U)) {
+        return -1;
+    }
+    return rx[rxHead];
+}
@@ -0,0 +1,83 @@
+#ifndef POSIX_SERIAL_H
+#define POSIX_SERIAL_H
+
+#include <Arduino.h>
+#include <stdint.h>
+
+/**
+ * @file posix_serial.h
+ * @brief Arduino Stream on a POSIX serial device, for ModbusMaster on a host.
+ * @details The device is opened non-blocking and set raw 8N1 with termios.
+ *          On Linux the RS485 driver-enable line is handed to the kernel with
+ *          TIOCSRS485 (RTS high while sending), which switches it exactly at
+ *          the end of the last stop bit. Where the driver rejects that (most
+ *          USB adapters with automatic direction, ptys), RTS is raised on the
+ *          first written byte and dropped after flush() has drained the
+ *          output; adapters that switch direction in hardware ignore it.
+ *
+ *          write() only buffers; flush() sends and waits for the line to
+ *          drain, which is what ModbusMaster does after every request.
+ *          available() reads whatever the driver has without blocking, so
+ *          callers wait for input on fd() with epoll/poll rather than spin.
+ *          Combine with hal::setWallClock(true) so millis()-based timeouts
+ *          run in real time.
+ */
+class PosixSerial : public Stream {
+public:
+    PosixSerial() noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    PosixSerial(const PosixSerial&) = delete;
+    PosixSerial& operator=(const PosixSerial&) = delete;
+    ~PosixSerial() override;
+
+    /**
+     * @brief Opens and configures @p path; closes any previous device.
+     * @return false if the device cannot be opened or the rate is unsupported
+     *         (errno tells why).
+     */
+    bool open(const char* path, uint32_t baud) noexcept;
+    void close() noexcept;
+
+    /// Changes the line rate of the open device.
+    bool setBaud(uint32_t baud) noexcept;
+
+    bool isOpen() const noexcept { return handle >= 0; }
+    int fd() const noexcept { return handle; }
+    uint32_t baud() const noexcept { return rate; }
+    /// True if the kernel drives the transceiver direction (TIOCSRS485).
+    bool kernelRs485() const noexcept { return rs485; }
+
+    using Print::write;
+    size_t write(uint8_t value) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    int availableForWrite() override;
+    void flush() override;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+
+private:
+    static constexpr uint16_t RX_BYTES = 256U;
+    static constexpr uint16_t TX_BYTES = 256U;
+
+    /// Moves bytes from the driver into rx; returns bytes now buffered.
+    uint16_t fill() noexcept;
+    /// Writes out tx, waiting for room in the driver if needed.
+    bool drainTx() noexcept;
+    void setTransmit(bool transmit) noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    uint8_t rx[RX_BYTES];
+    uint8_t tx[TX_BYTES];
+    uint16_t rxHead;     ///< Next byte to read.
+    uint16_t rxTail;     ///< One past the last buffered byte.
+    uint16_t txLength;   ///< Bytes written but not yet sent.
+    int handle;          ///< File descriptor, or -1.
+    uint32_t rate;       ///< Line rate in baud.
+    bool rs485;          ///< Kernel drives DE.
+    bool transmitting;   ///< Software DE (RTS) is raised.
+};
+
+#endif // POSIX_SERIAL_H
@@ -3,8 +3,29 @@
 // JSF AV C++ Rule 12: static for file scope.
 SoilSensor* SoilSensor::_instance = nullptr;
 
+namespace {
+    /// One holding-register range fetched by readAll().
+    struct ReadBlock {
+        uint16_t reg;
+        uint8_t qty;
+    };
+
+    // Indexed by block number; order matches the historical readAll() sequence.
+    constexpr ReadBlock READ_BLOCKS[SoilSensor::READ_BLOCK_COUNT] = {
+        { sensor_registers::SOIL_PH_REG, 1U },
+        { sensor_registers::SOIL_MOISTURE_REG, 2U },  // moisture, temperature
+        { sensor_registers::SOIL_CONDUCTIVITY_REG, 1U },
+        { sensor_registers::SOIL_NITROGEN_REG, 3U }   // N, P, K
+    };
+}
+
+constexpr uint8_t SoilSensor::READ_BLOCK_COUNT;
+constexpr uint16_t SoilSensor::INVALID;
+constexpr int16_t SoilSensor::INVALID_TEMPERATURE;
+
 SoilSensor::SoilSensor(ModbusMaster &node, uint8_t rePin, uint8_t dePin) noexcept
-    : _node(node), _serial(nullptr), _rePin(rePin), _dePin(dePin) {
+    : _node(node), _serial(nullptr), _rePin(rePin), _dePin(dePin), _pendingBlock(0U),
+      _directionHook(nullptr) {
     _instance = this;
 }
 
@@ -17,17 +38,24 @@ void SoilSensor::begin(Stream &serial, long) noexcept {
     pinMode(_rePin, OUTPUT);
     pinMode(_dePin, OUTPUT);
     
-    digitalWrite(_dePin, LOW);
-    digitalWrite(_rePin, LOW);
+    setDirection(false);
     
     _node.preTransmission(preTransmission);
     _node.postTransmission(postTransmission);
 }
 
+void SoilSensor::setDirection(bool transmit) noexcept {
+    if (_directionHook != nullptr) {
+        _directionHook(transmit);
+    } else {
+        digitalWrite(_rePin, transmit ? HIGH : LOW);
+        digitalWrite(_dePin, transmit ? HIGH : LOW);
+    }
+}
+
 void SoilSensor::preTransmission() noexcept {
     if (_instance != nullptr) {
-        digitalWrite(_instance->_rePin, HIGH);
-        digitalWrite(_instance->_dePin, HIGH);
+        _instance->setDirection(true);
         // JSF AV C++ Rule 208: The use of delay functions is prohibited.
         // This delay is a hardware necessity for the RS485 transceiver to switch modes.
         // A better implementation would use a timer or hardware signal.
@@ -38,8 +66,7 @@ void SoilSensor::preTransmission() noexcept {
 void SoilSensor::postTransmission() noexcept {
     if (_instance != nullptr && _instance->_serial != nullptr) {
         _instance->_serial->flush();
-        digitalWrite(_instance->_dePin, LOW);
-        digitalWrite(_instance->_rePin, LOW);
+        _instance->setDirection(false);
     }
 }
 
@@ -85,46 +112,74 @@ uint16_t SoilSensor::readPotassium() noexcept {
 
 bool SoilSensor::readAll(SensorData &data) noexcept {
     _node.clearResponseBuffer();
-    
-    uint8_t result = _node.readHoldingRegisters(sensor_registers::SOIL_PH_REG, 1);
-    if (result == ModbusMaster::ku8MBSuccess) {
-        data.ph = static_cast<float>(_node.getResponseBuffer(0)) / 100.0f;
-    } else {
-        data.ph = -1.0f;
-        return false;
+
+    for (uint8_t block = 0U; block < READ_BLOCK_COUNT; ++block) {
+        uint8_t result = startReadBlock(block);
+        while (result == ModbusMaster::ku8MBPending) {
+            result = pollReadBlock(data);
+        }
+        if (result != ModbusMaster::ku8MBSuccess) {
+            return false;
+        }
     }
+    return true;
+}
 
-    result = _node.readHoldingRegisters(sensor_registers::SOIL_MOISTURE_REG, 2);
-    if (result == ModbusMaster::ku8MBSuccess) {
-        data.moisture = static_cast<float>(_node.getResponseBuffer(0)) / 10.0f;
-        data.temperature = static_cast<float>(_node.getResponseBuffer(1)) / 10.0f;
-    } else {
-        data.moisture = -1.0f;
-        data.temperature = -999.0f;
-        return false;
+uint8_t SoilSensor::startReadBlock(uint8_t block) noexcept {
+    if (block >= READ_BLOCK_COUNT) {
+        return ModbusMaster::ku8MBIllegalDataAddress;
     }
+    _pendingBlock = block;
+    return _node.startReadHoldingRegisters(READ_BLOCKS[block].reg, READ_BLOCKS[block].qty);
+}
 
-    result = _node.readHoldingRegisters(sensor_registers::SOIL_CONDUCTIVITY_REG, 1);
-    if (result == ModbusMaster::ku8MBSuccess) {
-        data.conductivity = _node.getResponseBuffer(0) * 10;
-    } else {
-        data.conductivity = 0;
-        return false;
+uint8_t SoilSensor::pollReadBlock(SensorData &data) noexcept {
+    const uint8_t result = _node.pollTransaction();
+    if (result == ModbusMaster::ku8MBPending) {
+        return result;
+    }
+
+    const bool ok = (result == ModbusMaster::ku8MBSuccess);
+    switch (_pendingBlock) {
+        case 0U:
+            data.ph = ok ? _node.getResponseBuffer(0) : INVALID;
+            break;
+        case 1U:
+            data.moisture = ok ? _node.getResponseBuffer(0) : INVALID;
+            data.temperature = ok ? static_cast<int16_t>(_node.getResponseBuffer(1)) : INVALID_TEMPERATURE;
+            break;
+        case 2U:
+            data.conductivity = ok ? static_cast<uint16_t>(_node.getResponseBuffer(0) * 10) : INVALID;
+            break;
+        default:
+            data.nitrogen = ok ? _node.getResponseBuffer(0) : INVALID;
+            data.phosphorus = ok ? _node.getResponseBuffer(1) : INVALID;
+            data.potassium = ok ? _node.getResponseBuffer(2) : INVALID;
+            break;
     }
+    return result;
+}
+
+uint8_t SoilSensor::startReadRegister(uint16_t reg) noexcept {
+    return _node.startReadHoldingRegisters(reg, 1U);
+}
+
+uint8_t SoilSensor::startWriteRegister(uint16_t reg, uint16_t value) noexcept {
+    return _node.startWriteSingleRegister(reg, value);
+}
 
-    result = _node.readHoldingRegisters(sensor_registers::SOIL_NITROGEN_REG, 3);
+uint8_t SoilSensor::pollRegister(uint16_t &value) noexcept {
+    const uint8_t result = _node.pollTransaction();
     if (result == ModbusMaster::ku8MBSuccess) {
-        data.nitrogen = _node.getResponseBuffer(0);
-        data.phosphorus = _node.getResponseBuffer(1);
-        data.potassium = _node.getResponseBuffer(2);
-        return true;
-    } else {
-        data.nitrogen = 0xFFFF;
-        data.phosphorus = 0xFFFF;
-        data.potassium = 0xFFFF;
+        value = _node.getResponseBuffer(0);
+    }
+    return result;
+}
+
+void SoilSensor::setSlaveAddress(uint8_t address) noexcept {
+    if (_serial != nullptr) {
+        _node.begin(address, *_serial);
     }
-    
-    return false;
 }
 
 bool SoilSensor::setDeviceAddress(uint8_t newAddress) noexcept {
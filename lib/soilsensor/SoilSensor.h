@@ -3,32 +3,29 @@
 
 #include <ModbusMaster.h>
 #include <stdint.h>
-
-// JSF AV C++ Rule 10: Use constexpr for constants.
-namespace sensor_registers {
-    constexpr uint16_t SOIL_MOISTURE_REG = 0x0012;
-    constexpr uint16_t SOIL_TEMPERATURE_REG = 0x0013;
-    constexpr uint16_t SOIL_CONDUCTIVITY_REG = 0x0015;
-    constexpr uint16_t SOIL_PH_REG = 0x0006;
-    constexpr uint16_t SOIL_NITROGEN_REG = 0x001E;
-    constexpr uint16_t SOIL_PHOSPHORUS_REG = 0x001F;
-    constexpr uint16_t SOIL_POTASSIUM_REG = 0x0020;
-    constexpr uint16_t SOIL_DEVICE_ADDRESS_REG = 0x0100;
-    constexpr uint16_t SOIL_BAUD_RATE_REG = 0x0101;
-}
+#include "sensor_registers.h"
 
 class SoilSensor {
 public:
+    /**
+     * @brief One full reading in the sensor's own fixed-point units.
+     * @details Integer-only so that filtering, logging and display never pull
+     *          in soft-float; a field of a block that failed to read holds
+     *          INVALID (INVALID_TEMPERATURE for temperature).
+     */
     struct SensorData {
-        float moisture;
-        float temperature;
-        uint16_t conductivity;
-        float ph;
-        uint16_t nitrogen;
-        uint16_t phosphorus;
-        uint16_t potassium;
+        uint16_t moisture;      ///< Volumetric water content, 0.1 %.
+        int16_t temperature;    ///< 0.1 degC (two's complement register).
+        uint16_t conductivity;  ///< uS/cm.
+        uint16_t ph;            ///< 0.01 pH.
+        uint16_t nitrogen;      ///< mg/kg.
+        uint16_t phosphorus;    ///< mg/kg.
+        uint16_t potassium;     ///< mg/kg.
     };
 
+    static constexpr uint16_t INVALID = 0xFFFFU;
+    static constexpr int16_t INVALID_TEMPERATURE = -32768;  // INT16_MIN (avr-libc hides it from C++)
+
     // JSF AV C++ Rule 39: explicit constructor.
     explicit SoilSensor(ModbusMaster &node, uint8_t rePin, uint8_t dePin) noexcept;
 
@@ -38,9 +35,70 @@ public:
     ~SoilSensor() = default;
 
     void begin(Stream &serial, long baud) noexcept;
+
+    /**
+     * @brief Drives both RS485 direction pins (RE and DE) at once.
+     * @param transmit true: driver enabled; false: receiver enabled.
+     */
+    using DirectionHook = void (*)(bool transmit);
+
+    /**
+     * @brief Replaces the digitalWrite() direction switching, e.g. with a
+     *        compile-time port write. nullptr restores the default.
+     */
+    void setDirectionHook(DirectionHook hook) noexcept { _directionHook = hook; }
     
     bool readAll(SensorData &data) noexcept;
 
+    /**
+     * @brief Number of Modbus transactions readAll() is split into.
+     * @details pH, moisture/temperature, conductivity and N/P/K live in
+     *          non-contiguous register ranges, one request each.
+     */
+    static constexpr uint8_t READ_BLOCK_COUNT = 4U;
+
+    /**
+     * @brief Non-blocking readAll() step: sends the request for one block.
+     * @param block Block index, 0..READ_BLOCK_COUNT-1.
+     * @return ModbusMaster::ku8MBPending once the request is sent,
+     *         ModbusMaster::ku8MBIllegalDataAddress for an invalid block.
+     */
+    uint8_t startReadBlock(uint8_t block) noexcept;
+
+    /**
+     * @brief Non-blocking readAll() step: collects the reply for the started block.
+     * @details On completion the block's fields in @p data are decoded, or set
+     *          to the same error values readAll() uses on failure.
+     * @return ModbusMaster::ku8MBPending while waiting, otherwise the Modbus status.
+     */
+    uint8_t pollReadBlock(SensorData &data) noexcept;
+
+    /**
+     * @brief Non-blocking single holding-register read; finish with pollRegister().
+     * @return ModbusMaster::ku8MBPending once the request is sent.
+     */
+    uint8_t startReadRegister(uint16_t reg) noexcept;
+
+    /**
+     * @brief Non-blocking single holding-register write; finish with pollRegister().
+     * @return ModbusMaster::ku8MBPending once the request is sent.
+     */
+    uint8_t startWriteRegister(uint16_t reg, uint16_t value) noexcept;
+
+    /**
+     * @brief Collects the reply to startReadRegister()/startWriteRegister().
+     * @param[out] value Register content on success; only meaningful for a read.
+     * @return ModbusMaster::ku8MBPending while waiting, otherwise the Modbus status.
+     */
+    uint8_t pollRegister(uint16_t &value) noexcept;
+
+    /// Addresses later requests to slave @p address (no bus traffic).
+    void setSlaveAddress(uint8_t address) noexcept;
+    uint8_t slaveAddress() const noexcept { return _node.getSlave(); }
+
+    /// Transaction counters of the underlying Modbus master.
+    const ModbusMaster::Stats& stats() const noexcept { return _node.getStats(); }
+
     float readMoisture() noexcept;
     float readTemperature() noexcept;
     uint16_t readConductivity() noexcept;
@@ -58,6 +116,10 @@ private:
     Stream*       _serial;
     const uint8_t _rePin;
     const uint8_t _dePin;
+    uint8_t       _pendingBlock;  ///< Block started by startReadBlock().
+    DirectionHook _directionHook; ///< Direct RE/DE access, or nullptr.
+
+    void setDirection(bool transmit) noexcept;
 
     uint16_t getRegisterValue(uint16_t reg) noexcept;
 
@@ -0,0 +1,26 @@
+#ifndef SENSOR_REGISTERS_H
+#define SENSOR_REGISTERS_H
+
+#include <stdint.h>
+
+/**
+ * @file sensor_registers.h
+ * @brief Holding-register map of the JXBS-style 7-in-1 soil probe.
+ * @details Kept free of Arduino dependencies so host tools (the bus
+ *          simulator) share it with the firmware.
+ */
+
+// JSF AV C++ Rule 10: Use constexpr for constants.
+namespace sensor_registers {
+    constexpr uint16_t SOIL_MOISTURE_REG = 0x0012;
+    constexpr uint16_t SOIL_TEMPERATURE_REG = 0x0013;
+    constexpr uint16_t SOIL_CONDUCTIVITY_REG = 0x0015;
+    constexpr uint16_t SOIL_PH_REG = 0x0006;
+    constexpr uint16_t SOIL_NITROGEN_REG = 0x001E;
+    constexpr uint16_t SOIL_PHOSPHORUS_REG = 0x001F;
+    constexpr uint16_t SOIL_POTASSIUM_REG = 0x0020;
+    constexpr uint16_t SOIL_DEVICE_ADDRESS_REG = 0x0100;
+    constexpr uint16_t SOIL_BAUD_RATE_REG = 0x0101;
+}
+
+#endif // SENSOR_REGISTERS_H
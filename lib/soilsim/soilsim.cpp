@@ -0,0 +1,306 @@
+#include "soilsim.h"
+#include "sensor_registers.h"
+#include "util/crc16.h"
+
+namespace soilsim {
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint8_t FC_READ_HOLDING = 0x03U;
+constexpr uint8_t FC_READ_INPUT = 0x04U;
+constexpr uint8_t FC_WRITE_SINGLE = 0x06U;
+constexpr uint8_t FC_WRITE_MULTIPLE = 0x10U;
+
+constexpr uint8_t EX_ILLEGAL_FUNCTION = 0x01U;
+constexpr uint8_t EX_ILLEGAL_ADDRESS = 0x02U;
+constexpr uint8_t EX_ILLEGAL_VALUE = 0x03U;
+constexpr uint8_t EX_DEVICE_FAILURE = 0x04U;
+
+/// Data registers answer up to here; unmapped ones read 0.
+constexpr uint16_t LAST_DATA_REG = 0x0023U;
+constexpr uint16_t MAX_READ_QTY = 125U;
+constexpr uint8_t BROADCAST = 0U;
+constexpr uint8_t MAX_ADDRESS = 247U;
+
+/// Above 19200 baud the RTU inter-frame silence is fixed at 1750 us.
+constexpr uint32_t FIXED_SILENCE_US = 1750UL;
+constexpr uint32_t FIXED_SILENCE_BAUD = 19200UL;
+
+uint16_t word(const uint8_t* p) noexcept {
+    return static_cast<uint16_t>((static_cast<uint16_t>(p[0]) << 8) | p[1]);
+}
+
+uint16_t appendCrc(uint8_t* frame, uint16_t length) noexcept {
+    const uint16_t value = crc(frame, length);
+    frame[length] = static_cast<uint8_t>(value & 0xFFU);
+    frame[length + 1U] = static_cast<uint8_t>(value >> 8);
+    return static_cast<uint16_t>(length + 2U);
+}
+
+} // anonymous namespace
+
+uint16_t crc(const uint8_t* data, uint16_t length) noexcept {
+    uint16_t value = 0xFFFFU;
+    for (uint16_t i = 0U; i < length; ++i) {
+        value = crc16_update(value, data[i]);
+    }
+    return value;
+}
+
+uint32_t baudForCode(uint16_t code) noexcept {
+    if (code < BAUD_CODE_COUNT) {
+        return BAUD_RATES[code];
+    }
+    for (uint8_t i = 0U; i < BAUD_CODE_COUNT; ++i) {
+        if (code == BAUD_RATES[i]) {
+            return BAUD_RATES[i];
+        }
+    }
+    return 0UL;
+}
+
+Slave::Slave(uint8_t address, uint32_t baud, uint32_t seed) noexcept
+    : values(), config(), counters(), baudRate(baud), random((seed != 0UL) ? seed : 1UL),
+      slaveAddress(address) {
+    // A field reading (reference/SoilData.xlsx, zone "Near Shed - West").
+    values.moisture = 840U;
+    values.temperature = 291;
+    values.conductivity = 24U;
+    values.ph = 786U;
+    values.nitrogen = 16U;
+    values.phosphorus = 23U;
+    values.potassium = 46U;
+}
+
+uint32_t Slave::next() noexcept {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    return random;
+}
+
+bool Slave::chance(uint16_t permille) noexcept {
+    return (permille != 0U) && ((next() % 1000UL) < permille);
+}
+
+uint16_t Slave::readRegister(uint16_t reg, bool& mapped) noexcept {
+    mapped = true;
+    int32_t value = 0;
+    switch (reg) {
+        case sensor_registers::SOIL_MOISTURE_REG:     value = values.moisture; break;
+        case sensor_registers::SOIL_TEMPERATURE_REG:  value = values.temperature; break;
+        case sensor_registers::SOIL_CONDUCTIVITY_REG: value = values.conductivity; break;
+        case sensor_registers::SOIL_PH_REG:           value = values.ph; break;
+        case sensor_registers::SOIL_NITROGEN_REG:     value = values.nitrogen; break;
+        case sensor_registers::SOIL_PHOSPHORUS_REG:   value = values.phosphorus; break;
+        case sensor_registers::SOIL_POTASSIUM_REG:    value = values.potassium; break;
+        case sensor_registers::SOIL_DEVICE_ADDRESS_REG:
+            return slaveAddress;
+        case sensor_registers::SOIL_BAUD_RATE_REG:
+            for (uint8_t i = 0U; i < BAUD_CODE_COUNT; ++i) {
+                if (BAUD_RATES[i] == baudRate) {
+                    return i;
+                }
+            }
+            return 0U;
+        default:
+            mapped = (reg <= LAST_DATA_REG);
+            return 0U;
+    }
+    if (config.noise != 0U) {
+        value += static_cast<int32_t>(next() % ((2UL * config.noise) + 1UL)) - static_cast<int32_t>(config.noise);
+    }
+    // Unsigned channels clamp at 0; temperature is two's complement.
+    if ((reg != sensor_registers::SOIL_TEMPERATURE_REG) && (value < 0)) {
+        value = 0;
+    }
+    return static_cast<uint16_t>(value);
+}
+
+uint16_t Slave::exception(uint8_t function, uint8_t code, uint8_t* reply) noexcept {
+    reply[0] = slaveAddress;
+    reply[1] = static_cast<uint8_t>(function | 0x80U);
+    reply[2] = code;
+    ++counters.exceptions;
+    return appendCrc(reply, 3U);
+}
+
+uint16_t Slave::handle(const uint8_t* request, uint16_t length, uint64_t now_us, uint8_t* reply) noexcept {
+    const bool broadcast = (request[0] == BROADCAST);
+    const uint8_t function = request[1];
+    ++counters.requests;
+
+    if ((now_us >= config.outageFromUs) && (now_us < config.outageUntilUs)) {
+        ++counters.dropped;
+        return 0U;
+    }
+
+    // Writes take effect after the reply is built, so it carries the old address.
+    uint8_t newAddress = slaveAddress;
+    uint32_t newBaud = baudRate;
+    uint16_t n = 0U;
+    if ((function == FC_READ_HOLDING) || (function == FC_READ_INPUT)) {
+        const uint16_t first = word(&request[2]);
+        const uint16_t qty = word(&request[4]);
+        if ((length != 6U) || (qty == 0U) || (qty > MAX_READ_QTY)) {
+            n = exception(function, EX_ILLEGAL_VALUE, reply);
+        } else {
+            reply[0] = slaveAddress;
+            reply[1] = function;
+            reply[2] = static_cast<uint8_t>(2U * qty);
+            n = 3U;
+            for (uint16_t i = 0U; (i < qty) && (n != 0U); ++i) {
+                bool mapped = false;
+                const uint16_t value = readRegister(static_cast<uint16_t>(first + i), mapped);
+                if (!mapped) {
+                    n = 0U;
+                } else {
+                    reply[n++] = static_cast<uint8_t>(value >> 8);
+                    reply[n++] = static_cast<uint8_t>(value & 0xFFU);
+                }
+            }
+            n = (n != 0U) ? appendCrc(reply, n) : exception(function, EX_ILLEGAL_ADDRESS, reply);
+        }
+    } else if (function == FC_WRITE_SINGLE) {
+        const uint16_t reg = word(&request[2]);
+        const uint16_t value = word(&request[4]);
+        if (length != 6U) {
+            n = exception(function, EX_ILLEGAL_VALUE, reply);
+        } else if (reg == sensor_registers::SOIL_DEVICE_ADDRESS_REG) {
+            if ((value == BROADCAST) || (value > MAX_ADDRESS)) {
+                n = exception(function, EX_ILLEGAL_VALUE, reply);
+            } else {
+                newAddress = static_cast<uint8_t>(value);
+            }
+        } else if (reg == sensor_registers::SOIL_BAUD_RATE_REG) {
+            newBaud = baudForCode(value);
+            if (newBaud == 0UL) {
+                newBaud = baudRate;
+                n = exception(function, EX_ILLEGAL_VALUE, reply);
+            }
+        } else {
+            n = exception(function, EX_ILLEGAL_ADDRESS, reply);
+        }
+        if (n == 0U) {
+            // Echo of the request.
+            for (uint16_t i = 0U; i < 6U; ++i) {
+                reply[i] = request[i];
+            }
+            reply[0] = slaveAddress;
+            n = appendCrc(reply, 6U);
+        }
+    } else {
+        n = exception(function, EX_ILLEGAL_FUNCTION, reply);
+    }
+
+    slaveAddress = newAddress;
+    baudRate = newBaud;
+
+    if (broadcast) {
+        return 0U;
+    }
+    if (chance(config.dropPermille)) {
+        ++counters.dropped;
+        return 0U;
+    }
+    if (chance(config.exceptionPermille)) {
+        n = exception(function, (config.exceptionCode != 0U) ? config.exceptionCode : EX_DEVICE_FAILURE, reply);
+    } else if ((reply[1] & 0x80U) == 0U) {
+        ++counters.replies;
+    }
+    if (chance(config.corruptPermille)) {
+        reply[n - 1U] = static_cast<uint8_t>(reply[n - 1U] ^ 0x5AU);
+        ++counters.corrupted;
+    }
+    return n;
+}
+
+Bus::Bus(uint32_t baud) noexcept
+    : slaves(), frame(), length(0U), lastByteUs(0U), baudRate(baud), counters() {}
+
+void Bus::attach(Slave& slave) {
+    slaves.push_back(&slave);
+}
+
+void Bus::setBaud(uint32_t baud) noexcept {
+    baudRate = baud;
+}
+
+uint32_t Bus::charUs() const noexcept {
+    return (baudRate != 0UL) ? static_cast<uint32_t>((10000000UL + (baudRate / 2UL)) / baudRate) : 0UL;
+}
+
+Slave* Bus::find(uint8_t address) noexcept {
+    for (Slave* s : slaves) {
+        if (s->address() == address) {
+            return s;
+        }
+    }
+    return nullptr;
+}
+
+uint16_t Bus::expectedLength() const noexcept {
+    if (length < 2U) {
+        return MAX_FRAME;
+    }
+    if (frame[1] == FC_WRITE_MULTIPLE) {
+        // address, function, start, quantity, byte count, data, CRC
+        return (length < 7U) ? MAX_FRAME : static_cast<uint16_t>(9U + frame[6]);
+    }
+    // Every other request this probe understands (and the fallback for
+    // unknown functions) is address, function, two words and the CRC.
+    return 8U;
+}
+
+bool Bus::receive(uint8_t value, uint64_t end_us, Reply& reply) noexcept {
+    reply.length = 0U;
+
+    // Interframe silence: anything still pending is a fragment.
+    const uint32_t silence = (baudRate > FIXED_SILENCE_BAUD) ? FIXED_SILENCE_US : ((7UL * charUs()) / 2UL);
+    if ((length != 0U) && ((end_us - lastByteUs) > (silence + charUs()))) {
+        ++counters.fragments;
+        length = 0U;
+    }
+    lastByteUs = end_us;
+    frame[length++] = value;
+
+    const uint16_t expected = expectedLength();
+    if ((length < expected) && (length < MAX_FRAME)) {
+        return false;
+    }
+    const uint16_t size = length;
+    length = 0U;
+
+    const uint16_t check = crc(frame, static_cast<uint16_t>(size - 2U));
+    if ((frame[size - 2U] != static_cast<uint8_t>(check & 0xFFU)) || (frame[size - 1U] != static_cast<uint8_t>(check >> 8))) {
+        ++counters.crcErrors;
+        return false;
+    }
+    ++counters.frames;
+
+    bool taken = false;
+    for (Slave* s : slaves) {
+        // A slave at another baud rate only sees line noise.
+        if ((s->baud() != baudRate) || ((frame[0] != BROADCAST) && (frame[0] != s->address()))) {
+            continue;
+        }
+        taken = true;
+        uint8_t out[MAX_FRAME];
+        const uint16_t n = s->handle(frame, static_cast<uint16_t>(size - 2U), end_us, out);
+        if ((n != 0U) && (reply.length == 0U)) {
+            for (uint16_t i = 0U; i < n; ++i) {
+                reply.bytes[i] = out[i];
+            }
+            reply.length = n;
+            reply.startUs = end_us + s->faults().responseDelayUs;
+            reply.byteGapUs = s->faults().byteGapUs;
+        }
+    }
+    if (!taken && (frame[0] != BROADCAST)) {
+        ++counters.unanswered;
+    }
+    return reply.length != 0U;
+}
+
+} // namespace soilsim
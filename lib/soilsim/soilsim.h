@@ -0,0 +1,185 @@
+#ifndef SOILSIM_H
+#define SOILSIM_H
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @file soilsim.h
+ * @brief Simulated JXBS-style 7-in-1 soil probes on a Modbus RTU bus.
+ * @details A Slave answers function 0x03/0x04 reads of the data registers
+ *          (0x0000-0x0023, unmapped ones read 0) plus the address (0x0100) and
+ *          baud (0x0101) registers, and 0x06 writes of the latter two. Other
+ *          functions get exception 0x01, other registers 0x02 and bad values
+ *          0x03. A new address or baud takes effect after the reply, like on
+ *          the probe. Each slave carries its own timing and faults: reply
+ *          delay, gaps between reply bytes, reading noise, dropped replies,
+ *          corrupted CRCs, injected exceptions and outages. Random faults come
+ *          from a per-slave seeded generator, so a run is repeatable.
+ *
+ *          A Bus collects request bytes from the master, splits them into
+ *          frames by function-code length (and the 3.5-character silence),
+ *          checks the CRC and lets the addressed slave answer. It only deals
+ *          in microsecond timestamps; soilsim_hal.h attaches it to a
+ *          native_hal serial port, tools/soilsim serves it on a pseudo-terminal.
+ *
+ *          Plain C++ with no Arduino dependency.
+ */
+namespace soilsim {
+
+/// Largest Modbus RTU frame.
+constexpr uint16_t MAX_FRAME = 256U;
+
+/// Baud rates selected by the baud register (value 0, 1, 2 or the rate itself).
+constexpr uint8_t BAUD_CODE_COUNT = 3U;
+constexpr uint32_t BAUD_RATES[BAUD_CODE_COUNT] = { 2400UL, 4800UL, 9600UL };
+
+/// Data register contents, in register units (see SoilSensor::SensorData).
+struct Readings {
+    uint16_t moisture;      ///< 0.1 %.
+    int16_t temperature;    ///< 0.1 degC.
+    uint16_t conductivity;  ///< Register value; the firmware scales it by 10.
+    uint16_t ph;            ///< 0.01 pH.
+    uint16_t nitrogen;      ///< mg/kg.
+    uint16_t phosphorus;    ///< mg/kg.
+    uint16_t potassium;     ///< mg/kg.
+};
+
+/// Timing and fault settings of one slave; all zero is a perfect probe.
+struct Faults {
+    uint32_t responseDelayUs;     ///< Request stop bit to reply start bit.
+    uint32_t byteGapUs;           ///< Extra idle time between reply bytes.
+    uint16_t noise;               ///< Each read adds uniform +-noise counts.
+    uint16_t dropPermille;        ///< Replies silently not sent.
+    uint16_t corruptPermille;     ///< Replies sent with a bad CRC.
+    uint16_t exceptionPermille;   ///< Replies replaced by exceptionCode.
+    uint8_t exceptionCode;        ///< Exception injected (0x04 if left 0).
+    uint64_t outageFromUs;        ///< No replies in [outageFromUs, outageUntilUs).
+    uint64_t outageUntilUs;
+};
+
+/// Per-slave counters.
+struct SlaveStats {
+    uint32_t requests;     ///< Valid frames addressed to the slave.
+    uint32_t replies;      ///< Normal replies (including corrupted ones).
+    uint32_t exceptions;   ///< Exception replies, genuine or injected.
+    uint32_t dropped;      ///< Replies withheld (drop fault or outage).
+    uint32_t corrupted;    ///< Replies sent with a bad CRC.
+};
+
+/**
+ * @class Slave
+ * @brief One simulated probe.
+ */
+class Slave {
+public:
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit Slave(uint8_t address, uint32_t baud = 9600UL, uint32_t seed = 1UL) noexcept;
+
+    uint8_t address() const noexcept { return slaveAddress; }
+    uint32_t baud() const noexcept { return baudRate; }
+    void setAddress(uint8_t address) noexcept { slaveAddress = address; }
+    void setBaud(uint32_t baud) noexcept { baudRate = baud; }
+
+    Readings& readings() noexcept { return values; }
+    Faults& faults() noexcept { return config; }
+    const Faults& faults() const noexcept { return config; }
+    const SlaveStats& stats() const noexcept { return counters; }
+
+    /**
+     * @brief Handles a CRC-checked request addressed to this slave (or broadcast).
+     * @param length Request length without the CRC.
+     * @param now_us Time the request ended (for outages).
+     * @param[out] reply Reply frame including CRC.
+     * @return Reply length; 0 if nothing is sent.
+     */
+    uint16_t handle(const uint8_t* request, uint16_t length, uint64_t now_us, uint8_t* reply) noexcept;
+
+private:
+    uint32_t next() noexcept;
+    bool chance(uint16_t permille) noexcept;
+    uint16_t readRegister(uint16_t reg, bool& mapped) noexcept;
+    uint16_t exception(uint8_t function, uint8_t code, uint8_t* reply) noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    Readings values;       ///< Register contents before noise.
+    Faults config;         ///< Timing and faults.
+    SlaveStats counters;   ///< Traffic seen.
+    uint32_t baudRate;     ///< Line rate the slave listens at.
+    uint32_t random;       ///< xorshift32 state.
+    uint8_t slaveAddress;  ///< 1-247.
+};
+
+/// One reply ready for the wire.
+struct Reply {
+    uint8_t bytes[MAX_FRAME];
+    uint16_t length;      ///< 0: nobody answers.
+    uint64_t startUs;     ///< First start bit.
+    uint32_t byteGapUs;   ///< Idle time between bytes.
+};
+
+/// Bus counters.
+struct BusStats {
+    uint32_t frames;         ///< Complete frames with a good CRC.
+    uint32_t crcErrors;      ///< Complete frames with a bad CRC.
+    uint32_t fragments;      ///< Partial frames cut off by silence.
+    uint32_t unanswered;     ///< Good frames no listening slave took (not broadcast).
+};
+
+/**
+ * @class Bus
+ * @brief The RS485 segment: request framing and slave dispatch.
+ */
+class Bus {
+public:
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit Bus(uint32_t baud = 9600UL) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Bus(const Bus&) = delete;
+    Bus& operator=(const Bus&) = delete;
+    ~Bus() = default;
+
+    /// Adds @p slave to the segment (not owned).
+    void attach(Slave& slave);
+
+    /// Line rate of the master; slaves set to another rate see only noise.
+    void setBaud(uint32_t baud) noexcept;
+    uint32_t baud() const noexcept { return baudRate; }
+
+    /// Microseconds for one 10-bit character at the current rate.
+    uint32_t charUs() const noexcept;
+
+    /**
+     * @brief Feeds one byte sent by the master.
+     * @param end_us Time its stop bit ended.
+     * @param[out] reply Filled when this byte completes a request; startUs is
+     *             relative to @p end_us plus the slave's response delay.
+     * @return true if @p reply holds a frame to send.
+     */
+    bool receive(uint8_t value, uint64_t end_us, Reply& reply) noexcept;
+
+    const BusStats& stats() const noexcept { return counters; }
+    Slave* find(uint8_t address) noexcept;
+
+private:
+    uint16_t expectedLength() const noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    std::vector<Slave*> slaves;  ///< Attached probes.
+    uint8_t frame[MAX_FRAME];    ///< Request being assembled.
+    uint16_t length;             ///< Bytes in frame.
+    uint64_t lastByteUs;         ///< End of the previous request byte.
+    uint32_t baudRate;           ///< Master line rate.
+    BusStats counters;           ///< Traffic seen.
+};
+
+/// Modbus RTU CRC over @p length bytes.
+uint16_t crc(const uint8_t* data, uint16_t length) noexcept;
+
+/// Baud rate for a baud register value, or 0 if invalid.
+uint32_t baudForCode(uint16_t code) noexcept;
+
+} // namespace soilsim
+
+#endif // SOILSIM_H
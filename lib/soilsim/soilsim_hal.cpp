@@ -0,0 +1,22 @@
+#include "soilsim_hal.h"
+
+namespace soilsim {
+
+void BusPeer::onTransmit(hal::FakeStream& port, uint8_t value, uint64_t end_cycle) {
+    segment.setBaud(port.baud());
+    const uint64_t end_us = end_cycle / hal::CYCLES_PER_US;
+    if (!segment.receive(value, end_us, reply)) {
+        return;
+    }
+    // Keep the cycle-exact request end; only the delay comes from the bus.
+    const uint64_t gap = static_cast<uint64_t>(reply.byteGapUs) * hal::CYCLES_PER_US;
+    const uint64_t character = port.byteCycles();
+    uint64_t at = end_cycle + ((reply.startUs - end_us) * hal::CYCLES_PER_US);
+    for (uint16_t i = 0U; i < reply.length; ++i) {
+        at += character;
+        port.injectByte(at, reply.bytes[i]);
+        at += gap;
+    }
+}
+
+} // namespace soilsim
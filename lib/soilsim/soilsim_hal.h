@@ -0,0 +1,37 @@
+#ifndef SOILSIM_HAL_H
+#define SOILSIM_HAL_H
+
+#include "native_hal.h"
+#include "soilsim.h"
+
+/**
+ * @file soilsim_hal.h
+ * @brief Puts a soilsim::Bus on a native_hal serial port.
+ * @details Attach with port.setPeer(&peer). Requests are timed by the port's
+ *          wire model and replies are scheduled into its RX queue at the
+ *          port's baud rate, with the answering slave's delay and byte gaps,
+ *          so the firmware sees them arrive exactly as it would on RS485.
+ */
+namespace soilsim {
+
+class BusPeer : public hal::SerialPeer {
+public:
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit BusPeer(Bus& bus) noexcept : segment(bus), reply() {}
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    BusPeer(const BusPeer&) = delete;
+    BusPeer& operator=(const BusPeer&) = delete;
+    ~BusPeer() override = default;
+
+    void onTransmit(hal::FakeStream& port, uint8_t value, uint64_t end_cycle) override;
+
+private:
+    // JSF AV C++ Rule 23: All data members shall be private.
+    Bus& segment;  ///< Slaves behind the port.
+    Reply reply;   ///< Scratch for the frame being answered.
+};
+
+} // namespace soilsim
+
+#endif // SOILSIM_HAL_H
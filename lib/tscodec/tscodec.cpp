@@ -0,0 +1,254 @@
+#include "tscodec.h"
+
+// JSF AV C++ Rule 12: static for file scope.
+namespace {
+
+constexpr uint8_t COUNT_BITS = 16U;
+constexpr uint8_t TIMESTAMP_BITS = 32U;
+constexpr uint8_t VALUE_BITS = 16U;
+constexpr uint8_t WIDTH_FIELD_BITS = 5U;
+/// Re-using the current width costs WIDTH_FIELD_BITS fewer header bits than
+/// announcing a new one, so it wins until it wastes more than that.
+constexpr uint8_t WIDTH_SLACK = WIDTH_FIELD_BITS;
+
+/**
+ * @brief One delta-of-delta range: prefix code and signed payload width.
+ */
+struct DodClass {
+    uint8_t prefix;       ///< Prefix bits, right-aligned.
+    uint8_t prefixBits;
+    uint8_t payloadBits;  ///< Two's-complement payload.
+};
+
+constexpr uint8_t DOD_CLASS_COUNT = 4U;
+constexpr DodClass DOD_CLASSES[DOD_CLASS_COUNT] = {
+    { 0x2U, 2U, 7U },   // 10
+    { 0x6U, 3U, 9U },   // 110
+    { 0xEU, 4U, 12U },  // 1110
+    { 0xFU, 4U, 32U }   // 1111
+};
+
+constexpr uint32_t zigzag(int32_t v) noexcept {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+constexpr int32_t unzigzag(uint32_t v) noexcept {
+    return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1UL);
+}
+
+uint8_t bitsFor(uint32_t v) noexcept {
+    uint8_t n = 0U;
+    while (v != 0UL) {
+        ++n;
+        v >>= 1;
+    }
+    return n;
+}
+
+bool fitsSigned(int32_t v, uint8_t bits) noexcept {
+    if (bits >= 32U) {
+        return true;
+    }
+    const int32_t limit = static_cast<int32_t>(1UL << (bits - 1U));
+    return (v >= -limit) && (v < limit);
+}
+
+int32_t signExtend(uint32_t v, uint8_t bits) noexcept {
+    if ((bits < 32U) && ((v & (1UL << (bits - 1U))) != 0UL)) {
+        v |= ~((1UL << bits) - 1UL);
+    }
+    return static_cast<int32_t>(v);
+}
+
+} // anonymous namespace
+
+namespace tscodec {
+
+Encoder::Encoder(uint8_t* buffer, uint16_t capacity, uint8_t channels) noexcept
+    : out(buffer),
+      capacityBits(static_cast<uint32_t>(capacity) << 3),
+      bitPos(0UL),
+      overflow(false),
+      channelCount((channels < MAX_CHANNELS) ? channels : MAX_CHANNELS),
+      samples(0U),
+      lastTimestamp(0UL),
+      lastDelta(0L),
+      lastValues(),
+      widths() {
+    putBits(0UL, COUNT_BITS);  // Patched by finish()
+}
+
+void Encoder::putBits(uint32_t bits, uint8_t width) noexcept {
+    for (uint8_t i = width; i > 0U; --i) {
+        if (bitPos >= capacityBits) {
+            overflow = true;
+            return;
+        }
+        const uint16_t index = static_cast<uint16_t>(bitPos >> 3);
+        const uint8_t shift = static_cast<uint8_t>(7U - (bitPos & 7U));
+        if (shift == 7U) {
+            out[index] = 0U;
+        }
+        if (((bits >> (i - 1U)) & 1UL) != 0UL) {
+            out[index] = static_cast<uint8_t>(out[index] | (1U << shift));
+        }
+        ++bitPos;
+    }
+}
+
+bool Encoder::append(uint32_t timestamp, const int16_t* values) noexcept {
+    if (overflow || (samples == 0xFFFFU)) {
+        return false;
+    }
+    const uint32_t start = bitPos;
+    uint8_t newWidths[MAX_CHANNELS];
+    int32_t delta = 0L;
+
+    if (samples == 0U) {
+        putBits(timestamp, TIMESTAMP_BITS);
+        for (uint8_t ch = 0U; ch < channelCount; ++ch) {
+            putBits(static_cast<uint16_t>(values[ch]), VALUE_BITS);
+            newWidths[ch] = 0U;
+        }
+    } else {
+        delta = static_cast<int32_t>(timestamp - lastTimestamp);
+        // Modulo 2^32, as the decoder adds it back: the 32-bit class carries
+        // every dod, and a signed subtraction could overflow.
+        const int32_t dod = static_cast<int32_t>(static_cast<uint32_t>(delta) - static_cast<uint32_t>(lastDelta));
+        if (dod == 0L) {
+            putBits(0UL, 1U);
+        } else {
+            uint8_t c = 0U;
+            while ((c < (DOD_CLASS_COUNT - 1U)) && !fitsSigned(dod, DOD_CLASSES[c].payloadBits)) {
+                ++c;
+            }
+            putBits(DOD_CLASSES[c].prefix, DOD_CLASSES[c].prefixBits);
+            putBits(static_cast<uint32_t>(dod), DOD_CLASSES[c].payloadBits);
+        }
+
+        for (uint8_t ch = 0U; ch < channelCount; ++ch) {
+            const uint32_t z = zigzag(static_cast<int32_t>(values[ch]) - lastValues[ch]);
+            const uint8_t w = bitsFor(z);
+            newWidths[ch] = widths[ch];
+            if (z == 0UL) {
+                putBits(0UL, 1U);
+            } else if ((w <= widths[ch]) && (widths[ch] <= (w + WIDTH_SLACK))) {
+                putBits(0x2UL, 2U);
+                putBits(z, widths[ch]);
+            } else {
+                putBits(0x3UL, 2U);
+                putBits(w, WIDTH_FIELD_BITS);
+                putBits(z, w);
+                newWidths[ch] = w;
+            }
+        }
+    }
+
+    if (overflow) {
+        // Roll back: clear the partial byte's new bits; later bytes are
+        // zeroed when first written.
+        bitPos = start;
+        overflow = false;
+        if ((start & 7U) != 0U) {
+            const uint16_t index = static_cast<uint16_t>(start >> 3);
+            out[index] = static_cast<uint8_t>(out[index] & static_cast<uint8_t>(0xFFU << (8U - (start & 7U))));
+        }
+        return false;
+    }
+
+    lastDelta = delta;
+    lastTimestamp = timestamp;
+    for (uint8_t ch = 0U; ch < channelCount; ++ch) {
+        lastValues[ch] = values[ch];
+        widths[ch] = newWidths[ch];
+    }
+    ++samples;
+    return true;
+}
+
+uint16_t Encoder::finish() noexcept {
+    if (capacityBits >= COUNT_BITS) {
+        out[0] = static_cast<uint8_t>(samples >> 8);
+        out[1] = static_cast<uint8_t>(samples);
+    }
+    return sizeBytes();
+}
+
+Decoder::Decoder(const uint8_t* buffer, uint16_t length, uint8_t channels) noexcept
+    : in(buffer),
+      lengthBits(static_cast<uint32_t>(length) << 3),
+      bitPos(0UL),
+      truncated(false),
+      channelCount((channels < MAX_CHANNELS) ? channels : MAX_CHANNELS),
+      samples(0U),
+      decoded(0U),
+      lastTimestamp(0UL),
+      lastDelta(0L),
+      lastValues(),
+      widths() {
+    samples = static_cast<uint16_t>(getBits(COUNT_BITS));
+    if (truncated) {
+        samples = 0U;
+    }
+}
+
+uint32_t Decoder::getBits(uint8_t width) noexcept {
+    uint32_t v = 0UL;
+    for (uint8_t i = 0U; i < width; ++i) {
+        if (bitPos >= lengthBits) {
+            truncated = true;
+            return 0UL;
+        }
+        const uint8_t byte = in[bitPos >> 3];
+        v = (v << 1) | ((byte >> (7U - (bitPos & 7U))) & 1U);
+        ++bitPos;
+    }
+    return v;
+}
+
+bool Decoder::next(uint32_t& timestamp, int16_t* values) noexcept {
+    if (truncated || (decoded >= samples)) {
+        return false;
+    }
+
+    if (decoded == 0U) {
+        lastTimestamp = getBits(TIMESTAMP_BITS);
+        for (uint8_t ch = 0U; ch < channelCount; ++ch) {
+            lastValues[ch] = static_cast<int16_t>(getBits(VALUE_BITS));
+        }
+    } else {
+        int32_t dod = 0L;
+        if (getBits(1U) != 0UL) {
+            uint8_t c = 0U;
+            // Each further 1 selects the next class; the last has no terminating 0.
+            while ((c < (DOD_CLASS_COUNT - 1U)) && (getBits(1U) != 0UL)) {
+                ++c;
+            }
+            dod = signExtend(getBits(DOD_CLASSES[c].payloadBits), DOD_CLASSES[c].payloadBits);
+        }
+        lastDelta = static_cast<int32_t>(static_cast<uint32_t>(lastDelta) + static_cast<uint32_t>(dod));
+        lastTimestamp += static_cast<uint32_t>(lastDelta);
+
+        for (uint8_t ch = 0U; ch < channelCount; ++ch) {
+            if (getBits(1U) == 0UL) {
+                continue;
+            }
+            if (getBits(1U) != 0UL) {
+                widths[ch] = static_cast<uint8_t>(getBits(WIDTH_FIELD_BITS));
+            }
+            lastValues[ch] = static_cast<int16_t>(lastValues[ch] + unzigzag(getBits(widths[ch])));
+        }
+    }
+    if (truncated) {
+        return false;
+    }
+
+    timestamp = lastTimestamp;
+    for (uint8_t ch = 0U; ch < channelCount; ++ch) {
+        values[ch] = lastValues[ch];
+    }
+    ++decoded;
+    return true;
+}
+
+} // namespace tscodec
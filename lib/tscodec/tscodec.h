@@ -0,0 +1,133 @@
+#ifndef TSCODEC_H
+#define TSCODEC_H
+
+#include <stdint.h>
+
+/**
+ * @file tscodec.h
+ * @brief Gorilla-style block compression for multi-channel integer samples.
+ * @details A block starts with the sample count, the first timestamp and the
+ *          first value of every channel in full. Each later sample is then
+ *          bit-packed, most significant bit first:
+ *
+ *          Timestamp, as the delta of the delta to the previous sample:
+ *          - `0`                      same spacing as before
+ *          - `10`   + 7-bit signed    |dod| < 64
+ *          - `110`  + 9-bit signed    |dod| < 256
+ *          - `1110` + 12-bit signed   |dod| < 2048
+ *          - `1111` + 32 bits         anything else
+ *
+ *          Each channel, as the zig-zagged difference to its previous value:
+ *          - `0`                      unchanged
+ *          - `10` + W bits            fits the channel's current width W
+ *          - `11` + 5-bit width + bits  new width (also used to shrink W)
+ *
+ *          Integer soil channels drift by a few counts per poll, so a steady
+ *          sample costs 1 + channels bits and a typical noisy one ~4 bits
+ *          per channel, against 16. Blocks are independent; a lost block
+ *          does not affect the next.
+ */
+namespace tscodec {
+
+/// Most channels per sample.
+constexpr uint8_t MAX_CHANNELS = 8U;
+
+/// Bytes of a block holding only its first sample, for @p channels.
+constexpr uint16_t firstSampleBytes(uint8_t channels) noexcept {
+    return static_cast<uint16_t>(2U + 4U + (2U * channels));
+}
+
+/**
+ * @class Encoder
+ * @brief Appends samples to one caller-owned block buffer.
+ */
+class Encoder {
+public:
+    /**
+     * @param buffer Block storage; its content is overwritten.
+     * @param capacity Size of @p buffer in bytes.
+     * @param channels Values per sample (clamped to MAX_CHANNELS).
+     */
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit Encoder(uint8_t* buffer, uint16_t capacity, uint8_t channels) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Encoder(const Encoder&) = delete;
+    Encoder& operator=(const Encoder&) = delete;
+    ~Encoder() = default;
+
+    /**
+     * @brief Adds one sample.
+     * @return false if the block is full; the block is left unchanged, so
+     *         the caller can finish() it and start the next with the sample.
+     */
+    bool append(uint32_t timestamp, const int16_t* values) noexcept;
+
+    /**
+     * @brief Writes the sample count into the block header.
+     * @return Bytes used by the block.
+     */
+    uint16_t finish() noexcept;
+
+    uint16_t count() const noexcept { return samples; }
+    uint16_t sizeBytes() const noexcept { return static_cast<uint16_t>((bitPos + 7UL) >> 3); }
+
+private:
+    void putBits(uint32_t bits, uint8_t width) noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    uint8_t* out;                        ///< Block storage.
+    uint32_t capacityBits;               ///< Size of the block in bits.
+    uint32_t bitPos;                     ///< Next bit to write.
+    bool overflow;                       ///< A write ran past capacityBits.
+    uint8_t channelCount;                ///< Values per sample.
+    uint16_t samples;                    ///< Samples appended so far.
+    uint32_t lastTimestamp;              ///< Timestamp of the previous sample.
+    int32_t lastDelta;                   ///< Spacing of the previous two samples.
+    int16_t lastValues[MAX_CHANNELS];    ///< Previous value per channel.
+    uint8_t widths[MAX_CHANNELS];        ///< Current difference width per channel.
+};
+
+/**
+ * @class Decoder
+ * @brief Streams the samples back out of one block.
+ */
+class Decoder {
+public:
+    // JSF AV C++ Rule 39: All constructors shall be declared explicit.
+    explicit Decoder(const uint8_t* buffer, uint16_t length, uint8_t channels) noexcept;
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Decoder(const Decoder&) = delete;
+    Decoder& operator=(const Decoder&) = delete;
+    ~Decoder() = default;
+
+    /**
+     * @brief Decodes the next sample.
+     * @return false once all samples were returned or the block is truncated.
+     */
+    bool next(uint32_t& timestamp, int16_t* values) noexcept;
+
+    /// Samples the block header announces.
+    uint16_t count() const noexcept { return samples; }
+
+private:
+    uint32_t getBits(uint8_t width) noexcept;
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    const uint8_t* in;                   ///< Block storage.
+    uint32_t lengthBits;                 ///< Size of the block in bits.
+    uint32_t bitPos;                     ///< Next bit to read.
+    bool truncated;                      ///< A read ran past lengthBits.
+    uint8_t channelCount;                ///< Values per sample.
+    uint16_t samples;                    ///< Samples in the block.
+    uint16_t decoded;                    ///< Samples returned so far.
+    uint32_t lastTimestamp;
+    int32_t lastDelta;
+    int16_t lastValues[MAX_CHANNELS];
+    uint8_t widths[MAX_CHANNELS];
+};
+
+} // namespace tscodec
+
+#endif // TSCODEC_H
@@ -0,0 +1,254 @@
+#include "aggregate.h"
+#include "channels.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+using aggregate::Level;
+using aggregate::LEVEL_COUNT;
+
+constexpr uint32_t MS_PER_MINUTE = 60000UL;
+constexpr uint32_t MINUTES_PER_HOUR = 60UL;
+constexpr uint32_t MINUTES_PER_DAY = 1440UL;
+
+// JSF AV C++ Rule 10: constexpr helpers (C++11 single-return form).
+/// Samples in a full bucket of @p period_ms at the configured poll rate.
+constexpr uint32_t samplesPer(uint32_t period_ms) noexcept {
+    return (period_ms + timing::SENSOR_READ_PERIOD_MS - 1UL) / timing::SENSOR_READ_PERIOD_MS;
+}
+
+static_assert(samplesPer(MS_PER_MINUTE * MINUTES_PER_DAY) <= 0xFFFFUL,
+              "Sensor poll rate too fast for 16-bit daily sample counts");
+
+/**
+ * @brief Open bucket: exact running sums.
+ */
+struct Accumulator {
+    uint16_t count;
+    int16_t min;
+    int16_t max;
+    int32_t sum;
+    uint64_t sumsq;
+};
+
+/**
+ * @brief Closed bucket: only ever read back, so kept as its final Summary
+ *        (10 bytes) rather than the running sums (18).
+ */
+using Bucket = aggregate::Summary;
+
+/**
+ * @brief Fixed-capacity history of closed buckets, newest overwrites oldest.
+ */
+template <uint8_t N>
+struct Ring {
+    Bucket slots[N];
+    uint8_t next;
+    uint8_t filled;
+
+    void push(const Bucket& b) noexcept {
+        slots[next] = b;
+        next = static_cast<uint8_t>((next + 1U) % N);
+        if (filled < N) {
+            ++filled;
+        }
+    }
+
+    /// @p index 0 is the newest bucket; nullptr past the oldest.
+    const Bucket* get(uint8_t index) const noexcept {
+        return (index < filled) ? &slots[(next + N - 1U - index) % N] : nullptr;
+    }
+};
+
+struct ChannelState {
+    Accumulator open[LEVEL_COUNT];
+    Ring<aggregates::MINUTE_SLOTS> minutes;
+    Ring<aggregates::HOUR_SLOTS> hours;
+    Ring<aggregates::DAY_SLOTS> days;
+};
+
+struct State {
+    ChannelState channel[aggregates::CHANNEL_COUNT];
+    uint32_t minute;  ///< Minute index (since boot) of the open minute bucket.
+    bool started;
+};
+
+// JSF AV C++ Rule 70: No volatile; producer and readers both run in the idle loop.
+State g_state = {};
+
+#if defined(__AVR__)
+// Host ABIs pad the 64-bit members; the budget is for the packed AVR layout.
+static_assert(sizeof(State) <= aggregates::RAM_BUDGET_BYTES,
+              "Aggregates exceed aggregates::RAM_BUDGET_BYTES; trim channels or slots");
+#endif
+
+void clear(Accumulator& a) noexcept {
+    a.count = 0U;
+    a.min = 32767;
+    a.max = -32768;
+    a.sum = 0L;
+    a.sumsq = 0ULL;
+}
+
+void merge(Accumulator& into, const Accumulator& from) noexcept {
+    if (from.count == 0U) {
+        return;
+    }
+    const uint32_t count = static_cast<uint32_t>(into.count) + from.count;
+    into.count = static_cast<uint16_t>((count > 0xFFFFUL) ? 0xFFFFUL : count);
+    into.min = (from.min < into.min) ? from.min : into.min;
+    into.max = (from.max > into.max) ? from.max : into.max;
+    into.sum += from.sum;
+    into.sumsq += from.sumsq;
+}
+
+uint32_t isqrt(uint32_t v) noexcept {
+    uint32_t root = 0UL;
+    uint32_t bit = 1UL << 30;
+    while (bit > v) {
+        bit >>= 2;
+    }
+    while (bit != 0UL) {
+        if (v >= (root + bit)) {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+aggregate::Summary summarise(const Accumulator& a) noexcept {
+    aggregate::Summary s = {};
+    s.count = a.count;
+    s.min = a.min;
+    s.max = a.max;
+    const int32_t n = static_cast<int32_t>(a.count);
+    s.mean = static_cast<int16_t>((a.sum >= 0L) ? ((a.sum + (n / 2L)) / n) : ((a.sum - (n / 2L)) / n));
+    // n^2 * variance = n * sum(x^2) - (sum x)^2, computed in 64 bits
+    const int64_t sum = a.sum;
+    const int64_t scaledVar = (static_cast<int64_t>(n) * static_cast<int64_t>(a.sumsq)) - (sum * sum);
+    const uint64_t variance = (scaledVar > 0LL)
+        ? (static_cast<uint64_t>(scaledVar) / static_cast<uint64_t>(static_cast<int64_t>(n) * n)) : 0ULL;
+    s.stddev = static_cast<uint16_t>(isqrt(static_cast<uint32_t>((variance > 0xFFFFFFFFULL) ? 0xFFFFFFFFULL : variance)));
+    return s;
+}
+
+/// Closes the open bucket of @p level: history, then cascade upwards.
+void close(ChannelState& ch, Level level) noexcept {
+    const uint8_t l = static_cast<uint8_t>(level);
+    Accumulator& open = ch.open[l];
+    if (open.count != 0U) {
+        const Bucket closed = summarise(open);
+        switch (level) {
+            case Level::MINUTE:
+                ch.minutes.push(closed);
+                break;
+            case Level::HOUR:
+                ch.hours.push(closed);
+                break;
+            default:
+                ch.days.push(closed);
+                break;
+        }
+        if (level != Level::DAY) {
+            merge(ch.open[l + 1U], open);
+        }
+    }
+    clear(open);
+}
+
+} // anonymous namespace
+
+void aggregate_add(uint32_t timestamp_ms, const SoilSensor::SensorData& data) noexcept {
+    const uint32_t minute = timestamp_ms / MS_PER_MINUTE;
+    if (!g_state.started) {
+        for (uint8_t i = 0U; i < aggregates::CHANNEL_COUNT; ++i) {
+            for (uint8_t l = 0U; l < LEVEL_COUNT; ++l) {
+                clear(g_state.channel[i].open[l]);
+            }
+        }
+        g_state.minute = minute;
+        g_state.started = true;
+    }
+
+    if (minute != g_state.minute) {
+        const bool hourChanged = (minute / MINUTES_PER_HOUR) != (g_state.minute / MINUTES_PER_HOUR);
+        const bool dayChanged = (minute / MINUTES_PER_DAY) != (g_state.minute / MINUTES_PER_DAY);
+        for (uint8_t i = 0U; i < aggregates::CHANNEL_COUNT; ++i) {
+            close(g_state.channel[i], Level::MINUTE);
+            if (hourChanged) {
+                close(g_state.channel[i], Level::HOUR);
+            }
+            if (dayChanged) {
+                close(g_state.channel[i], Level::DAY);
+            }
+        }
+        g_state.minute = minute;
+    }
+
+    for (uint8_t i = 0U; i < aggregates::CHANNEL_COUNT; ++i) {
+        const int16_t v = channels::value(data, aggregates::CHANNELS[i]);
+        Accumulator& a = g_state.channel[i].open[static_cast<uint8_t>(Level::MINUTE)];
+        if ((v != channels::GAP) && (a.count != 0xFFFFU)) {
+            ++a.count;
+            a.min = (v < a.min) ? v : a.min;
+            a.max = (v > a.max) ? v : a.max;
+            a.sum += v;
+            a.sumsq += static_cast<uint32_t>(static_cast<int32_t>(v) * v);
+        }
+    }
+}
+
+bool aggregate_get(uint8_t slot, aggregate::Level level, uint8_t age, aggregate::Summary& out) noexcept {
+    if ((slot >= aggregates::CHANNEL_COUNT) || !g_state.started) {
+        return false;
+    }
+    const ChannelState& ch = g_state.channel[slot];
+    const uint8_t l = static_cast<uint8_t>(level);
+
+    if (age == 0U) {
+        // The open bucket plus whatever has not cascaded into it yet
+        Accumulator a = {};
+        clear(a);
+        for (uint8_t lower = 0U; lower <= l; ++lower) {
+            merge(a, ch.open[lower]);
+        }
+        if (a.count == 0U) {
+            return false;
+        }
+        out = summarise(a);
+        return true;
+    }
+
+    const Bucket* b = nullptr;
+    switch (level) {
+        case Level::MINUTE:
+            b = ch.minutes.get(static_cast<uint8_t>(age - 1U));
+            break;
+        case Level::HOUR:
+            b = ch.hours.get(static_cast<uint8_t>(age - 1U));
+            break;
+        default:
+            b = ch.days.get(static_cast<uint8_t>(age - 1U));
+            break;
+    }
+    if ((b == nullptr) || (b->count == 0U)) {
+        return false;
+    }
+    out = *b;
+    return true;
+}
+
+uint8_t aggregate_depth(aggregate::Level level) noexcept {
+    switch (level) {
+        case aggregate::Level::MINUTE:
+            return aggregates::MINUTE_SLOTS;
+        case aggregate::Level::HOUR:
+            return aggregates::HOUR_SLOTS;
+        default:
+            return aggregates::DAY_SLOTS;
+    }
+}
@@ -0,0 +1,143 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <util/atomic.h>
+#include "bench.h"
+#include "setup.h"
+#include "timebase.h"
+#include "fmt.h"
+#include "tscodec.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+#ifndef F_CPU
+constexpr uint32_t F_CPU = 16000000UL;
+#endif
+constexpr uint32_t CYCLES_PER_US = static_cast<uint32_t>(F_CPU) / 1000000UL;
+
+// Characters per LCD batch: long enough to swamp the timebase resolution.
+constexpr uint8_t LCD_BENCH_CHARS = 64U;
+
+/**
+ * @brief Average CPU cycles to clock one character onto the LCD bus.
+ * @details Uses LCD::writeNow(), i.e. the bus cost alone without queueing or
+ *          execution-time waits.
+ */
+uint32_t bench_lcd_char_cycles() noexcept {
+    uint32_t elapsed_us = 0UL;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        const uint32_t start = timebase_micros();
+        for (uint8_t i = 0U; i < LCD_BENCH_CHARS; ++i) {
+            gLcd.writeNow(static_cast<uint8_t>('-'), 1U);
+        }
+        elapsed_us = timebase_micros() - start;
+    }
+    return (elapsed_us * CYCLES_PER_US) / LCD_BENCH_CHARS;
+}
+
+// Lines per formatting batch.
+constexpr uint8_t FMT_BENCH_LINES = 32U;
+
+/**
+ * @brief Average CPU cycles to build "Temp:<t> degC" for one LCD line.
+ * @param legacy true: dtostrf() + snprintf() (the former UI path);
+ *               false: fmt:: integer writers.
+ * @details The reading varies per iteration so neither path can be folded.
+ *          Building this file with ENABLE_BENCHMARKS also links the legacy
+ *          path; compare flash with and without fmt via `pio run -t size`.
+ */
+uint32_t bench_format_line_cycles(bool legacy) noexcept {
+    char tempBuf[12];
+    // Room for the longest dtostrf() result, so the legacy line never truncates
+    char line[(sizeof("Temp:") - 1U) + (sizeof(tempBuf) - 1U) + sizeof(" degC")];
+    uint8_t sink = 0U;
+    uint32_t elapsed_us = 0UL;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        const uint32_t start = timebase_micros();
+        for (uint8_t i = 0U; i < FMT_BENCH_LINES; ++i) {
+            const int16_t temperature = static_cast<int16_t>(-95 + (static_cast<int16_t>(i) * 37));  // 0.1 degC
+            if (legacy) {
+                dtostrf(static_cast<float>(temperature) / 10.0f, 0, 1, tempBuf);
+                (void)snprintf(line, sizeof(line), "Temp:%s degC", tempBuf);
+            } else {
+                uint8_t n = fmt::writeString(line, 16U, "Temp:");
+                n += fmt::writeFixed(line + n, static_cast<uint8_t>(16U - n), temperature, 1U);
+                n += fmt::writeString(line + n, static_cast<uint8_t>(16U - n), " degC");
+                fmt::terminate(line, static_cast<uint8_t>(sizeof(line)), n);
+            }
+            sink = static_cast<uint8_t>(sink ^ static_cast<uint8_t>(line[6]));
+        }
+        elapsed_us = timebase_micros() - start;
+    }
+    __asm__ __volatile__("" : : "r"(sink));  // Keep the results observable
+    return (elapsed_us * CYCLES_PER_US) / FMT_BENCH_LINES;
+}
+
+// Samples per compression batch and the block they are packed into.
+constexpr uint8_t CODEC_BENCH_SAMPLES = 32U;
+constexpr uint8_t CODEC_BENCH_CHANNELS = 7U;
+constexpr uint16_t CODEC_BENCH_BLOCK_BYTES = 128U;
+
+/**
+ * @brief Average CPU cycles for tscodec::Encoder to append one 7-channel sample.
+ * @details Values drift by a few counts per poll like real soil readings;
+ *          the block is sized so none of the appends is rejected.
+ * @param[out] block_bytes Size of the finished block.
+ */
+uint32_t bench_codec_sample_cycles(uint16_t& block_bytes) noexcept {
+    uint8_t block[CODEC_BENCH_BLOCK_BYTES];
+    int16_t values[CODEC_BENCH_CHANNELS] = { 840, 291, 237, 786, 16, 23, 46 };
+    uint32_t elapsed_us = 0UL;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        const uint32_t start = timebase_micros();
+        tscodec::Encoder enc(block, CODEC_BENCH_BLOCK_BYTES, CODEC_BENCH_CHANNELS);
+        for (uint8_t i = 0U; i < CODEC_BENCH_SAMPLES; ++i) {
+            const int16_t step = ((i & 2U) != 0U) ? 1 : -1;
+            values[i % CODEC_BENCH_CHANNELS] = static_cast<int16_t>(values[i % CODEC_BENCH_CHANNELS] + step);
+            (void)enc.append(static_cast<uint32_t>(i) * 2000UL, values);
+        }
+        block_bytes = enc.finish();
+        elapsed_us = timebase_micros() - start;
+    }
+    return (elapsed_us * CYCLES_PER_US) / CODEC_BENCH_SAMPLES;
+}
+
+void bench_print(Print& out, const char* label, uint32_t value, const char* unit) noexcept {
+    out.print("bench ");
+    out.print(label);
+    out.print(": ");
+    out.print(value);
+    out.println(unit);
+}
+
+} // anonymous namespace
+
+void bench_run(Print& out) noexcept {
+    bench_print(out, "fmt line dtostrf+snprintf", bench_format_line_cycles(true), " cycles");
+    bench_print(out, "fmt line fmt::", bench_format_line_cycles(false), " cycles");
+
+    uint16_t block_bytes = 0U;
+    bench_print(out, "tscodec append", bench_codec_sample_cycles(block_bytes), " cycles/sample");
+    bench_print(out, "tscodec 32 samples", block_bytes, " bytes");
+
+#if ENABLE_LCD
+    // Let the queued initialisation finish so the bus is ours.
+    while (gLcd.pump()) {
+    }
+
+    gLcd.setPinHooks(nullptr);
+    const uint32_t digital_write = bench_lcd_char_cycles();
+    gLcd.setPinHooks(&gLcdPinHooks);
+    const uint32_t port_write = bench_lcd_char_cycles();
+
+    bench_print(out, "lcd char digitalWrite", digital_write, " cycles");
+    bench_print(out, "lcd char gpio", port_write, " cycles");
+
+    // The benchmark scribbled over DDRAM behind the glass record.
+    gLcd.invalidate();
+    gLcd.clear();
+#else
+    (void)out;
+#endif
+}
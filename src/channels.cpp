@@ -0,0 +1,95 @@
+#include <avr/pgmspace.h>
+#include <string.h>
+#include "channels.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+    // Labels and table live in flash; string literals would be copied to RAM.
+    const char LABEL_MOISTURE[] PROGMEM = "Moist";
+    const char LABEL_TEMPERATURE[] PROGMEM = "Temp";
+    const char LABEL_CONDUCTIVITY[] PROGMEM = "Cond";
+    const char LABEL_PH[] PROGMEM = "pH";
+    const char LABEL_NITROGEN[] PROGMEM = "N";
+    const char LABEL_PHOSPHORUS[] PROGMEM = "P";
+    const char LABEL_POTASSIUM[] PROGMEM = "K";
+
+    const channels::Info INFO[channels::COUNT] PROGMEM = {
+        { LABEL_MOISTURE, 1U },
+        { LABEL_TEMPERATURE, 1U },
+        { LABEL_CONDUCTIVITY, 0U },
+        { LABEL_PH, 2U },
+        { LABEL_NITROGEN, 0U },
+        { LABEL_PHOSPHORUS, 0U },
+        { LABEL_POTASSIUM, 0U }
+    };
+
+    int16_t fromUnsigned(uint16_t v) noexcept {
+        return (v == SoilSensor::INVALID) ? channels::GAP
+             : static_cast<int16_t>((v > 32767U) ? 32767U : v);
+    }
+
+    uint16_t toUnsigned(int16_t v) noexcept {
+        return (v == channels::GAP) ? SoilSensor::INVALID
+             : static_cast<uint16_t>((v < 0) ? 0 : v);
+    }
+}
+
+namespace channels {
+
+int16_t value(const SoilSensor::SensorData& data, uint8_t ch) noexcept {
+    switch (ch) {
+        case MOISTURE:
+            return fromUnsigned(data.moisture);
+        case TEMPERATURE:
+            return (data.temperature == SoilSensor::INVALID_TEMPERATURE) ? GAP : data.temperature;
+        case CONDUCTIVITY:
+            return fromUnsigned(data.conductivity);
+        case PH:
+            return fromUnsigned(data.ph);
+        case NITROGEN:
+            return fromUnsigned(data.nitrogen);
+        case PHOSPHORUS:
+            return fromUnsigned(data.phosphorus);
+        case POTASSIUM:
+            return fromUnsigned(data.potassium);
+        default:
+            return GAP;
+    }
+}
+
+void setValue(SoilSensor::SensorData& data, uint8_t ch, int16_t v) noexcept {
+    switch (ch) {
+        case MOISTURE:
+            data.moisture = toUnsigned(v);
+            break;
+        case TEMPERATURE:
+            // GAP and INVALID_TEMPERATURE share the same bit pattern
+            data.temperature = v;
+            break;
+        case CONDUCTIVITY:
+            data.conductivity = toUnsigned(v);
+            break;
+        case PH:
+            data.ph = toUnsigned(v);
+            break;
+        case NITROGEN:
+            data.nitrogen = toUnsigned(v);
+            break;
+        case PHOSPHORUS:
+            data.phosphorus = toUnsigned(v);
+            break;
+        case POTASSIUM:
+            data.potassium = toUnsigned(v);
+            break;
+        default:
+            break;
+    }
+}
+
+Info info(uint8_t ch) noexcept {
+    Info result = {};
+    memcpy_P(&result, &INFO[(ch < COUNT) ? ch : static_cast<uint8_t>(COUNT - 1U)], sizeof(result));
+    return result;
+}
+
+} // namespace channels
@@ -0,0 +1,470 @@
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "console.h"
+#include "fmt.h"
+#include "tasks.h"
+#include "setup.h"
+#include "channels.h"
+#include "deadband.h"
+#include "aggregate.h"
+#if ENABLE_PROFILER
+#include "profiler.h"
+#endif
+#if ENABLE_TELEMETRY
+#include "telemetry.h"
+#endif
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint8_t MAX_ARGS = 3U;
+constexpr uint8_t END = 0U;      ///< Handler result: the reply is complete.
+constexpr uint8_t WAIT = 0xFFU;  ///< Handler result: nothing yet, call again.
+static_assert(console::REPLY_BYTES < WAIT, "Reply lengths must not collide with WAIT");
+
+/**
+ * @brief Parsed arguments and reply progress of the running command.
+ */
+struct Context {
+    uint32_t args[MAX_ARGS];
+    uint8_t argc;
+    uint8_t line;  ///< Reply line to produce next, from 0.
+    bool posted;   ///< The command's bus job is in flight.
+};
+
+/**
+ * @brief Produces reply line ctx.line into @p out (console::REPLY_BYTES).
+ * @return Its length (never 0), END once the reply is complete, or WAIT.
+ */
+using Handler = uint8_t (*)(Context& ctx, char* out);
+
+/**
+ * @brief Appends fields to one reply line, truncating at console::REPLY_BYTES.
+ */
+class Line {
+public:
+    explicit Line(char* out) noexcept : buf(out), n(0U) {}
+
+    Line& text(const char* pstr) noexcept {
+        n = static_cast<uint8_t>(n + fmt::writeString_P(&buf[n], room(), pstr));
+        return *this;
+    }
+    Line& num(uint32_t value) noexcept {
+        n = static_cast<uint8_t>(n + fmt::writeUnsigned(&buf[n], room(), value));
+        return *this;
+    }
+    Line& snum(int32_t value) noexcept {
+        n = static_cast<uint8_t>(n + fmt::writeSigned(&buf[n], room(), value));
+        return *this;
+    }
+    Line& hex(uint32_t value) noexcept {
+        char digits[8];
+        uint8_t count = 0U;
+        do {
+            const uint8_t nibble = static_cast<uint8_t>(value & 0xFU);
+            digits[count++] = static_cast<char>((nibble < 10U) ? ('0' + nibble) : ('a' + nibble - 10U));
+            value >>= 4;
+        } while ((value != 0UL) && (count < sizeof(digits)));
+        (void)text(PSTR("0x"));
+        while ((count > 0U) && (n < console::REPLY_BYTES)) {
+            buf[n++] = digits[--count];
+        }
+        return *this;
+    }
+    uint8_t length() const noexcept { return n; }
+
+private:
+    uint8_t room() const noexcept { return static_cast<uint8_t>(console::REPLY_BYTES - n); }
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    char* buf;
+    uint8_t n;
+};
+
+const char TASK_NAMES[scheduler::TOTAL_TASKS_NUM][8] PROGMEM = { "led", "sensor", "lcd" };
+
+uint8_t cmdHelp(Context& ctx, char* out) noexcept;
+
+uint8_t cmdSched(Context& ctx, char* out) noexcept {
+#if ENABLE_PROFILER
+    constexpr uint8_t HEADER_LINES = 2U;
+    if (ctx.line < HEADER_LINES) {
+        profiler::TickStats stats;
+        profiler_snapshot(stats);
+        Line reply(out);
+        if (ctx.line == 0U) {
+            (void)reply.text(PSTR("ticks ")).num(stats.ticks).text(PSTR(" overruns ")).num(stats.overruns);
+        } else {
+            const uint32_t avg = (stats.ticks != 0UL) ? (stats.totalTickUs / stats.ticks) : 0UL;
+            (void)reply.text(PSTR("tick avg ")).num(avg).text(PSTR(" max ")).num(stats.maxTickUs).text(PSTR(" us"));
+        }
+        return reply.length();
+    }
+#else
+    constexpr uint8_t HEADER_LINES = 0U;
+#endif
+    const uint8_t id = static_cast<uint8_t>(ctx.line - HEADER_LINES);
+    if (id >= scheduler::TOTAL_TASKS_NUM) {
+        return END;
+    }
+    uint32_t period = 0UL;
+    uint32_t offset = 0UL;
+    bool enabled = false;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        period = tasks[id].getPeriod();
+        offset = tasks[id].getOffset();
+        enabled = tasks[id].isEnabled();
+    }
+    Line reply(out);
+    (void)reply.text(TASK_NAMES[id]).text(PSTR(" ")).num(period).text(PSTR(" ms +")).num(offset);
+    if (!enabled) {
+        (void)reply.text(PSTR(" suspended"));
+    }
+    return reply.length();
+}
+
+uint8_t cmdModbus(Context& ctx, char* out) noexcept {
+    ModbusMaster::Stats stats;
+    uint8_t slave = 0U;
+    uint16_t drops = 0U;
+    // Updated by the sensor task inside the Timer1 ISR.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        stats = gSensor.stats();
+        slave = gSensor.slaveAddress();
+        drops = gSampleQueue.droppedCount();
+    }
+    Line reply(out);
+    switch (ctx.line) {
+        case 0U:
+            (void)reply.text(PSTR("slave ")).num(slave);
+            break;
+        case 1U:
+            (void)reply.text(PSTR("req ")).num(stats.requests).text(PSTR(" ok ")).num(stats.responses)
+                       .text(PSTR(" exc ")).num(stats.exceptions);
+            break;
+        case 2U:
+            (void)reply.text(PSTR("timeout ")).num(stats.timeouts).text(PSTR(" crc ")).num(stats.crcErrors)
+                       .text(PSTR(" bad ")).num(stats.badFrames);
+            break;
+        case 3U:
+            (void)reply.text(PSTR("queue drops ")).num(drops);
+            break;
+        default:
+            break;
+    }
+    return (reply.length() != 0U) ? reply.length() : END;
+}
+
+/**
+ * @brief Posts a job to the sensor task and reports its outcome.
+ */
+uint8_t busCommand(Context& ctx, char* out, BusJob::Op op) noexcept {
+    if (ctx.line != 0U) {
+        return END;
+    }
+    Line reply(out);
+#if ENABLE_SENSOR
+    BusJob job = {};
+    if (!ctx.posted) {
+        if ((ctx.args[0] > 0xFFFFUL) || (ctx.args[1] > 0xFFFFUL)) {
+            return reply.text(PSTR("out of range")).length();
+        }
+        job.op = op;
+        job.reg = static_cast<uint16_t>(ctx.args[0]);
+        job.value = static_cast<uint16_t>(ctx.args[1]);
+        if (!gBusJobs.post(job)) {
+            return reply.text(PSTR("bus busy")).length();
+        }
+        ctx.posted = true;
+        return WAIT;
+    }
+    if (!gBusJobs.collect(job)) {
+        return WAIT;
+    }
+    ctx.posted = false;
+    const bool ok = (job.status == ModbusMaster::ku8MBSuccess);
+    if (op == BusJob::Op::DISCOVER) {
+        (void)reply.text(ok ? PSTR("found slave ") : PSTR("no reply; slave "))
+                   .num(job.address).text(PSTR(" at ")).num(job.baud);
+    } else if (!ok) {
+        (void)reply.hex(job.reg).text(PSTR(" error ")).hex(job.status);
+    } else if (op == BusJob::Op::READ) {
+        (void)reply.hex(job.reg).text(PSTR(" = ")).num(job.value);
+    } else {
+        (void)reply.hex(job.reg).text(PSTR(" written"));
+    }
+#else
+    (void)op;
+    (void)reply.text(PSTR("sensor disabled"));
+#endif
+    return reply.length();
+}
+
+uint8_t cmdRead(Context& ctx, char* out) noexcept {
+    return busCommand(ctx, out, BusJob::Op::READ);
+}
+
+uint8_t cmdWrite(Context& ctx, char* out) noexcept {
+    return busCommand(ctx, out, BusJob::Op::WRITE);
+}
+
+uint8_t cmdDiscover(Context& ctx, char* out) noexcept {
+    return busCommand(ctx, out, BusJob::Op::DISCOVER);
+}
+
+uint8_t cmdPeriod(Context& ctx, char* out) noexcept {
+    if (ctx.line != 0U) {
+        return END;
+    }
+    Line reply(out);
+    const uint8_t id = static_cast<uint8_t>(ctx.args[0]);
+    if ((ctx.args[0] >= scheduler::TOTAL_TASKS_NUM) || !scheduler_task_set_period(id, ctx.args[1])) {
+        return reply.text(PSTR("bad task or period")).length();
+    }
+    return reply.text(TASK_NAMES[id]).text(PSTR(" ")).num(ctx.args[1]).text(PSTR(" ms")).length();
+}
+
+uint8_t cmdBand(Context& ctx, char* out) noexcept {
+    if (ctx.line != 0U) {
+        return END;
+    }
+    Line reply(out);
+    const uint8_t ch = static_cast<uint8_t>(ctx.args[0]);
+    if (ctx.args[0] >= channels::COUNT) {
+        return reply.text(PSTR("bad channel")).length();
+    }
+    if (ctx.argc >= 3U) {
+        const deadband::Band band = { (ctx.args[1] != 0UL) ? deadband::Mode::RELATIVE : deadband::Mode::ABSOLUTE,
+                                      static_cast<uint16_t>(ctx.args[2]) };
+        if ((ctx.args[2] > 0xFFFFUL) || !deadband_configure(ch, band)) {
+            return reply.text(PSTR("out of range")).length();
+        }
+    }
+    const deadband::Band band = deadband_get(ch);
+    return reply.text(PSTR("ch ")).num(ch)
+                .text((band.mode == deadband::Mode::RELATIVE) ? PSTR(" rel ") : PSTR(" abs "))
+                .num(band.threshold).length();
+}
+
+uint8_t cmdAggregate(Context& ctx, char* out) noexcept {
+    aggregate::Summary s = {};
+    Line reply(out);
+    if ((ctx.args[0] >= aggregate::LEVEL_COUNT) || (ctx.args[1] > 0xFFUL) || (ctx.args[2] > 0xFFUL) ||
+        !aggregate_get(static_cast<uint8_t>(ctx.args[2]), static_cast<aggregate::Level>(ctx.args[0]),
+                       static_cast<uint8_t>(ctx.args[1]), s)) {
+        return (ctx.line == 0U) ? reply.text(PSTR("no data")).length() : END;
+    }
+    if (ctx.line == 0U) {
+        return reply.text(PSTR("n ")).num(s.count).text(PSTR(" min ")).snum(s.min)
+                    .text(PSTR(" max ")).snum(s.max).length();
+    }
+    if (ctx.line == 1U) {
+        return reply.text(PSTR("mean ")).snum(s.mean).text(PSTR(" sd ")).num(s.stddev).length();
+    }
+    return END;
+}
+
+/**
+ * @brief One console command.
+ * @details The usage text starts with the command name, which is what a
+ *          command line is matched against; the rest is the synopsis that
+ *          "help" prints.
+ */
+struct Command {
+    char usage[24];
+    Handler handler;
+    uint8_t minArgs;
+};
+
+const Command COMMANDS[] PROGMEM = {
+    { "help", &cmdHelp, 0U },
+    { "sched", &cmdSched, 0U },
+    { "modbus", &cmdModbus, 0U },
+    { "rd <reg>", &cmdRead, 1U },
+    { "wr <reg> <value>", &cmdWrite, 2U },
+    { "discover", &cmdDiscover, 0U },
+    { "period <task> <ms>", &cmdPeriod, 2U },
+    { "band <ch> [rel thr]", &cmdBand, 1U },
+    { "agg <lvl> [age] [slot]", &cmdAggregate, 1U }
+};
+constexpr uint8_t COMMAND_COUNT = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+uint8_t cmdHelp(Context& ctx, char* out) noexcept {
+    if (ctx.line >= COMMAND_COUNT) {
+        return END;
+    }
+    return Line(out).text(COMMANDS[ctx.line].usage).length();
+}
+
+// JSF AV C++ Rule 70: No volatile; the console only runs in the idle loop.
+char g_line[console::LINE_BYTES + 1U] = {};
+uint8_t g_lineLength = 0U;
+bool g_lineOverflow = false;  ///< Discarding input until the next line end.
+char g_out[console::REPLY_BYTES] = {};
+uint8_t g_outLength = 0U;     ///< Reply line waiting for TX room; 0 if none.
+Context g_ctx = {};
+Handler g_handler = nullptr;  ///< Command producing the reply, if any.
+
+/// Sends the pending reply line. @return false if the UART had no room yet.
+bool emit() noexcept {
+#if ENABLE_TELEMETRY
+    if (!telemetry_reply(g_out, g_outLength)) {
+        return false;
+    }
+#else
+    if (static_cast<uint8_t>(Serial.availableForWrite()) < (g_outLength + 2U)) {
+        return false;
+    }
+    (void)Serial.write(reinterpret_cast<const uint8_t*>(g_out), g_outLength);
+    (void)Serial.write(reinterpret_cast<const uint8_t*>("\r\n"), 2U);
+#endif
+    g_outLength = 0U;
+    return true;
+}
+
+void replyText(const char* pstr) noexcept {
+    g_outLength = Line(g_out).text(pstr).length();
+}
+
+/// True if @p name equals the first word of the PROGMEM @p usage.
+bool matches(const char* name, const char* usage) noexcept {
+    for (uint8_t i = 0U; ; ++i) {
+        const char c = static_cast<char>(pgm_read_byte(&usage[i]));
+        const bool usageEnd = (c == '\0') || (c == ' ');
+        if (name[i] == '\0') {
+            return usageEnd;
+        }
+        if (usageEnd || (c != name[i])) {
+            return false;
+        }
+    }
+}
+
+/// Parses a decimal or 0x-prefixed hex number. @return false if malformed.
+bool parseNumber(const char* s, uint32_t& out) noexcept {
+    uint8_t base = 10U;
+    if ((s[0] == '0') && ((s[1] == 'x') || (s[1] == 'X'))) {
+        base = 16U;
+        s += 2;
+    }
+    if (*s == '\0') {
+        return false;
+    }
+    uint32_t value = 0UL;
+    for (; *s != '\0'; ++s) {
+        const char c = *s;
+        uint8_t digit = 0U;
+        if ((c >= '0') && (c <= '9')) {
+            digit = static_cast<uint8_t>(c - '0');
+        } else if ((base == 16U) && (c >= 'a') && (c <= 'f')) {
+            digit = static_cast<uint8_t>(c - 'a' + 10);
+        } else if ((base == 16U) && (c >= 'A') && (c <= 'F')) {
+            digit = static_cast<uint8_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        value = (value * base) + digit;
+    }
+    out = value;
+    return true;
+}
+
+/// Splits g_line in place, looks up the command and starts it.
+void dispatch() noexcept {
+    const char* words[MAX_ARGS + 1U] = {};
+    uint8_t count = 0U;
+    for (uint8_t i = 0U; g_line[i] != '\0'; ++i) {
+        if (g_line[i] == ' ') {
+            g_line[i] = '\0';
+        } else if ((i == 0U) || (g_line[i - 1U] == '\0')) {
+            if (count > MAX_ARGS) {
+                replyText(PSTR("too many arguments"));
+                return;
+            }
+            words[count++] = &g_line[i];
+        }
+    }
+    if (count == 0U) {
+        return;
+    }
+
+    uint8_t index = 0U;
+    while ((index < COMMAND_COUNT) && !matches(words[0], COMMANDS[index].usage)) {
+        ++index;
+    }
+    if (index == COMMAND_COUNT) {
+        replyText(PSTR("unknown command; try help"));
+        return;
+    }
+
+    g_ctx = Context();
+    g_ctx.argc = static_cast<uint8_t>(count - 1U);
+    for (uint8_t i = 0U; i < g_ctx.argc; ++i) {
+        if (!parseNumber(words[i + 1U], g_ctx.args[i])) {
+            replyText(PSTR("bad number"));
+            return;
+        }
+    }
+    if (g_ctx.argc < pgm_read_byte(&COMMANDS[index].minArgs)) {
+        g_outLength = Line(g_out).text(PSTR("usage: ")).text(COMMANDS[index].usage).length();
+        return;
+    }
+    g_handler = reinterpret_cast<Handler>(pgm_read_ptr(&COMMANDS[index].handler));
+}
+
+/// Collects input up to a line end. @return true once g_line holds a line.
+bool readLine() noexcept {
+    while (Serial.available() > 0) {
+        const char c = static_cast<char>(Serial.read());
+        if ((c == '\r') || (c == '\n')) {
+            if (g_lineOverflow) {
+                g_lineOverflow = false;
+                g_lineLength = 0U;
+                replyText(PSTR("line too long"));
+                return false;
+            }
+            if (g_lineLength == 0U) {
+                continue;  // Blank line, or the LF of a CRLF
+            }
+            g_line[g_lineLength] = '\0';
+            g_lineLength = 0U;
+            return true;
+        }
+        if ((c == '\b') || (c == '\x7f')) {
+            g_lineLength = (g_lineLength > 0U) ? static_cast<uint8_t>(g_lineLength - 1U) : 0U;
+        } else if ((c < ' ') || (c > '~')) {
+            // Control and non-ASCII bytes are ignored
+        } else if (g_lineLength < console::LINE_BYTES) {
+            g_line[g_lineLength++] = c;
+        } else {
+            g_lineOverflow = true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+void console_poll() noexcept {
+    if ((g_outLength != 0U) && !emit()) {
+        return;
+    }
+    if (g_handler != nullptr) {
+        const uint8_t n = g_handler(g_ctx, g_out);
+        if (n == END) {
+            g_handler = nullptr;
+        } else if (n != WAIT) {
+            g_outLength = n;
+            ++g_ctx.line;
+            (void)emit();
+        }
+        return;
+    }
+    if (readLine()) {
+        dispatch();
+    }
+    if (g_outLength != 0U) {
+        (void)emit();
+    }
+}
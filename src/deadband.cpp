@@ -0,0 +1,87 @@
+#include "deadband.h"
+#include "tasks.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+    using deadband::Band;
+    using deadband::Mode;
+
+    // Index order: moisture, temperature, conductivity, pH, N, P, K.
+    // About one display step of slack; EC spans decades, so it is relative.
+    // JSF AV C++ Rule 70: No volatile; configured and read from the idle loop only.
+    Band g_bands[channels::COUNT] = {
+        { Mode::ABSOLUTE, 5U },   // 0.5 %
+        { Mode::ABSOLUTE, 3U },   // 0.3 degC
+        { Mode::RELATIVE, 20U },  // 2 %
+        { Mode::ABSOLUTE, 5U },   // 0.05 pH
+        { Mode::ABSOLUTE, 2U },   // 2 mg/kg
+        { Mode::ABSOLUTE, 2U },
+        { Mode::ABSOLUTE, 2U }
+    };
+
+    bool outside(const Band& band, int16_t reference, int16_t value) noexcept {
+        if ((reference == channels::GAP) || (value == channels::GAP)) {
+            return reference != value;
+        }
+        const int32_t diff = static_cast<int32_t>(value) - reference;
+        const uint32_t magnitude = static_cast<uint32_t>((diff < 0L) ? -diff : diff);
+        if (band.mode == Mode::ABSOLUTE) {
+            return magnitude > band.threshold;
+        }
+        const uint32_t base = static_cast<uint32_t>((reference < 0) ? -static_cast<int32_t>(reference) : reference);
+        return (magnitude * 1000UL) > (static_cast<uint32_t>(band.threshold) * base);
+    }
+}
+
+namespace deadband {
+
+Gate::Gate(uint32_t min_interval_ms, uint32_t heartbeat_ms) noexcept
+    : last(), lastMs(0UL), minIntervalMs(min_interval_ms), heartbeatMs(heartbeat_ms),
+      lastOk(false), primed(false), suppressed(0U) {}
+
+bool Gate::due(const Sample& sample) const noexcept {
+    if (!primed) {
+        return true;
+    }
+    const uint32_t elapsed = sample.timestampMs - lastMs;
+    bool changed = (sample.ok != lastOk);
+    for (uint8_t ch = 0U; (ch < channels::COUNT) && !changed; ++ch) {
+        changed = outside(g_bands[ch], last[ch], channels::value(sample.data, ch));
+    }
+    const bool isDue = (elapsed >= heartbeatMs) || (changed && (elapsed >= minIntervalMs));
+    if (!isDue) {
+        ++suppressed;
+    }
+    return isDue;
+}
+
+void Gate::mark(const Sample& sample) noexcept {
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        last[ch] = channels::value(sample.data, ch);
+    }
+    lastMs = sample.timestampMs;
+    lastOk = sample.ok;
+    primed = true;
+}
+
+bool Gate::pass(const Sample& sample) noexcept {
+    if (!due(sample)) {
+        return false;
+    }
+    mark(sample);
+    return true;
+}
+
+} // namespace deadband
+
+bool deadband_configure(uint8_t ch, const deadband::Band& band) noexcept {
+    if (ch >= channels::COUNT) {
+        return false;
+    }
+    g_bands[ch] = band;
+    return true;
+}
+
+deadband::Band deadband_get(uint8_t ch) noexcept {
+    return g_bands[(ch < channels::COUNT) ? ch : (channels::COUNT - 1U)];
+}
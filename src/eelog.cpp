@@ -0,0 +1,282 @@
+#include <avr/eeprom.h>
+#include "eelog.h"
+#include "deadband.h"
+#include "tasks.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+using eelog::Record;
+
+constexpr uint16_t NO_SEQUENCE = 0xFFFFU;  ///< Erased EEPROM; never written as a sequence.
+
+static_assert((static_cast<uint32_t>(storage::LOG_PAGE_BYTES) * storage::LOG_PAGE_COUNT) +
+              storage::LOG_BASE <= storage::EEPROM_BYTES,
+              "EEPROM log does not fit the device");
+static_assert(storage::LOG_PAGE_BYTES >= (eelog::HEADER_BYTES + eelog::MAX_DELTA_BYTES),
+              "EEPROM log page must hold a header and at least one delta record");
+static_assert(storage::LOG_PAGE_BYTES <= 255U, "Page offsets are 8-bit");
+static_assert((eelog::END_MARKER < eelog::MIN_DELTA_BYTES) || (eelog::END_MARKER > eelog::MAX_DELTA_BYTES),
+              "The end marker must not be a valid record length");
+
+// JSF AV C++ Rule 70: No volatile; the log is only used from the idle loop.
+uint16_t g_seq = NO_SEQUENCE;        ///< Sequence number of the newest page.
+uint8_t g_page = storage::LOG_PAGE_COUNT - 1U; ///< Newest page (the one being appended to once open).
+uint8_t g_offset = 0U;               ///< Next free byte of the open page.
+bool g_open = false;                 ///< A page has been opened since boot.
+Record g_last = {};                  ///< Last staged record (delta base).
+deadband::Gate g_gate(storage::LOG_PERIOD_MS, storage::LOG_HEARTBEAT_MS);
+uint8_t g_stage[eelog::MAX_STAGE_BYTES + 1U] = {};  ///< Record, then END_MARKER if it fits.
+uint8_t g_stageLen = 0U;
+uint8_t g_stagePos = 0U;             ///< Bytes written, counted from the end of g_stage.
+uint16_t g_stageAddr = 0U;
+uint16_t g_dropped = 0U;
+
+/// CRC-8, polynomial 0x07.
+uint8_t crc8(uint8_t crc, const uint8_t* data, uint8_t len) noexcept {
+    for (uint8_t i = 0U; i < len; ++i) {
+        crc ^= data[i];
+        for (uint8_t bit = 0U; bit < 8U; ++bit) {
+            crc = static_cast<uint8_t>(((crc & 0x80U) != 0U) ? ((crc << 1) ^ 0x07U) : (crc << 1));
+        }
+    }
+    return crc;
+}
+
+/// CRC seed binding delta records to the page's sequence number.
+uint8_t seed(uint16_t seq) noexcept {
+    const uint8_t bytes[2] = { static_cast<uint8_t>(seq), static_cast<uint8_t>(seq >> 8) };
+    return crc8(0U, bytes, 2U);
+}
+
+uint16_t nextSequence(uint16_t seq) noexcept {
+    const uint16_t next = static_cast<uint16_t>(seq + 1U);
+    return (next != NO_SEQUENCE) ? next : 0U;
+}
+
+uint16_t pageAddress(uint8_t page) noexcept {
+    return static_cast<uint16_t>(storage::LOG_BASE + (static_cast<uint16_t>(page) * storage::LOG_PAGE_BYTES));
+}
+
+void readBytes(uint8_t* out, uint16_t address, uint8_t len) noexcept {
+    eeprom_read_block(out, reinterpret_cast<const void*>(address), len);
+}
+
+void put16(uint8_t* out, uint16_t v) noexcept {
+    out[0] = static_cast<uint8_t>(v);
+    out[1] = static_cast<uint8_t>(v >> 8);
+}
+
+uint16_t get16(const uint8_t* in) noexcept {
+    return static_cast<uint16_t>(in[0] | (static_cast<uint16_t>(in[1]) << 8));
+}
+
+} // anonymous namespace
+
+namespace eelog {
+
+uint8_t putVarint(uint8_t* out, uint32_t v) noexcept {
+    uint8_t n = 0U;
+    while (v >= 0x80UL) {
+        out[n++] = static_cast<uint8_t>(v | 0x80UL);
+        v >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(v);
+    return n;
+}
+
+uint8_t getVarint(const uint8_t* in, uint8_t len, uint32_t& v) noexcept {
+    v = 0UL;
+    for (uint8_t n = 0U; (n < len) && (n < 5U); ++n) {
+        v |= static_cast<uint32_t>(in[n] & 0x7FU) << (7U * n);
+        if ((in[n] & 0x80U) == 0U) {
+            return static_cast<uint8_t>(n + 1U);
+        }
+    }
+    return 0U;
+}
+
+uint8_t encodeHeader(uint8_t* out, uint16_t seq, const Record& key) noexcept {
+    put16(&out[0], seq);
+    put16(&out[2], static_cast<uint16_t>(key.seconds));
+    put16(&out[4], static_cast<uint16_t>(key.seconds >> 16));
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        put16(&out[6U + (2U * ch)], static_cast<uint16_t>(key.values[ch]));
+    }
+    out[HEADER_BYTES - 1U] = crc8(0U, out, HEADER_BYTES - 1U);
+    return HEADER_BYTES;
+}
+
+bool decodeHeader(const uint8_t* in, uint16_t& seq, Record& key) noexcept {
+    seq = get16(&in[0]);
+    if ((seq == NO_SEQUENCE) || (crc8(0U, in, HEADER_BYTES - 1U) != in[HEADER_BYTES - 1U])) {
+        return false;
+    }
+    key.seconds = static_cast<uint32_t>(get16(&in[2])) | (static_cast<uint32_t>(get16(&in[4])) << 16);
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        key.values[ch] = static_cast<int16_t>(get16(&in[6U + (2U * ch)]));
+    }
+    return true;
+}
+
+uint8_t encodeDelta(uint8_t* out, uint16_t seq, const Record& prev, const Record& cur) noexcept {
+    uint8_t n = 1U;  // Length byte, filled in below
+    n = static_cast<uint8_t>(n + putVarint(&out[n], cur.seconds - prev.seconds));
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        const int32_t delta = static_cast<int32_t>(cur.values[ch]) - prev.values[ch];
+        n = static_cast<uint8_t>(n + putVarint(&out[n], zigzag(delta)));
+    }
+    out[0] = static_cast<uint8_t>(n + 1U);
+    out[n] = crc8(seed(seq), out, n);
+    return static_cast<uint8_t>(n + 1U);
+}
+
+uint8_t decodeDelta(const uint8_t* in, uint8_t len, uint16_t seq, const Record& prev, Record& cur) noexcept {
+    // END_MARKER and stale bytes fail here, before any varint is read.
+    const uint8_t size = (len != 0U) ? in[0] : 0U;
+    if ((size < MIN_DELTA_BYTES) || (size > MAX_DELTA_BYTES) || (size > len)) {
+        return 0U;
+    }
+    uint32_t v = 0UL;
+    uint8_t n = 1U;
+    const uint8_t first = getVarint(&in[n], static_cast<uint8_t>(size - n), v);
+    if (first == 0U) {
+        return 0U;
+    }
+    n = static_cast<uint8_t>(n + first);
+    cur.seconds = prev.seconds + v;
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        const uint8_t used = getVarint(&in[n], static_cast<uint8_t>(size - n), v);
+        if (used == 0U) {
+            return 0U;
+        }
+        n = static_cast<uint8_t>(n + used);
+        cur.values[ch] = static_cast<int16_t>(prev.values[ch] + unzigzag(v));
+    }
+    if (((n + 1U) != size) || (crc8(seed(seq), in, n) != in[n])) {
+        return 0U;
+    }
+    return size;
+}
+
+} // namespace eelog
+
+void eelog_init() noexcept {
+    uint8_t buf[eelog::HEADER_BYTES];
+    Record key = {};
+    uint16_t seq = 0U;
+    g_seq = NO_SEQUENCE;
+    g_page = storage::LOG_PAGE_COUNT - 1U;
+    for (uint8_t page = 0U; page < storage::LOG_PAGE_COUNT; ++page) {
+        readBytes(buf, pageAddress(page), eelog::HEADER_BYTES);
+        if (!eelog::decodeHeader(buf, seq, key)) {
+            continue;
+        }
+        // Serial-number comparison: survives the 16-bit sequence wrapping.
+        if ((g_seq == NO_SEQUENCE) || (static_cast<int16_t>(seq - g_seq) > 0)) {
+            g_seq = seq;
+            g_page = page;
+        }
+    }
+    g_open = false;
+    g_stageLen = 0U;
+    g_stagePos = 0U;
+}
+
+bool eelog_offer(const Sample& sample) noexcept {
+    if (!g_gate.due(sample)) {
+        return false;
+    }
+    if (g_stagePos < g_stageLen) {
+        ++g_dropped;  // The gate stays unmarked, so the next sample retries
+        return false;
+    }
+
+    Record cur = {};
+    cur.seconds = sample.timestampMs / 1000UL;
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        cur.values[ch] = channels::value(sample.data, ch);
+    }
+
+    uint8_t len = 0U;
+    if (g_open) {
+        len = eelog::encodeDelta(g_stage, g_seq, g_last, cur);
+        if ((static_cast<uint16_t>(g_offset) + len) > storage::LOG_PAGE_BYTES) {
+            len = 0U;
+        }
+    }
+    if (len == 0U) {
+        // Open the next page in the ring with this sample as its key record.
+        g_page = static_cast<uint8_t>((g_page + 1U) % storage::LOG_PAGE_COUNT);
+        g_seq = nextSequence(g_seq);
+        g_offset = 0U;
+        g_open = true;
+        len = eelog::encodeHeader(g_stage, g_seq, cur);
+    }
+
+    g_stageAddr = static_cast<uint16_t>(pageAddress(g_page) + g_offset);
+    g_stageLen = len;
+    if ((static_cast<uint16_t>(g_offset) + len) < storage::LOG_PAGE_BYTES) {
+        g_stage[g_stageLen++] = eelog::END_MARKER;  // Ends the page here until the next record
+    }
+    g_stagePos = 0U;
+    g_offset = static_cast<uint8_t>(g_offset + len);
+    g_last = cur;
+    g_gate.mark(sample);
+    return true;
+}
+
+bool eelog_pump() noexcept {
+    if ((g_stagePos >= g_stageLen) || !eeprom_is_ready()) {
+        return false;
+    }
+    // Last byte first: the old end marker goes last, with the record complete.
+    const uint8_t index = static_cast<uint8_t>(g_stageLen - 1U - g_stagePos);
+    // update skips cells that already hold the value, saving an erase/write cycle.
+    eeprom_update_byte(reinterpret_cast<uint8_t*>(g_stageAddr + index), g_stage[index]);
+    ++g_stagePos;
+    return true;
+}
+
+uint16_t eelog_replay(eelog::Visitor visit, void* context) noexcept {
+    uint8_t buf[eelog::MAX_STAGE_BYTES];
+    uint16_t visited = 0U;
+    for (uint8_t i = 1U; i <= storage::LOG_PAGE_COUNT; ++i) {
+        const uint8_t page = static_cast<uint8_t>((g_page + i) % storage::LOG_PAGE_COUNT);
+        const uint16_t base = pageAddress(page);
+        uint16_t seq = 0U;
+        Record prev = {};
+        readBytes(buf, base, eelog::HEADER_BYTES);
+        // The newest page still shows its previous pass until the new header is complete.
+        if (!eelog::decodeHeader(buf, seq, prev) || ((page == g_page) && (seq != g_seq))) {
+            continue;
+        }
+        visit(prev, context);
+        ++visited;
+
+        uint8_t offset = eelog::HEADER_BYTES;
+        while (offset < storage::LOG_PAGE_BYTES) {
+            const uint8_t room = static_cast<uint8_t>(storage::LOG_PAGE_BYTES - offset);
+            const uint8_t len = (room < eelog::MAX_DELTA_BYTES) ? room : eelog::MAX_DELTA_BYTES;
+            Record cur = {};
+            readBytes(buf, static_cast<uint16_t>(base + offset), len);
+            const uint8_t used = eelog::decodeDelta(buf, len, seq, prev, cur);
+            if (used == 0U) {
+                break; // END_MARKER: end of this pass's data in the page
+            }
+            visit(cur, context);
+            ++visited;
+            prev = cur;
+            offset = static_cast<uint8_t>(offset + used);
+        }
+    }
+    return visited;
+}
+
+uint16_t eelog_dropped() noexcept {
+    return g_dropped;
+}
+
+uint16_t eelog_suppressed() noexcept {
+    return g_gate.suppressedCount();
+}
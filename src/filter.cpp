@@ -0,0 +1,137 @@
+#include <util/atomic.h>
+#include "filter.h"
+#include "channels.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+    using filter::Config;
+    using filter::Smoothing;
+
+    constexpr uint8_t Q = 4U;                       ///< Fractional bits of Chain::estimate.
+    constexpr int32_t Q_ONE = 1L << Q;
+    constexpr uint8_t K_BITS = 8U;                  ///< Fractional bits of the Kalman gain.
+    constexpr uint32_t K_ONE = 1UL << K_BITS;
+    constexpr uint8_t P_BITS = 8U;                  ///< Fractional bits of Chain::variance.
+    constexpr uint32_t VARIANCE_MAX = 0x00FE0000UL; ///< Keeps variance * K_ONE plus rounding in 32 bits.
+
+    // Index order: moisture, temperature, conductivity, pH, N, P, K.
+    // EC and NPK jitter most between polls: 5-tap median, then Kalman.
+    Config g_config[channels::COUNT] = {
+        { 3U, Smoothing::EMA,    2U, 0U, 0U },
+        { 3U, Smoothing::EMA,    2U, 0U, 0U },
+        { 5U, Smoothing::KALMAN, 0U, 4U, 400U },
+        { 3U, Smoothing::EMA,    2U, 0U, 0U },
+        { 5U, Smoothing::KALMAN, 0U, 1U, 25U },
+        { 5U, Smoothing::KALMAN, 0U, 1U, 25U },
+        { 5U, Smoothing::KALMAN, 0U, 1U, 25U }
+    };
+
+    filter::Chain g_chains[channels::COUNT];
+
+    bool configValid(const Config& cfg) noexcept {
+        return ((cfg.medianTaps == 1U) || (cfg.medianTaps == 3U) || (cfg.medianTaps == 5U)) &&
+               ((cfg.smoothing != Smoothing::EMA) || ((cfg.emaShift >= 1U) && (cfg.emaShift <= 7U))) &&
+               ((cfg.smoothing != Smoothing::KALMAN) || (cfg.kalmanR != 0U));
+    }
+
+    int16_t fromQ(int32_t value) noexcept {
+        // Round to nearest; division keeps the rounding symmetric around zero.
+        return static_cast<int16_t>((value >= 0L) ? ((value + (Q_ONE / 2L)) / Q_ONE)
+                                                  : ((value - (Q_ONE / 2L)) / Q_ONE));
+    }
+}
+
+namespace filter {
+
+Chain::Chain() noexcept
+    : window(), next(0U), filled(0U), estimate(0L), variance(0UL), primed(false) {}
+
+void Chain::reset() noexcept {
+    next = 0U;
+    filled = 0U;
+    estimate = 0L;
+    variance = 0UL;
+    primed = false;
+}
+
+int16_t Chain::median(uint8_t taps) const noexcept {
+    // Most recent min(taps, filled) samples, insertion-sorted: at most 5 elements.
+    const uint8_t n = (filled < taps) ? filled : taps;
+    int16_t sorted[MEDIAN_MAX_TAPS];
+    for (uint8_t i = 0U; i < n; ++i) {
+        const uint8_t slot = static_cast<uint8_t>((next + MEDIAN_MAX_TAPS - 1U - i) % MEDIAN_MAX_TAPS);
+        const int16_t v = window[slot];
+        uint8_t j = i;
+        while ((j > 0U) && (sorted[j - 1U] > v)) {
+            sorted[j] = sorted[j - 1U];
+            --j;
+        }
+        sorted[j] = v;
+    }
+    return sorted[n / 2U];
+}
+
+int16_t Chain::update(int16_t raw, const Config& cfg) noexcept {
+    if (raw == channels::GAP) {
+        return channels::GAP;
+    }
+
+    // Stage 1: median over the last medianTaps raw samples
+    window[next] = raw;
+    next = static_cast<uint8_t>((next + 1U) % MEDIAN_MAX_TAPS);
+    if (filled < MEDIAN_MAX_TAPS) {
+        ++filled;
+    }
+    const int16_t x = (cfg.medianTaps > 1U) ? median(cfg.medianTaps) : raw;
+
+    // Stage 2: smoothing
+    const int32_t xq = static_cast<int32_t>(x) * Q_ONE;
+    if (!primed) {
+        estimate = xq;
+        variance = static_cast<uint32_t>(cfg.kalmanR) << P_BITS;
+        primed = true;
+        return x;
+    }
+    switch (cfg.smoothing) {
+        case Smoothing::EMA:
+            estimate += (xq - estimate) / (1L << cfg.emaShift);
+            break;
+        case Smoothing::KALMAN: {
+            // Predict: random walk adds Q; update: gain K = P / (P + R), rounded.
+            const uint32_t r = static_cast<uint32_t>(cfg.kalmanR) << P_BITS;
+            uint32_t p = variance + (static_cast<uint32_t>(cfg.kalmanQ) << P_BITS);
+            p = (p > VARIANCE_MAX) ? VARIANCE_MAX : p;
+            const uint32_t k = ((p * K_ONE) + ((p + r) / 2UL)) / (p + r);
+            estimate += ((xq - estimate) * static_cast<int32_t>(k)) / static_cast<int32_t>(K_ONE);
+            variance = (p * (K_ONE - k)) / K_ONE;
+            break;
+        }
+        default:
+            estimate = xq;
+            break;
+    }
+    return fromQ(estimate);
+}
+
+} // namespace filter
+
+void filter_apply(SoilSensor::SensorData& data) noexcept {
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        Config cfg = {};
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            cfg = g_config[ch];  // filter_configure() may run in another context
+        }
+        channels::setValue(data, ch, g_chains[ch].update(channels::value(data, ch), cfg));
+    }
+}
+
+bool filter_configure(uint8_t ch, const filter::Config& cfg) noexcept {
+    if ((ch >= channels::COUNT) || !configValid(cfg)) {
+        return false;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_config[ch] = cfg;
+        g_chains[ch].reset();
+    }
+    return true;
+}
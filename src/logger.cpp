@@ -0,0 +1,140 @@
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "logger.h"
+#include "lockfree.h"
+#include "timebase.h"
+#include "fmt.h"
+#if ENABLE_TELEMETRY
+#include "telemetry.h"
+#endif
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+/**
+ * @brief One queued message, formatted only when drained.
+ */
+struct Entry {
+    uint32_t timestampMs;
+    const char* format;   ///< PROGMEM
+    int32_t args[2];
+    logger::Level level;
+};
+
+#if !ENABLE_TELEMETRY
+constexpr char LEVEL_TAGS[] = { 'E', 'W', 'I', 'D' };
+
+// "[W 4294967295] text\r\n": prefix, timestamp digits, separator, text, EOL.
+constexpr uint8_t PREFIX_CHARS = 3U;
+constexpr uint8_t TIMESTAMP_DIGITS = 10U;  // UINT32_MAX
+constexpr uint8_t SEPARATOR_CHARS = 2U;
+constexpr uint8_t EOL_CHARS = 2U;
+constexpr uint8_t LINE_CHARS = PREFIX_CHARS + TIMESTAMP_DIGITS + SEPARATOR_CHARS + logger::MAX_TEXT + EOL_CHARS;
+#endif
+
+// Producers at different interrupt levels are serialised with ATOMIC_BLOCK;
+// the idle-loop consumer side of the ring is lock-free.
+lockfree::SpscRing<Entry, buffers::LOG_QUEUE_DEPTH> g_ring;
+
+/**
+ * @brief Expands @p e's format into @p out.
+ * @return Characters written (at most logger::MAX_TEXT).
+ */
+uint8_t format(const Entry& e, char* out) noexcept {
+    uint8_t n = 0U;
+    uint8_t arg = 0U;
+    const char* p = e.format;
+    for (char c = static_cast<char>(pgm_read_byte(p)); (c != '\0') && (n < logger::MAX_TEXT);
+         c = static_cast<char>(pgm_read_byte(++p))) {
+        if (c != '%') {
+            out[n++] = c;
+            continue;
+        }
+        const char spec = static_cast<char>(pgm_read_byte(++p));
+        const uint8_t cap = static_cast<uint8_t>(logger::MAX_TEXT - n);
+        const int32_t value = (arg < 2U) ? e.args[arg] : 0L;
+        switch (spec) {
+            case 'd':
+                n = static_cast<uint8_t>(n + fmt::writeSigned(&out[n], cap, value));
+                ++arg;
+                break;
+            case 'u':
+                n = static_cast<uint8_t>(n + fmt::writeUnsigned(&out[n], cap, static_cast<uint32_t>(value)));
+                ++arg;
+                break;
+            case 'x': {
+                // Hex keeps the digits of 16-bit codes readable without a leading sign.
+                uint32_t v = static_cast<uint32_t>(value);
+                char digits[8];
+                uint8_t count = 0U;
+                do {
+                    const uint8_t nibble = static_cast<uint8_t>(v & 0xFU);
+                    digits[count++] = static_cast<char>((nibble < 10U) ? ('0' + nibble) : ('a' + nibble - 10U));
+                    v >>= 4;
+                } while ((v != 0UL) && (count < sizeof(digits)));
+                while ((count > 0U) && (n < logger::MAX_TEXT)) {
+                    out[n++] = digits[--count];
+                }
+                ++arg;
+                break;
+            }
+            case '\0':
+                return n;  // Lone '%' at the end
+            default:
+                out[n++] = spec;  // "%%" and unknown conversions print literally
+                break;
+        }
+    }
+    return n;
+}
+
+} // anonymous namespace
+
+void logger_enqueue(logger::Level level, const char* format_P, int32_t a, int32_t b) noexcept {
+    const Entry e = { timebase_millis(), format_P, { a, b }, level };
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        (void)g_ring.push(e);  // Full: dropped and counted
+    }
+}
+
+void logger_drain() noexcept {
+    const Entry* e = nullptr;
+    while ((e = g_ring.peek()) != nullptr) {
+        char text[logger::MAX_TEXT];
+        const uint8_t len = format(*e, text);
+#if ENABLE_TELEMETRY
+        if (!telemetry_log(static_cast<uint8_t>(e->level), e->timestampMs, text, len)) {
+            return;  // No TX room yet; retry on the next pass
+        }
+#else
+        char line[LINE_CHARS];
+        uint8_t n = 0U;
+        line[n++] = '[';
+        line[n++] = LEVEL_TAGS[static_cast<uint8_t>(e->level) & 3U];
+        line[n++] = ' ';
+        n = static_cast<uint8_t>(n + fmt::writeUnsigned(&line[n], TIMESTAMP_DIGITS, e->timestampMs));
+        line[n++] = ']';
+        line[n++] = ' ';
+        // The room left always covers the text and EOL; the bound is belt and braces.
+        for (uint8_t i = 0U; (i < len) && (n < (LINE_CHARS - EOL_CHARS)); ++i) {
+            line[n++] = text[i];
+        }
+        line[n++] = '\r';
+        line[n++] = '\n';
+        if (static_cast<uint8_t>(Serial.availableForWrite()) < n) {
+            return;
+        }
+        (void)Serial.write(reinterpret_cast<const uint8_t*>(line), n);
+#endif
+        g_ring.discard();
+    }
+}
+
+uint16_t logger_dropped() noexcept {
+    uint16_t dropped = 0U;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        dropped = g_ring.droppedCount();
+    }
+    return dropped;
+}
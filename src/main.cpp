@@ -1,6 +1,25 @@
 #include <Arduino.h>
 // Keep main minimal; setup APIs moved to setup.cpp
 #include "setup.h"
+#include "config.h"
+#include "timebase.h"
+#include "tasks.h"
+#include "logger.h"
+#if ENABLE_PROFILER
+#include "profiler.h"
+#endif
+#if ENABLE_BENCHMARKS
+#include "bench.h"
+#endif
+#if ENABLE_EEPROM_LOG
+#include "eelog.h"
+#endif
+#if ENABLE_TELEMETRY
+#include "telemetry.h"
+#endif
+#if ENABLE_CONSOLE
+#include "console.h"
+#endif
 
 int main(void) {
     // Manually call the Arduino core init function.
@@ -12,10 +31,45 @@ int main(void) {
     // Enable global interrupts
     sei();
 
+#if ENABLE_BENCHMARKS
+    bench_run(Serial);
+#endif
+
+#if ENABLE_PROFILER
+    uint32_t lastReportMs = timebase_millis();
+#endif
+
     // The scheduler takes over from here.
     while (true) {
         // This loop will be preempted by the timer interrupt for task scheduling.
         // It can be used for low-priority background processing or power-saving modes.
+        Idle_DrainSamples();
+        logger_drain(); // Format and send queued log messages as TX room allows
+#if ENABLE_LCD
+        (void)gLcd.pump(); // Clock out queued LCD commands as they become due
+#endif
+#if ENABLE_EEPROM_LOG
+        (void)eelog_pump(); // One EEPROM byte per pass; each takes ~3.4 ms in hardware
+#endif
+#if ENABLE_TELEMETRY
+        telemetry_poll(timebase_millis());
+#endif
+#if ENABLE_CONSOLE
+        console_poll(); // One reply line per pass; bus commands go to the sensor task
+#endif
+#if ENABLE_PROFILER
+        const uint32_t nowMs = timebase_millis();
+        if ((nowMs - lastReportMs) >= timing::PROFILER_REPORT_PERIOD_MS) {
+            lastReportMs = nowMs;
+#if ENABLE_TELEMETRY
+            profiler::TickStats stats;
+            profiler_snapshot(stats);
+            telemetry_profiler(stats);
+#else
+            profiler_report(Serial);
+#endif
+        }
+#endif
     }
 
     return 0; // This line is unreachable.
@@ -0,0 +1,245 @@
+#include <avr/pgmspace.h>
+#include <string.h>
+#include "pages.h"
+#include "lcd.h"
+#include "fmt.h"
+#include "tasks.h"
+#include "trend.h"
+#include "channels.h"
+#include "setup.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+using pages::Field;
+using pages::Kind;
+using pages::Page;
+
+// JSF AV C++ Rule 10: constexpr helpers (C++11 single-return form) so that
+// every layout is checked against the display size at compile time.
+constexpr uint8_t textLength(const char* text) noexcept {
+    return (text == nullptr || *text == '\0') ? 0U : static_cast<uint8_t>(1U + textLength(text + 1));
+}
+
+constexpr bool fieldFits(const Field& f) noexcept {
+    return (f.row < LCD::ROWS) &&
+           ((f.col + f.width + ((f.kind == Kind::READING) ? textLength(f.text) : 0U)) <= LCD::COLS);
+}
+
+template <uint8_t N>
+constexpr bool fieldsFit(const Field (&fields)[N], uint8_t i = 0U) noexcept {
+    return (i >= N) || (fieldFits(fields[i]) && fieldsFit(fields, static_cast<uint8_t>(i + 1U)));
+}
+
+// Static labels (PROGMEM)
+constexpr char TXT_TEMP[] PROGMEM = "Temp:";
+constexpr char TXT_MOIST[] PROGMEM = "Moist:";
+constexpr char TXT_PH[] PROGMEM = "pH:";
+constexpr char TXT_COND[] PROGMEM = "Cond:";
+constexpr char TXT_N[] PROGMEM = "N:";
+constexpr char TXT_P[] PROGMEM = "P:";
+constexpr char TXT_K[] PROGMEM = "K:";
+constexpr char TXT_BAUD[] PROGMEM = "Baud:";
+constexpr char TXT_STATUS[] PROGMEM = "Status:";
+constexpr char UNIT_DEGC[] PROGMEM = " degC";
+constexpr char UNIT_PERCENT[] PROGMEM = " %";
+constexpr char UNIT_US[] PROGMEM = " uS";
+constexpr char UNIT_MGKG[] PROGMEM = " mg/kg";
+
+// Layouts: { kind, col, row, width, channel, decimals, text }
+constexpr Field PAGE_CLIMATE[] PROGMEM = {
+    { Kind::TEXT,    0U, 0U, 5U, 0U, 0U, TXT_TEMP },
+    { Kind::READING, 5U, 0U, 5U, channels::TEMPERATURE, 1U, UNIT_DEGC },
+    { Kind::TEXT,    0U, 1U, 6U, 0U, 0U, TXT_MOIST },
+    { Kind::READING, 6U, 1U, 5U, channels::MOISTURE, 1U, UNIT_PERCENT }
+};
+
+constexpr Field PAGE_CHEMISTRY[] PROGMEM = {
+    { Kind::TEXT,    0U, 0U, 3U, 0U, 0U, TXT_PH },
+    { Kind::READING, 3U, 0U, 5U, channels::PH, 2U, nullptr },
+    { Kind::TEXT,    0U, 1U, 5U, 0U, 0U, TXT_COND },
+    { Kind::READING, 5U, 1U, 5U, channels::CONDUCTIVITY, 0U, UNIT_US }
+};
+
+constexpr Field PAGE_NUTRIENTS[] PROGMEM = {
+    { Kind::TEXT,    0U, 0U, 2U, 0U, 0U, TXT_N },
+    { Kind::READING, 2U, 0U, 4U, channels::NITROGEN, 0U, nullptr },
+    { Kind::TEXT,    7U, 0U, 2U, 0U, 0U, TXT_P },
+    { Kind::READING, 9U, 0U, 4U, channels::PHOSPHORUS, 0U, nullptr },
+    { Kind::TEXT,    0U, 1U, 2U, 0U, 0U, TXT_K },
+    { Kind::READING, 2U, 1U, 4U, channels::POTASSIUM, 0U, UNIT_MGKG }
+};
+
+constexpr Field PAGE_TREND[] PROGMEM = {
+    { Kind::TREND_SUMMARY, 0U, 0U, LCD::COLS, 0U, 0U, nullptr },
+    { Kind::TREND_BARS,    0U, 1U, LCD::COLS, 0U, 0U, nullptr }
+};
+
+constexpr Field PAGE_STATUS[] PROGMEM = {
+    { Kind::TEXT,   0U, 0U, 5U, 0U, 0U, TXT_BAUD },
+    { Kind::BAUD,   5U, 0U, 6U, 0U, 0U, nullptr },
+    { Kind::TEXT,   0U, 1U, 7U, 0U, 0U, TXT_STATUS },
+    { Kind::STATUS, 7U, 1U, 3U, 0U, 0U, nullptr }
+};
+
+static_assert(fieldsFit(PAGE_CLIMATE) && fieldsFit(PAGE_CHEMISTRY) && fieldsFit(PAGE_NUTRIENTS) &&
+              fieldsFit(PAGE_TREND) && fieldsFit(PAGE_STATUS),
+              "LCD page field outside the 16x2 display");
+
+// Display order
+constexpr Page PAGES[] PROGMEM = {
+    { PAGE_CLIMATE, sizeof(PAGE_CLIMATE) / sizeof(Field) },
+    { PAGE_CHEMISTRY, sizeof(PAGE_CHEMISTRY) / sizeof(Field) },
+    { PAGE_NUTRIENTS, sizeof(PAGE_NUTRIENTS) / sizeof(Field) },
+    { PAGE_TREND, sizeof(PAGE_TREND) / sizeof(Field) },
+    { PAGE_STATUS, sizeof(PAGE_STATUS) / sizeof(Field) }
+};
+
+static_assert(sizeof(PAGES) / sizeof(Page) == ui::LCD_PAGE_COUNT,
+              "ui::LCD_PAGE_COUNT must match the page table");
+
+/// Fixed-point reading right-aligned in @p width, or "--" when its register block failed.
+uint8_t writeReading(char* out, uint8_t cap, int16_t value, uint8_t decimals, uint8_t width) noexcept {
+    if (value != channels::GAP) {
+        return fmt::writeFixed(out, cap, value, decimals, width);
+    }
+    constexpr uint8_t DASHES = 2U;
+    uint8_t field = (width > DASHES) ? width : DASHES;
+    field = (field < cap) ? field : cap;
+    uint8_t n = 0U;
+    while (static_cast<uint8_t>(field - n) > DASHES) {  // Keep "--" right-aligned like a number
+        out[n] = ' ';
+        ++n;
+    }
+    return static_cast<uint8_t>(n + fmt::writeString(out + n, static_cast<uint8_t>(field - n), "--"));
+}
+
+// Bar heights 1-7 are CGRAM glyphs keyed BAR_KEY_BASE + height; height 8
+// is the ROM full block, so all seven bar glyphs fit the cache at once.
+constexpr uint8_t BAR_LEVELS = 8U;
+constexpr uint8_t BAR_KEY_BASE = 0x10U;
+constexpr char FULL_BLOCK = static_cast<char>(0xFF);
+
+void generateBar(uint8_t key, uint8_t (&rows)[LCD::GLYPH_ROWS]) {
+    const uint8_t height = static_cast<uint8_t>(key - BAR_KEY_BASE);
+    for (uint8_t row = 0U; row < LCD::GLYPH_ROWS; ++row) {
+        rows[row] = (row >= static_cast<uint8_t>(LCD::GLYPH_ROWS - height)) ? 0x1FU : 0x00U;
+    }
+}
+
+/**
+ * @brief Summary of the trend window: first and last valid values and range.
+ */
+struct TrendWindow {
+    int16_t history[ui::TREND_SAMPLES];
+    uint8_t count;
+    int16_t lo;
+    int16_t hi;
+    int16_t first;
+    int16_t last;
+};
+
+void loadTrend(TrendWindow& w) noexcept {
+    w.count = trend_snapshot(w.history);
+    w.lo = 32767;
+    w.hi = channels::GAP;
+    w.first = channels::GAP;
+    w.last = channels::GAP;
+    for (uint8_t i = 0U; i < w.count; ++i) {
+        const int16_t v = w.history[i];
+        if (v != channels::GAP) {
+            w.lo = (v < w.lo) ? v : w.lo;
+            w.hi = (v > w.hi) ? v : w.hi;
+            w.first = (w.first == channels::GAP) ? v : w.first;
+            w.last = v;
+        }
+    }
+}
+
+/// Label, latest value and change over the window.
+void drawTrendSummary(char* out, uint8_t cap, const TrendWindow& w) noexcept {
+    const channels::Info info = channels::info(trend_channel());
+    uint8_t n = fmt::writeString_P(out, cap, info.label);
+    n += fmt::writeString(out + n, static_cast<uint8_t>(cap - n), " ");
+    n += writeReading(out + n, static_cast<uint8_t>(cap - n), w.last, info.decimals, 0U);
+    if (w.last != channels::GAP) {
+        const int32_t delta = static_cast<int32_t>(w.last) - w.first;
+        n += fmt::writeString(out + n, static_cast<uint8_t>(cap - n), (delta >= 0) ? " +" : " ");
+        (void)fmt::writeFixed(out + n, static_cast<uint8_t>(cap - n), delta, info.decimals);
+    }
+}
+
+/**
+ * @brief One bar per sample, newest in the rightmost cell.
+ * @details Bars are scaled between the window's minimum and maximum, so the
+ *          shape shows direction even for small changes.
+ */
+void drawTrendBars(char* out, uint8_t cap, LCD& lcd, const TrendWindow& w) noexcept {
+    const uint8_t count = (w.count < cap) ? w.count : cap;
+    const uint8_t offset = static_cast<uint8_t>(cap - count);
+    const uint8_t skip = static_cast<uint8_t>(w.count - count);
+    const int32_t span = static_cast<int32_t>(w.hi) - w.lo;
+    for (uint8_t i = 0U; i < count; ++i) {
+        const int16_t v = w.history[skip + i];
+        char cell = ' ';
+        if (v != channels::GAP) {
+            const uint8_t height = (span > 0)
+                ? static_cast<uint8_t>(1 + (((static_cast<int32_t>(v) - w.lo) * (BAR_LEVELS - 1)) / span))
+                : static_cast<uint8_t>(BAR_LEVELS / 2U);
+            cell = (height >= BAR_LEVELS) ? FULL_BLOCK
+                 : lcd.glyph(static_cast<uint8_t>(BAR_KEY_BASE + height), &generateBar);
+            cell = (cell != '\0') ? cell : '_';  // No glyph slot this frame
+        }
+        out[offset + i] = cell;
+    }
+}
+
+} // anonymous namespace
+
+void pages_draw(uint8_t index, LCD& lcd, const Sample& sample) noexcept {
+    Page page = {};
+    memcpy_P(&page, &PAGES[index % ui::LCD_PAGE_COUNT], sizeof(page));
+
+    // Loaded on first use by a trend field; shared by summary and bars.
+    TrendWindow trend = {};
+    bool trendLoaded = false;
+
+    for (uint8_t i = 0U; i < page.count; ++i) {
+        Field f = {};
+        memcpy_P(&f, &page.fields[i], sizeof(f));
+        char* const out = lcd.bufferRow(f.row) + f.col;
+        const uint8_t cap = static_cast<uint8_t>(LCD::COLS - f.col);  // Layouts are checked to fit
+
+        switch (f.kind) {
+            case Kind::TEXT:
+                (void)fmt::writeString_P(out, (f.width < cap) ? f.width : cap, f.text);
+                break;
+            case Kind::READING: {
+                const uint8_t n = writeReading(out, cap, channels::value(sample.data, f.channel),
+                                               f.decimals, f.width);
+                (void)fmt::writeString_P(out + n, static_cast<uint8_t>(cap - n), f.text);
+                break;
+            }
+            case Kind::BAUD:
+                (void)fmt::writeUnsigned(out, cap, sensorBusBaud());
+                break;
+            case Kind::STATUS:
+                (void)fmt::writeString(out, cap, sample.ok ? "OK" : "ERR");
+                break;
+            case Kind::TREND_SUMMARY:
+            case Kind::TREND_BARS:
+                if (!trendLoaded) {
+                    loadTrend(trend);
+                    trendLoaded = true;
+                }
+                if (f.kind == Kind::TREND_SUMMARY) {
+                    drawTrendSummary(out, cap, trend);
+                } else {
+                    drawTrendBars(out, (f.width < cap) ? f.width : cap, lcd, trend);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#include <Arduino.h>
+#include <util/atomic.h>
+#include <string.h>
+#include "profiler.h"
+#include "timebase.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+    // JSF AV C++ Rule 70: No volatile; all access is inside ATOMIC_BLOCK.
+    profiler::TickStats g_stats = {};
+    uint8_t g_depth = 0U; ///< Nesting depth of the scheduler tick.
+}
+
+uint32_t profiler_tick_begin() noexcept {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ++g_depth;
+        if (g_depth > 1U) {
+            ++g_stats.overruns;
+        }
+    }
+    return timebase_micros();
+}
+
+void profiler_tick_end(uint32_t start_us, uint8_t released) noexcept {
+    const uint32_t duration = timebase_micros() - start_us;
+    const uint8_t bin = (released > scheduler::TOTAL_TASKS_NUM) ? scheduler::TOTAL_TASKS_NUM : released;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        --g_depth;
+        ++g_stats.ticks;
+        ++g_stats.loadHistogram[bin];
+        g_stats.totalTickUs += duration;
+        if (duration > g_stats.maxTickUs) {
+            g_stats.maxTickUs = duration;
+        }
+    }
+}
+
+void profiler_snapshot(profiler::TickStats& out) noexcept {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        out = g_stats;
+    }
+}
+
+void profiler_reset() noexcept {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        memset(&g_stats, 0, sizeof(g_stats));
+    }
+}
+
+void profiler_report(Print& out) noexcept {
+    profiler::TickStats s;
+    profiler_snapshot(s);
+
+    out.print("Ticks:");
+    out.print(s.ticks);
+    out.print(" max_us:");
+    out.print(s.maxTickUs);
+    out.print(" avg_us:");
+    out.print((s.ticks != 0U) ? (s.totalTickUs / s.ticks) : 0UL);
+    out.print(" overruns:");
+    out.println(s.overruns);
+
+    // Per-tick load histogram: releases per tick -> tick count
+    out.print("Load:");
+    for (uint8_t i = 0U; i <= scheduler::TOTAL_TASKS_NUM; ++i) {
+        out.print(' ');
+        out.print(i);
+        out.print('=');
+        out.print(s.loadHistogram[i]);
+    }
+    out.println();
+}
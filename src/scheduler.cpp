@@ -3,6 +3,9 @@
 #include <avr/interrupt.h>
 #include <util/atomic.h>
 #include <stddef.h> // For nullptr
+#if ENABLE_PROFILER
+#include "profiler.h"
+#endif
 
 // JSF AV C++ Rule 12: Use file scope for objects not visible externally.
 namespace {
@@ -25,17 +28,130 @@ void scheduler_tick() noexcept {
     }
 }
 
+bool scheduler_task_suspend(uint8_t index) noexcept {
+    return (g_scheduler_instance != nullptr) && g_scheduler_instance->suspendTask(index);
+}
+
+bool scheduler_task_resume(uint8_t index) noexcept {
+    return (g_scheduler_instance != nullptr) && g_scheduler_instance->resumeTask(index);
+}
+
+bool scheduler_task_set_period(uint8_t index, uint32_t period_ms) noexcept {
+    return (g_scheduler_instance != nullptr) && g_scheduler_instance->setTaskPeriod(index, period_ms);
+}
+
+bool scheduler_post(scheduler::TimerEvent& event, uint32_t delay_ms) noexcept {
+    return (g_scheduler_instance != nullptr) && g_scheduler_instance->post(event, delay_ms);
+}
+
+bool scheduler_cancel(scheduler::TimerEvent& event) noexcept {
+    return (g_scheduler_instance != nullptr) && g_scheduler_instance->cancel(event);
+}
+
 namespace scheduler {
 
 // JSF AV C++ Rule 39: All constructors shall be declared explicit.
-Task::Task(uint32_t period, TickFunction tick_fct) noexcept
+Task::Task(uint32_t period, TickFunction tick_fct, uint32_t offset) noexcept
     : running(false),
+      enabled(true),
       state(0),
       period(period),
+      offset(0),
       elapsedTime(0),
       tickFct(tick_fct) {
-    // JSF AV C++ Rule 43: The body of a constructor shall not be empty.
-    // Initialization is done in the member initializer list.
+    setOffset(offset);
+}
+
+void Task::setOffset(uint32_t new_offset) noexcept {
+    offset = (period != 0U) ? (new_offset % period) : 0U;
+    // A task becomes due once elapsedTime reaches its period, so starting
+    // (period - offset) in releases it at offset, offset + period, ...
+    elapsedTime = (offset != 0U) ? (period - offset) : 0U;
+}
+
+void Task::setPeriod(uint32_t new_period) noexcept {
+    period = new_period;
+    setOffset(offset);
+}
+
+namespace {
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+uint32_t gcd(uint32_t a, uint32_t b) noexcept {
+    while (b != 0U) {
+        const uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+} // anonymous namespace
+
+uint8_t planPhases(Task* tasks, uint8_t num_tasks) noexcept {
+    if ((tasks == nullptr) || (num_tasks == 0U) || (num_tasks > TOTAL_TASKS_NUM)) {
+        return 0U;
+    }
+
+    // Hyperperiod in ticks; bail out if the load table would not fit.
+    uint32_t hyper = 1U;
+    for (uint8_t i = 0U; i < num_tasks; ++i) {
+        const uint32_t p = tasks[i].getPeriod() / TASK_TICKS_GCD_IN_MS;
+        if (p == 0U) {
+            return 0U;
+        }
+        hyper = (hyper / gcd(hyper, p)) * p;
+        if (hyper > PHASE_PLAN_MAX_TICKS) {
+            return 0U;
+        }
+    }
+
+    // Place short-period tasks first: they constrain the most ticks.
+    uint8_t order[TOTAL_TASKS_NUM];
+    for (uint8_t i = 0U; i < num_tasks; ++i) {
+        order[i] = i;
+    }
+    for (uint8_t i = 1U; i < num_tasks; ++i) {
+        const uint8_t key = order[i];
+        uint8_t j = i;
+        while ((j > 0U) && (tasks[order[j - 1U]].getPeriod() > tasks[key].getPeriod())) {
+            order[j] = order[j - 1U];
+            --j;
+        }
+        order[j] = key;
+    }
+
+    uint8_t load[PHASE_PLAN_MAX_TICKS] = {};
+    uint8_t peak = 0U;
+    for (uint8_t n = 0U; n < num_tasks; ++n) {
+        Task& t = tasks[order[n]];
+        const uint8_t p = static_cast<uint8_t>(t.getPeriod() / TASK_TICKS_GCD_IN_MS);
+
+        uint8_t best_offset = 0U;
+        uint8_t best_peak = 255U;
+        uint16_t best_sum = 0xFFFFU;
+        for (uint8_t o = 0U; o < p; ++o) {
+            uint8_t cand_peak = 0U;
+            uint16_t cand_sum = 0U;
+            for (uint8_t slot = o; slot < hyper; slot = static_cast<uint8_t>(slot + p)) {
+                const uint8_t l = static_cast<uint8_t>(load[slot] + 1U);
+                cand_peak = (l > cand_peak) ? l : cand_peak;
+                cand_sum = static_cast<uint16_t>(cand_sum + load[slot]);
+            }
+            if ((cand_peak < best_peak) || ((cand_peak == best_peak) && (cand_sum < best_sum))) {
+                best_peak = cand_peak;
+                best_sum = cand_sum;
+                best_offset = o;
+            }
+        }
+
+        for (uint8_t slot = best_offset; slot < hyper; slot = static_cast<uint8_t>(slot + p)) {
+            ++load[slot];
+        }
+        peak = (best_peak > peak) ? best_peak : peak;
+        t.setOffset(static_cast<uint32_t>(best_offset) * TASK_TICKS_GCD_IN_MS);
+    }
+    return peak;
 }
 
 // JSF AV C++ Rule 39: All constructors shall be declared explicit.
@@ -55,6 +171,32 @@ void Scheduler::tick() noexcept {
         return;
     }
 
+#if ENABLE_PROFILER
+    const uint32_t tick_start = profiler_tick_begin();
+#endif
+    uint8_t released = 0U;
+
+    // One-shot callbacks due this tick are detached atomically, then run one
+    // at a time with interrupts enabled like tasks; a nested tick detaches its
+    // own batch. Each event stays pending until it is popped, so callbacks
+    // can post or cancel the rest of the batch.
+    TimerEvent* expired = nullptr;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        timers.advance(expired);
+    }
+    for (;;) {
+        TimerEvent* event = nullptr;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            event = timers.pop(expired);
+        }
+        if (event == nullptr) {
+            break;
+        }
+        sei();
+        TimerWheel::fire(*event);
+        cli();
+    }
+
     // JSF AV C++ Rule 81: Unsigned integers shall be used for indices.
     for (uint8_t index = 0; index < g_tasks_num; ++index) {
         Task& t = g_tasks[index];
@@ -63,18 +205,26 @@ void Scheduler::tick() noexcept {
         // This loop follows that rule.
 
         // JSF AV C++ Rule 60: All if statements shall be compound statements.
-        if ((t.getElapsedTime() >= t.getPeriod()) &&
+        // A non-zero state marks a resumable task suspended mid-sequence
+        // (see coroutine.h); it is resumed on every tick until it completes.
+        const bool resuming = (t.getState() != 0);
+        if (t.isEnabled() &&
+            ((t.getElapsedTime() >= t.getPeriod()) || resuming) &&
             (runningTasks[currentTask] > index) &&
             (!t.isRunning())) {
             
             // JSF AV C++ Rule 70: The volatile keyword shall not be used.
             // ATOMIC_BLOCK is used for ensuring atomicity of critical sections.
             ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-                t.resetElapsedTime();
+                // The period is measured from the start of a sequence.
+                if (!resuming) {
+                    t.resetElapsedTime();
+                }
                 t.setRunning(true);
                 currentTask++;
                 runningTasks[currentTask] = index;
             }
+            ++released;
 
             // JSF AV C++ Rule 164: Long or complex processing in an ISR shall be avoided.
             // We allow nested interrupts here so higher priority interrupts can fire,
@@ -90,8 +240,66 @@ void Scheduler::tick() noexcept {
             }
         }
 
-        t.incrementElapsedTime(TASK_TICKS_GCD_IN_MS);
+        // A suspended task keeps its phase but saturates once due.
+        if (t.isEnabled() || (t.getElapsedTime() < t.getPeriod())) {
+            t.incrementElapsedTime(TASK_TICKS_GCD_IN_MS);
+        }
+    }
+
+#if ENABLE_PROFILER
+    profiler_tick_end(tick_start, released);
+#else
+    (void)released; // suppress unused warning
+#endif
+}
+
+bool Scheduler::suspendTask(uint8_t index) noexcept {
+    if ((g_tasks == nullptr) || (index >= g_tasks_num)) {
+        return false;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_tasks[index].setEnabled(false);
+    }
+    return true;
+}
+
+bool Scheduler::resumeTask(uint8_t index) noexcept {
+    if ((g_tasks == nullptr) || (index >= g_tasks_num)) {
+        return false;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_tasks[index].setEnabled(true);
+    }
+    return true;
+}
+
+bool Scheduler::setTaskPeriod(uint8_t index, uint32_t period_ms) noexcept {
+    if ((g_tasks == nullptr) || (index >= g_tasks_num) ||
+        (period_ms == 0U) || ((period_ms % TASK_TICKS_GCD_IN_MS) != 0U)) {
+        return false;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_tasks[index].setPeriod(period_ms);
+    }
+    return true;
+}
+
+bool Scheduler::post(TimerEvent& event, uint32_t delay_ms) noexcept {
+    // Round up so the callback never fires early.
+    const uint32_t ticks = (delay_ms + (TASK_TICKS_GCD_IN_MS - 1U)) / TASK_TICKS_GCD_IN_MS;
+    bool posted = false;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        posted = timers.schedule(event, ticks);
+    }
+    return posted;
+}
+
+bool Scheduler::cancel(TimerEvent& event) noexcept {
+    bool cancelled = false;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        cancelled = timers.cancel(event);
     }
+    return cancelled;
 }
 
 } // namespace scheduler
@@ -1,11 +1,17 @@
 #include <Arduino.h>
 #include <SoftwareSerial.h>
+#include <util/atomic.h>
 #include "ModbusMaster.h"
 #include "config.h"
+#include "gpio.h"
 #include "scheduler.h"
-#include "timer.h"
+#include "timebase.h"
 #include "setup.h"
 #include "tasks.h"
+#include "logger.h"
+#if ENABLE_EEPROM_LOG
+#include "eelog.h"
+#endif
 
 // Hardware instances
 SoftwareSerial mySerial(pins::RX_PIN, pins::TX_PIN);
@@ -13,22 +19,73 @@ ModbusMaster node;
 SoilSensor gSensor(node, pins::RE_PIN, pins::DE_PIN);
 LCD gLcd(pins::LCD_RS_PIN, pins::LCD_EN_PIN, pins::LCD_D4_PIN, pins::LCD_D5_PIN, pins::LCD_D6_PIN, pins::LCD_D7_PIN);
 
+// JSF AV C++ Rule 12: static for file scope.
+namespace {
+    using LcdRs = gpio::Pin<pins::LCD_RS_PIN>;
+    using LcdEn = gpio::Pin<pins::LCD_EN_PIN>;
+    using LcdData = gpio::Bus<pins::LCD_D4_PIN, pins::LCD_D5_PIN, pins::LCD_D6_PIN, pins::LCD_D7_PIN>;
+    // RE and DE always switch together; on the Uno both sit on PORTD.
+    using Rs485Direction = gpio::Bus<pins::RE_PIN, pins::DE_PIN>;
+
+    void lcdRs(uint8_t level) { LcdRs::write(level != LOW); }
+    void lcdEn(uint8_t level) { LcdEn::write(level != LOW); }
+    void lcdData(uint8_t nibble) { LcdData::write(nibble); }
+
+    void rs485Direction(bool transmit) { Rs485Direction::write(transmit ? 0x03U : 0x00U); }
+
+    // Written by the sensor task (Timer1 ISR), read by the LCD and console.
+    uint16_t g_sensorBaud = static_cast<uint16_t>(pins::SERIAL_BAUD_RATE);
+}
+
+const LCD::PinHooks gLcdPinHooks = { &lcdRs, &lcdEn, &lcdData };
+
 void setupHardware() {
-    pinMode(pins::LED_PIN_B5, OUTPUT);
+    gpio::Pin<pins::LED_PIN_B5>::output();
 
+    #if ENABLE_TELEMETRY
+    Serial.begin(telemetry::BAUD_RATE);
+    #else
     Serial.begin(pins::SERIAL_BAUD_RATE);
-    mySerial.begin(pins::SERIAL_BAUD_RATE);
+    #endif
+    sensorBusBegin(static_cast<uint16_t>(pins::SERIAL_BAUD_RATE));
     #if ENABLE_SENSOR
+    gSensor.setDirectionHook(&rs485Direction);
     gSensor.begin(mySerial, pins::SERIAL_BAUD_RATE);
     #endif
     #if ENABLE_LCD
+    gLcd.setPinHooks(&gLcdPinHooks);
     gLcd.begin();
     #endif
+    #if ENABLE_EEPROM_LOG
+    eelog_init(); // Only page headers are read; the log itself stays in EEPROM
+    #endif
 
-    Serial.println("Soil Sensor Test - JSF Compliant Version");
+    logger_write(logger::Level::INFO, PSTR("Soil Sensor Test - JSF Compliant Version"));
 }
 
 void setupScheduler() {
+    if (scheduler::AUTO_PHASE_PLAN) {
+        const uint8_t peak = scheduler::planPhases(tasks, scheduler::TOTAL_TASKS_NUM);
+        // 0 = hyperperiod too long, offsets unchanged
+        logger_write(logger::Level::INFO, PSTR("Phase plan peak releases/tick: %u"), peak);
+    }
     scheduler_init(tasks, scheduler::TOTAL_TASKS_NUM);
-    timer1_set_period_ms(scheduler::TASK_TICKS_GCD_IN_MS);
+    if (!timebase_init(scheduler::TASK_TICKS_GCD_IN_MS * 1000UL)) {
+        logger_write(logger::Level::ERROR, PSTR("Timebase: tick period out of Timer1 range!"));
+    }
+}
+
+void sensorBusBegin(uint16_t baud) noexcept {
+    mySerial.begin(baud);
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_sensorBaud = baud;
+    }
+}
+
+uint16_t sensorBusBaud() noexcept {
+    uint16_t baud = 0U;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        baud = g_sensorBaud;
+    }
+    return baud;
 }
@@ -1,15 +1,31 @@
 #include <Arduino.h>
-#include <stdio.h>
-#include <stdlib.h>
 #include "config.h"
 #include "scheduler.h"
 #include "tasks.h"
 #include "setup.h"
 #include "lcd.h"
+#include "coroutine.h"
+#include "timebase.h"
+#include "gpio.h"
+#include "trend.h"
+#include "pages.h"
+#include "channels.h"
+#include "aggregate.h"
+#include "logger.h"
+#if ENABLE_FILTERS
+#include "filter.h"
+#endif
+#if ENABLE_EEPROM_LOG
+#include "eelog.h"
+#endif
+#if ENABLE_TELEMETRY
+#include "telemetry.h"
+#endif
 
 // Shared data
-SoilSensor::SensorData gSensorData;
-bool gLastReadOk = false;
+lockfree::SeqLockBuffer<Sample> gLatestSample;
+lockfree::SpscRing<Sample, buffers::SAMPLE_QUEUE_DEPTH> gSampleQueue;
+lockfree::Mailbox<BusJob> gBusJobs;
 
 // Tasks array
 scheduler::Task tasks[scheduler::TOTAL_TASKS_NUM] = {
@@ -19,23 +35,105 @@ scheduler::Task tasks[scheduler::TOTAL_TASKS_NUM] = {
 };
 
 int Task_ToggleLED(int state) {
-    digitalWrite(pins::LED_PIN_B5, !digitalRead(pins::LED_PIN_B5));
+    gpio::Pin<pins::LED_PIN_B5>::toggle();
     return state;
 }
 
 int Task_SoilSensor(int state) {
     #if ENABLE_SENSOR
-    if (!gSensor.readAll(gSensorData)) {
-        Serial.println("Failed to read from sensor!");
-        gLastReadOk = false;
-    } else {
-        gLastReadOk = true;
+    // Resumable sequence: each block's request is sent, then the task yields
+    // until the reply has arrived instead of spinning inside the tick.
+    // JSF AV C++ Rule 18: statics keep their value across yields.
+    static Sample sample = {};
+    static SoilSensor::SensorData raw = {};
+    static uint8_t block = 0U;
+    static uint8_t result = ModbusMaster::ku8MBSuccess;
+    static bool failing = false;
+    static BusJob job = {};
+    static uint8_t attempt = 0U;
+
+    TASK_BEGIN(state);
+    // An on-demand job runs first; the poll follows it in the same sequence.
+    if (gBusJobs.take(job)) {
+        if (job.op == BusJob::Op::DISCOVER) {
+            job.address = gSensor.slaveAddress();
+            job.baud = sensorBusBaud();
+            job.status = ModbusMaster::ku8MBResponseTimedOut;
+            for (attempt = 0U; attempt < (sensor_bus::DISCOVERY_BAUD_COUNT * sensor_bus::DISCOVERY_MAX_ADDRESS); ++attempt) {
+                sensorBusBegin(sensor_bus::DISCOVERY_BAUDS[attempt / sensor_bus::DISCOVERY_MAX_ADDRESS]);
+                gSensor.setSlaveAddress(static_cast<uint8_t>((attempt % sensor_bus::DISCOVERY_MAX_ADDRESS) + 1U));
+                (void)gSensor.startReadRegister(sensor_registers::SOIL_PH_REG);
+                TASK_WAIT_WHILE(state, (result = gSensor.pollRegister(job.value)) == ModbusMaster::ku8MBPending);
+                if (result == ModbusMaster::ku8MBSuccess) {
+                    job.status = result;
+                    job.address = gSensor.slaveAddress();
+                    job.baud = sensor_bus::DISCOVERY_BAUDS[attempt / sensor_bus::DISCOVERY_MAX_ADDRESS];
+                    break;
+                }
+            }
+            // Keep the pair that answered, or go back to the previous one.
+            sensorBusBegin(job.baud);
+            gSensor.setSlaveAddress(job.address);
+        } else {
+            if (job.op == BusJob::Op::WRITE) {
+                (void)gSensor.startWriteRegister(job.reg, job.value);
+            } else {
+                (void)gSensor.startReadRegister(job.reg);
+            }
+            TASK_WAIT_WHILE(state, (job.status = gSensor.pollRegister(job.value)) == ModbusMaster::ku8MBPending);
+            job.address = gSensor.slaveAddress();
+            job.baud = sensorBusBaud();
+        }
+        gBusJobs.complete(job);
+    }
+
+    // Blocks skipped after a failure must read as missing, not as last poll's values.
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        channels::setValue(raw, ch, channels::GAP);
+    }
+    for (block = 0U; block < SoilSensor::READ_BLOCK_COUNT; ++block) {
+        (void)gSensor.startReadBlock(block);
+        TASK_WAIT_WHILE(state, (result = gSensor.pollReadBlock(raw)) == ModbusMaster::ku8MBPending);
+        if (result != ModbusMaster::ku8MBSuccess) {
+            break;
+        }
+    }
+    // Log status transitions only, not every failed poll of a dead link.
+    // Deferred: safe here although the task runs inside the Timer1 ISR.
+    if ((result != ModbusMaster::ku8MBSuccess) && !failing) {
+        logger_write(logger::Level::WARN, PSTR("Sensor block %u failed: 0x%x"), block, result);
+    } else if ((result == ModbusMaster::ku8MBSuccess) && failing) {
+        logger_write(logger::Level::INFO, PSTR("Sensor recovered"));
     }
+    failing = (result != ModbusMaster::ku8MBSuccess);
+
+    // Publish the whole sample at once; readers never see a half-updated poll.
+    sample.timestampMs = timebase_millis();
+    sample.ok = (result == ModbusMaster::ku8MBSuccess);
+    sample.data = raw;
+#if ENABLE_FILTERS
+    filter_apply(sample.data); // Median + EMA/Kalman per channel
+#endif
+    gLatestSample.publish(sample);
+    (void)gSampleQueue.push(sample); // Full queue: dropped and counted
+    trend_record(sample.data);
+    TASK_END(state);
     #else
-    (void)gSensorData; // suppress unused warning
-    gLastReadOk = false;
-    #endif
     return state;
+    #endif
+}
+
+void Idle_DrainSamples() {
+    Sample sample;
+    while (gSampleQueue.pop(sample)) {
+        aggregate_add(sample.timestampMs, sample.data); // Statistics see every sample
+#if ENABLE_EEPROM_LOG
+        (void)eelog_offer(sample);
+#endif
+#if ENABLE_TELEMETRY
+        telemetry_sample(sample);
+#endif
+    }
 }
 
 int Task_LcdUpdate(int state) {
@@ -43,70 +141,18 @@ int Task_LcdUpdate(int state) {
     const uint8_t totalPages = ui::LCD_PAGE_COUNT;
 
     #if ENABLE_LCD
-    gLcd.clear();
-
-    switch (page) {
-        case 0U: { // Temperature & Moisture
-            char line1[17];
-            char line2[17];
-            char tempBuf[12];
-            char moistBuf[12];
-
-            dtostrf(gSensorData.temperature, 0, 1, tempBuf);
-            dtostrf(gSensorData.moisture, 0, 1, moistBuf);
-
-            snprintf(line1, sizeof(line1), "Temp:%s degC", tempBuf);
-            snprintf(line2, sizeof(line2), "Moist:%s %%", moistBuf);
-
-            gLcd.setCursor(0U, 0U);
-            gLcd.print(line1);
-            gLcd.setCursor(0U, 1U);
-            gLcd.print(line2);
-            break;
-        }
-        case 1U: { // pH & Conductivity
-            char line1[17];
-            char line2[17];
-            char phBuf[12];
-
-            dtostrf(gSensorData.ph, 0, 2, phBuf);
-            snprintf(line1, sizeof(line1), "pH:%s", phBuf);
-            snprintf(line2, sizeof(line2), "Cond:%d uS", static_cast<int>(gSensorData.conductivity));
-
-            gLcd.setCursor(0U, 0U);
-            gLcd.print(line1);
-            gLcd.setCursor(0U, 1U);
-            gLcd.print(line2);
-            break;
-        }
-        case 2U: { // N, P, K
-            char line1[17];
-            char line2[17];
-            snprintf(line1, sizeof(line1), "N:%d P:%d",
-                     static_cast<int>(gSensorData.nitrogen),
-                     static_cast<int>(gSensorData.phosphorus));
-            snprintf(line2, sizeof(line2), "K:%d mg/kg",
-                     static_cast<int>(gSensorData.potassium));
-
-            gLcd.setCursor(0U, 0U);
-            gLcd.print(line1);
-            gLcd.setCursor(0U, 1U);
-            gLcd.print(line2);
-            break;
-        }
-        default: { // Status page: Baud + last read status
-            char line1[17];
-            char line2[17];
-            snprintf(line1, sizeof(line1), "Baud:%d", static_cast<int>(pins::SERIAL_BAUD_RATE));
-            snprintf(line2, sizeof(line2), "Status:%s", gLastReadOk ? "OK" : "ERR");
-
-            gLcd.setCursor(0U, 0U);
-            gLcd.print(line1);
-            gLcd.setCursor(0U, 1U);
-            gLcd.print(line2);
-            break;
-        }
+    // Keep the last consistent snapshot if a read races a publish.
+    static Sample snapshot = {};
+    Sample latest;
+    if (gLatestSample.read(latest)) {
+        snapshot = latest;
     }
+
+    // Compose the page off-glass from its flash layout; render() then sends
+    // only the cells that differ from what is already displayed.
+    gLcd.bufferClear();
+    pages_draw(page, gLcd, snapshot);
+    (void)gLcd.render();
     #else
     (void)page; (void)totalPages; // suppress unused warnings
     #endif
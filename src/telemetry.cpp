@@ -0,0 +1,215 @@
+#include <Arduino.h>
+#include <util/atomic.h>
+#include "telemetry.h"
+#include "cobs.h"
+#include "channels.h"
+#include "tasks.h"
+#include "setup.h"
+#include "profiler.h"
+#include "logger.h"
+#include "deadband.h"
+#if ENABLE_EEPROM_LOG
+#include "eelog.h"
+#endif
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+using telemetry::FrameType;
+
+constexpr uint16_t BATCH_FRAME_BYTES = telemetry::samplesFrameBytes(telemetry::BATCH_SAMPLES);
+constexpr uint8_t PROFILER_BINS = scheduler::TOTAL_TASKS_NUM + 1U;
+constexpr uint16_t PROFILER_FRAME_BYTES =
+    telemetry::HEADER_BYTES + 16U + 1U + (4U * PROFILER_BINS) + telemetry::CRC_BYTES;
+constexpr uint16_t HEALTH_FRAME_BYTES =
+    telemetry::HEADER_BYTES + telemetry::HEALTH_BODY_BYTES + telemetry::CRC_BYTES;
+constexpr uint16_t LOG_FRAME_BYTES =
+    telemetry::HEADER_BYTES + telemetry::LOG_HEADER_BYTES + logger::MAX_TEXT + telemetry::CRC_BYTES;
+constexpr uint16_t REPLY_FRAME_BYTES =
+    telemetry::HEADER_BYTES + console::REPLY_BYTES + telemetry::CRC_BYTES;
+
+/// Bytes a frame occupies in the UART TX buffer, delimiter included.
+constexpr uint16_t wireBytes(uint16_t frame_bytes) noexcept {
+    return static_cast<uint16_t>(cobs::encodedSize(frame_bytes) + 1U);
+}
+
+// HardwareSerial reports at most SERIAL_TX_BUFFER_SIZE - 1 bytes free; a
+// frame larger than that could never be sent without blocking.
+static_assert(telemetry::BATCH_SAMPLES > 0U, "A SAMPLES frame carries at least one sample");
+static_assert(wireBytes(BATCH_FRAME_BYTES) < SERIAL_TX_BUFFER_SIZE,
+              "SAMPLES frame exceeds the UART TX buffer; lower BATCH_SAMPLES or raise SERIAL_TX_BUFFER_SIZE");
+static_assert(wireBytes(PROFILER_FRAME_BYTES) < SERIAL_TX_BUFFER_SIZE,
+              "PROFILER frame exceeds the UART TX buffer");
+static_assert(wireBytes(LOG_FRAME_BYTES) < SERIAL_TX_BUFFER_SIZE,
+              "LOG frame exceeds the UART TX buffer; lower logger::MAX_TEXT");
+static_assert(wireBytes(REPLY_FRAME_BYTES) < SERIAL_TX_BUFFER_SIZE,
+              "REPLY frame exceeds the UART TX buffer; lower console::REPLY_BYTES");
+
+// JSF AV C++ Rule 70: No volatile; everything here runs in the idle loop.
+uint8_t g_batch[BATCH_FRAME_BYTES] = {};
+uint8_t g_batchCount = 0U;
+uint32_t g_batchStartMs = 0UL;
+deadband::Gate g_gate(0UL, telemetry::HEARTBEAT_MS);
+uint8_t g_sequence = 0U;
+uint32_t g_lastHealthMs = 0UL;
+uint16_t g_sensorFailures = 0U;
+uint16_t g_frameDrops = 0U;
+bool g_synced = false;  ///< A delimiter has separated the stream from earlier text.
+
+uint8_t put16(uint8_t* out, uint16_t v) noexcept {
+    out[0] = static_cast<uint8_t>(v);
+    out[1] = static_cast<uint8_t>(v >> 8);
+    return 2U;
+}
+
+uint8_t put32(uint8_t* out, uint32_t v) noexcept {
+    (void)put16(out, static_cast<uint16_t>(v));
+    (void)put16(&out[2], static_cast<uint16_t>(v >> 16));
+    return 4U;
+}
+
+/// True if a frame of @p length bytes can be written without blocking.
+bool hasRoom(uint16_t length) noexcept {
+    return static_cast<uint16_t>(Serial.availableForWrite()) >= (wireBytes(length) + (g_synced ? 0U : 1U));
+}
+
+void serialSink(uint8_t byte, void*) noexcept {
+    (void)Serial.write(byte);
+}
+
+/**
+ * @brief Stamps type, sequence and CRC onto @p frame and sends it.
+ * @param body_end Offset just past the body; CRC_BYTES must follow it.
+ */
+void sendFrame(uint8_t* frame, FrameType type, uint16_t body_end) noexcept {
+    frame[0] = static_cast<uint8_t>(type);
+    frame[1] = g_sequence;
+    // Lost frames still consume a sequence number, so the host sees the gap.
+    g_sequence = static_cast<uint8_t>(g_sequence + 1U);
+    const uint16_t length = static_cast<uint16_t>(body_end + put16(&frame[body_end], cobs::crc16(cobs::CRC_INIT, frame, body_end)));
+
+    if (!hasRoom(length)) {
+        ++g_frameDrops;
+        return;
+    }
+    if (!g_synced) {
+        // Terminate any boot text so the first frame decodes cleanly.
+        (void)Serial.write(cobs::DELIMITER);
+        g_synced = true;
+    }
+    (void)cobs::encode(frame, length, &serialSink, nullptr);
+    (void)Serial.write(cobs::DELIMITER);
+}
+
+} // anonymous namespace
+
+void telemetry_sample(const Sample& sample) noexcept {
+    if (!sample.ok) {
+        ++g_sensorFailures;
+    }
+    if (!g_gate.pass(sample)) {
+        return;
+    }
+    if (g_batchCount == 0U) {
+        g_batchStartMs = sample.timestampMs;
+    }
+    uint8_t* out = &g_batch[telemetry::HEADER_BYTES + 1U + (static_cast<uint16_t>(telemetry::SAMPLE_BYTES) * g_batchCount)];
+    out += put32(out, sample.timestampMs);
+    *out++ = sample.ok ? telemetry::STATUS_OK : 0U;
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        out += put16(out, static_cast<uint16_t>(channels::value(sample.data, ch)));
+    }
+    ++g_batchCount;
+    if (g_batchCount >= telemetry::BATCH_SAMPLES) {
+        telemetry_flush();
+    }
+}
+
+void telemetry_flush() noexcept {
+    if (g_batchCount == 0U) {
+        return;
+    }
+    g_batch[telemetry::HEADER_BYTES] = g_batchCount;
+    sendFrame(g_batch, FrameType::SAMPLES, telemetry::samplesFrameBytes(g_batchCount) - telemetry::CRC_BYTES);
+    g_batchCount = 0U;
+}
+
+void telemetry_poll(uint32_t now_ms) noexcept {
+    if ((g_batchCount != 0U) && ((now_ms - g_batchStartMs) >= telemetry::BATCH_WAIT_MS)) {
+        telemetry_flush();
+    }
+    if ((now_ms - g_lastHealthMs) < telemetry::HEALTH_PERIOD_MS) {
+        return;
+    }
+    g_lastHealthMs = now_ms;
+
+    uint16_t counters[telemetry::HEALTH_COUNTER_COUNT] = {};
+    counters[telemetry::SENSOR_FAILURES] = g_sensorFailures;
+    // Producer-owned counters: read whole 16-bit values.
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        counters[telemetry::QUEUE_DROPS] = gSampleQueue.droppedCount();
+    }
+#if ENABLE_LCD
+    counters[telemetry::LCD_DROPS] = gLcd.droppedCount();
+#endif
+#if ENABLE_EEPROM_LOG
+    counters[telemetry::LOG_DROPS] = eelog_dropped();
+#endif
+    counters[telemetry::FRAME_DROPS] = g_frameDrops;
+    counters[telemetry::MESSAGE_DROPS] = logger_dropped();
+    counters[telemetry::SAMPLES_SUPPRESSED] = g_gate.suppressedCount();
+
+    uint8_t frame[HEALTH_FRAME_BYTES];
+    uint16_t n = telemetry::HEADER_BYTES;
+    n += put32(&frame[n], now_ms);
+    for (uint8_t i = 0U; i < telemetry::HEALTH_COUNTER_COUNT; ++i) {
+        n += put16(&frame[n], counters[i]);
+    }
+    sendFrame(frame, FrameType::HEALTH, n);
+}
+
+void telemetry_profiler(const profiler::TickStats& stats) noexcept {
+    uint8_t frame[PROFILER_FRAME_BYTES];
+    uint16_t n = telemetry::HEADER_BYTES;
+    n += put32(&frame[n], stats.ticks);
+    n += put32(&frame[n], stats.totalTickUs);
+    n += put32(&frame[n], stats.maxTickUs);
+    n += put32(&frame[n], stats.overruns);
+    frame[n++] = PROFILER_BINS;
+    for (uint8_t i = 0U; i < PROFILER_BINS; ++i) {
+        n += put32(&frame[n], stats.loadHistogram[i]);
+    }
+    sendFrame(frame, FrameType::PROFILER, n);
+}
+
+bool telemetry_log(uint8_t level, uint32_t timestamp_ms, const char* text, uint8_t length) noexcept {
+    length = (length < logger::MAX_TEXT) ? length : logger::MAX_TEXT;
+    const uint16_t bodyEnd = static_cast<uint16_t>(telemetry::HEADER_BYTES + telemetry::LOG_HEADER_BYTES + length);
+    if (!hasRoom(static_cast<uint16_t>(bodyEnd + telemetry::CRC_BYTES))) {
+        return false;
+    }
+    uint8_t frame[LOG_FRAME_BYTES];
+    uint16_t n = telemetry::HEADER_BYTES;
+    frame[n++] = level;
+    n += put32(&frame[n], timestamp_ms);
+    for (uint8_t i = 0U; i < length; ++i) {
+        frame[n++] = static_cast<uint8_t>(text[i]);
+    }
+    sendFrame(frame, FrameType::LOG, n);
+    return true;
+}
+
+bool telemetry_reply(const char* text, uint8_t length) noexcept {
+    length = (length < console::REPLY_BYTES) ? length : console::REPLY_BYTES;
+    const uint16_t bodyEnd = static_cast<uint16_t>(telemetry::HEADER_BYTES + length);
+    if (!hasRoom(static_cast<uint16_t>(bodyEnd + telemetry::CRC_BYTES))) {
+        return false;
+    }
+    uint8_t frame[REPLY_FRAME_BYTES];
+    uint16_t n = telemetry::HEADER_BYTES;
+    for (uint8_t i = 0U; i < length; ++i) {
+        frame[n++] = static_cast<uint8_t>(text[i]);
+    }
+    sendFrame(frame, FrameType::REPLY, n);
+    return true;
+}
@@ -0,0 +1,236 @@
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "scheduler.h" // Use C-style wrapper
+#include "timebase.h"
+
+// JSF AV C++ Rule 12: The static keyword shall be used for functions and objects with file scope.
+namespace {
+
+// JSF AV C++ Rule 10: Use const/constexpr for constants.
+#ifndef F_CPU
+constexpr uint32_t F_CPU = 16000000UL;
+#endif
+
+/**
+ * @brief Returns log2 of a power of two (C++11 single-return constexpr).
+ */
+constexpr uint8_t log2_pow2(uint32_t value) noexcept {
+    return (value <= 1UL) ? 0U : static_cast<uint8_t>(1U + log2_pow2(value >> 1));
+}
+
+constexpr uint32_t CPU_MHZ = static_cast<uint32_t>(F_CPU) / 1000000UL;
+constexpr uint8_t CPU_MHZ_SHIFT = log2_pow2(CPU_MHZ);
+static_assert((1UL << CPU_MHZ_SHIFT) == CPU_MHZ,
+              "timebase requires F_CPU to be a power-of-two number of MHz");
+
+/**
+ * @brief One selectable Timer1 clock source.
+ */
+struct Prescaler {
+    uint8_t shift;       ///< log2 of the prescaler divisor.
+    uint8_t clockSelect; ///< CS12:CS10 bits for TCCR1B.
+};
+
+// Ordered from finest to coarsest resolution.
+constexpr uint8_t PRESCALER_COUNT = 5U;
+constexpr Prescaler PRESCALERS[PRESCALER_COUNT] = {
+    { 0U,  _BV(CS10) },              // /1
+    { 3U,  _BV(CS11) },              // /8
+    { 6U,  _BV(CS11) | _BV(CS10) },  // /64
+    { 8U,  _BV(CS12) },              // /256
+    { 10U, _BV(CS12) | _BV(CS10) }   // /1024
+};
+
+constexpr uint32_t TIMER1_MAX_STEP = 65535UL;
+// Longest period representable at /1024; also keeps period_us * CPU_MHZ in 32 bits.
+constexpr uint32_t TIMEBASE_MAX_PERIOD_US =
+    (TIMER1_MAX_STEP << PRESCALERS[PRESCALER_COUNT - 1U].shift) >> CPU_MHZ_SHIFT;
+
+// JSF AV C++ Rule 70: The volatile keyword shall not be used.
+// Shared state is only touched in the Timer1 ISRs or inside ATOMIC_BLOCK,
+// whose cli/sei act as compiler memory barriers.
+uint16_t g_period_ticks = 0U;     ///< Compare step between scheduler ticks.
+uint8_t g_tick_shift = 0U;        ///< log2(prescaler) for counter-to-us conversion.
+uint32_t g_overflow_span_us = 0UL; ///< Microseconds covered by one 16-bit wrap.
+uint32_t g_overflow_us = 0UL;     ///< Microsecond clock at the last overflow.
+uint32_t g_overflow_ms = 0UL;     ///< Millisecond clock at the last overflow.
+uint16_t g_overflow_rem_us = 0U;  ///< Sub-millisecond remainder at the last overflow.
+
+/**
+ * @brief Atomically writes a 16-bit value to the OCR1A register.
+ * @details Follows AVR datasheet recommendation for 16-bit register access.
+ * @param value The 16-bit value to write.
+ */
+inline void timer1_write_ocr1a_atomic(uint16_t value) noexcept {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        OCR1AH = static_cast<uint8_t>(value >> 8);
+        OCR1AL = static_cast<uint8_t>(value & 0xFF);
+    }
+}
+
+/**
+ * @brief Atomically writes a 16-bit value to the TCNT1 register.
+ * @details Follows AVR datasheet recommendation for 16-bit register access.
+ * @param value The 16-bit value to write.
+ */
+inline void timer1_write_tcnt1_atomic(uint16_t value) noexcept {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TCNT1H = static_cast<uint8_t>(value >> 8);
+        TCNT1L = static_cast<uint8_t>(value & 0xFF);
+    }
+}
+
+/**
+ * @brief Reads TCNT1; the caller must have interrupts disabled.
+ * @details The low byte is read first, which latches the high byte (datasheet 16.3).
+ */
+inline uint16_t timer1_read_tcnt1_unlocked() noexcept {
+    const uint8_t low = TCNT1L;
+    const uint8_t high = TCNT1H;
+    return static_cast<uint16_t>((static_cast<uint16_t>(high) << 8) | low);
+}
+
+/**
+ * @brief Reads OCR1A; the caller must have interrupts disabled.
+ */
+inline uint16_t timer1_read_ocr1a_unlocked() noexcept {
+    const uint8_t low = OCR1AL;
+    const uint8_t high = OCR1AH;
+    return static_cast<uint16_t>((static_cast<uint16_t>(high) << 8) | low);
+}
+
+/**
+ * @brief Snapshots the overflow-extended counter with interrupts disabled.
+ * @details If an overflow is pending but its ISR has not run yet, the span is
+ *          accounted for here so the clock never steps backwards.
+ * @param[out] base_us Microsecond clock at the last (possibly pending) overflow.
+ * @param[out] base_ms Millisecond clock at the last overflow.
+ * @param[out] rem_us Sub-millisecond remainder at the last overflow.
+ * @param[out] count_us Microseconds elapsed since that overflow.
+ */
+inline void timebase_snapshot(uint32_t& base_us, uint32_t& base_ms,
+                              uint32_t& rem_us, uint32_t& count_us) noexcept {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        const uint16_t count = timer1_read_tcnt1_unlocked();
+        base_us = g_overflow_us;
+        base_ms = g_overflow_ms;
+        rem_us = g_overflow_rem_us;
+        count_us = (static_cast<uint32_t>(count) << g_tick_shift) >> CPU_MHZ_SHIFT;
+        // A pending overflow with a small count means the wrap already happened.
+        if (((TIFR1 & _BV(TOV1)) != 0U) && (count < 0x8000U)) {
+            count_us += g_overflow_span_us;
+        }
+    }
+}
+
+} // anonymous namespace
+
+bool timebase_init(uint32_t period_us) noexcept {
+    // JSF AV C++ Rule 60: All if, else if, else, while, do, and for statements shall be compound statements.
+    if ((period_us == 0UL) || (period_us > TIMEBASE_MAX_PERIOD_US)) {
+        return false;
+    }
+
+    // JSF AV C++ Rule 18: All variables shall be initialized before use.
+    const uint32_t cycles = period_us * CPU_MHZ;
+    uint8_t selected = PRESCALER_COUNT;
+    for (uint8_t i = 0U; i < PRESCALER_COUNT; ++i) {
+        const uint32_t step = cycles >> PRESCALERS[i].shift;
+        if ((step != 0UL) && (step <= TIMER1_MAX_STEP)) {
+            selected = i;
+            break;
+        }
+    }
+    if (selected == PRESCALER_COUNT) {
+        return false;
+    }
+
+    const Prescaler& p = PRESCALERS[selected];
+
+    // Stop timer: clear prescaler bits
+    TCCR1B &= ~(_BV(CS10) | _BV(CS11) | _BV(CS12));
+
+    // Configure normal (free-running) mode: WGM13:10 = 0
+    TCCR1A &= ~(_BV(WGM10) | _BV(WGM11));
+    TCCR1B &= ~(_BV(WGM12) | _BV(WGM13));
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        // Keep the clock continuous across re-configuration; the snapshot
+        // must use the outgoing prescaler, so take it before switching.
+        if (g_period_ticks != 0U) {
+            uint32_t base_us = 0UL;
+            uint32_t base_ms = 0UL;
+            uint32_t rem_us = 0UL;
+            uint32_t count_us = 0UL;
+            timebase_snapshot(base_us, base_ms, rem_us, count_us);
+            rem_us += count_us;
+            g_overflow_us = base_us + count_us;
+            g_overflow_ms = base_ms + (rem_us / 1000UL);
+            g_overflow_rem_us = static_cast<uint16_t>(rem_us % 1000UL);
+        }
+        g_period_ticks = static_cast<uint16_t>(cycles >> p.shift);
+        g_tick_shift = p.shift;
+        g_overflow_span_us = (65536UL << p.shift) >> CPU_MHZ_SHIFT;
+    }
+
+    timer1_write_tcnt1_atomic(0);
+    timer1_write_ocr1a_atomic(g_period_ticks);
+
+    // Clear pending overflow/compare flags (write-one-to-clear)
+    TIFR1 = _BV(TOV1) | _BV(OCF1A);
+
+    // Enable overflow (clock extension) and compare A (scheduler tick)
+    TIMSK1 |= _BV(TOIE1) | _BV(OCIE1A);
+
+    // Start Timer1 with the selected prescaler
+    TCCR1B |= p.clockSelect;
+    return true;
+}
+
+uint32_t timebase_micros() noexcept {
+    uint32_t base_us = 0UL;
+    uint32_t base_ms = 0UL;
+    uint32_t rem_us = 0UL;
+    uint32_t count_us = 0UL;
+    timebase_snapshot(base_us, base_ms, rem_us, count_us);
+    return base_us + count_us;
+}
+
+uint32_t timebase_millis() noexcept {
+    uint32_t base_us = 0UL;
+    uint32_t base_ms = 0UL;
+    uint32_t rem_us = 0UL;
+    uint32_t count_us = 0UL;
+    timebase_snapshot(base_us, base_ms, rem_us, count_us);
+    return base_ms + ((rem_us + count_us) / 1000UL);
+}
+
+uint16_t timebase_resolution_ns() noexcept {
+    return static_cast<uint16_t>((1000UL << g_tick_shift) >> CPU_MHZ_SHIFT);
+}
+
+/**
+ * @brief Interrupt Service Routine for Timer1 Overflow.
+ * @details Extends the 16-bit counter into the 32-bit microsecond and
+ *          millisecond clocks. Runs every 4.1 ms to 4.2 s depending on prescaler.
+ */
+ISR(TIMER1_OVF_vect) {
+    const uint32_t rem_us = static_cast<uint32_t>(g_overflow_rem_us) + g_overflow_span_us;
+    g_overflow_us += g_overflow_span_us;
+    g_overflow_ms += rem_us / 1000UL;
+    g_overflow_rem_us = static_cast<uint16_t>(rem_us % 1000UL);
+}
+
+/**
+ * @brief Interrupt Service Routine for Timer1 Compare Match A.
+ * @details Advances OCR1A by one period (16-bit wrap is intended) before
+ *          dispatching to the scheduler, so tick spacing does not drift even
+ *          when the scheduler re-enables interrupts for long-running tasks.
+ */
+ISR(TIMER1_COMPA_vect) {
+    timer1_write_ocr1a_atomic(static_cast<uint16_t>(timer1_read_ocr1a_unlocked() + g_period_ticks));
+    // JSF AV C++ Rule 164: Long or complex processing in an ISR shall be avoided.
+    // The scheduler tick is designed to be brief.
+    scheduler_tick();
+}
@@ -0,0 +1,128 @@
+#include "timerwheel.h"
+
+namespace scheduler {
+
+constexpr uint8_t TimerWheel::LEVELS;
+constexpr uint8_t TimerWheel::SLOT_BITS;
+constexpr uint8_t TimerWheel::SLOTS;
+
+namespace {
+    // JSF AV C++ Rule 10: Use constexpr for constants.
+    constexpr uint32_t SLOT_MASK = TimerWheel::SLOTS - 1U;
+    /// Ticks reachable from level L is 2^(SLOT_BITS * (L + 1)).
+    constexpr uint32_t LEVEL_SPAN[TimerWheel::LEVELS] = {
+        1UL << (TimerWheel::SLOT_BITS * 1U),
+        1UL << (TimerWheel::SLOT_BITS * 2U),
+        1UL << (TimerWheel::SLOT_BITS * 3U)
+    };
+}
+
+TimerWheel::TimerWheel() noexcept
+    : current(0U) {
+    // JSF AV C++ Rule 18: All variables shall be initialized before use.
+    for (uint8_t level = 0U; level < LEVELS; ++level) {
+        for (uint8_t slot = 0U; slot < SLOTS; ++slot) {
+            slots[level][slot] = nullptr;
+        }
+    }
+}
+
+bool TimerWheel::schedule(TimerEvent& event, uint32_t delay_ticks) noexcept {
+    if (event.pending) {
+        return false;
+    }
+    event.expiry = current + ((delay_ticks != 0U) ? delay_ticks : 1U);
+    event.pending = true;
+    insert(event);
+    return true;
+}
+
+bool TimerWheel::cancel(TimerEvent& event) noexcept {
+    if (!event.pending) {
+        return false;
+    }
+    unlink(event);
+    event.pending = false;
+    return true;
+}
+
+void TimerWheel::insert(TimerEvent& event) noexcept {
+    const uint32_t delta = event.expiry - current;
+    TimerEvent** head = nullptr;
+
+    if (delta < LEVEL_SPAN[0]) {
+        head = &slots[0][event.expiry & SLOT_MASK];
+    } else if (delta < LEVEL_SPAN[1]) {
+        head = &slots[1][(event.expiry >> SLOT_BITS) & SLOT_MASK];
+    } else if (delta < LEVEL_SPAN[2]) {
+        head = &slots[2][(event.expiry >> (2U * SLOT_BITS)) & SLOT_MASK];
+    } else {
+        // Beyond the wheel: park in the level-2 slot that cascades last and
+        // re-file from there with the remaining delay.
+        head = &slots[2][((current >> (2U * SLOT_BITS)) + SLOT_MASK) & SLOT_MASK];
+    }
+
+    event.next = *head;
+    event.pprev = head;
+    if (event.next != nullptr) {
+        event.next->pprev = &event.next;
+    }
+    *head = &event;
+}
+
+void TimerWheel::unlink(TimerEvent& event) noexcept {
+    *event.pprev = event.next;
+    if (event.next != nullptr) {
+        event.next->pprev = event.pprev;
+    }
+    event.next = nullptr;
+    event.pprev = nullptr;
+}
+
+void TimerWheel::cascade(uint8_t level, uint8_t slot) noexcept {
+    TimerEvent* event = slots[level][slot];
+    slots[level][slot] = nullptr;
+    while (event != nullptr) {
+        TimerEvent* const following = event->next;
+        insert(*event);
+        event = following;
+    }
+}
+
+void TimerWheel::advance(TimerEvent*& expired) noexcept {
+    ++current;
+
+    // Re-file the next block of coarser slots before firing level 0.
+    if ((current & SLOT_MASK) == 0U) {
+        if (((current >> SLOT_BITS) & SLOT_MASK) == 0U) {
+            cascade(2U, static_cast<uint8_t>((current >> (2U * SLOT_BITS)) & SLOT_MASK));
+        }
+        cascade(1U, static_cast<uint8_t>((current >> SLOT_BITS) & SLOT_MASK));
+    }
+
+    // Everything in the current level-0 slot is due this tick. The list moves
+    // whole: only its head link changes owner.
+    TimerEvent*& slot = slots[0][current & SLOT_MASK];
+    expired = slot;
+    slot = nullptr;
+    if (expired != nullptr) {
+        expired->pprev = &expired;
+    }
+}
+
+TimerEvent* TimerWheel::pop(TimerEvent*& expired) noexcept {
+    TimerEvent* const event = expired;
+    if (event != nullptr) {
+        unlink(*event);
+        event->pending = false;
+    }
+    return event;
+}
+
+void TimerWheel::fire(TimerEvent& event) noexcept {
+    if (event.callback != nullptr) {
+        event.callback(event.arg);
+    }
+}
+
+} // namespace scheduler
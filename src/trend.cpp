@@ -0,0 +1,56 @@
+#include <util/atomic.h>
+#include "trend.h"
+#include "channels.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+    // JSF AV C++ Rule 70: No volatile; shared state is accessed inside ATOMIC_BLOCK.
+    int16_t g_history[ui::TREND_SAMPLES] = {};
+    uint8_t g_next = 0U;   ///< Slot the next sample goes to.
+    uint8_t g_count = 0U;  ///< Samples held (saturates at TREND_SAMPLES).
+    uint8_t g_channel = ui::TREND_CHANNEL;
+}
+
+void trend_record(const SoilSensor::SensorData& data) noexcept {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_history[g_next] = channels::value(data, g_channel);
+        g_next = static_cast<uint8_t>((g_next + 1U) % ui::TREND_SAMPLES);
+        if (g_count < ui::TREND_SAMPLES) {
+            ++g_count;
+        }
+    }
+}
+
+uint8_t trend_snapshot(int16_t (&out)[ui::TREND_SAMPLES]) noexcept {
+    uint8_t count = 0U;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        count = g_count;
+        // Oldest entry sits at g_next once the ring has wrapped, else at 0.
+        uint8_t src = (g_count < ui::TREND_SAMPLES) ? 0U : g_next;
+        for (uint8_t i = 0U; i < count; ++i) {
+            out[i] = g_history[src];
+            src = static_cast<uint8_t>((src + 1U) % ui::TREND_SAMPLES);
+        }
+    }
+    return count;
+}
+
+uint8_t trend_channel() noexcept {
+    uint8_t ch = 0U;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ch = g_channel;
+    }
+    return ch;
+}
+
+bool trend_set_channel(uint8_t ch) noexcept {
+    if (ch >= channels::COUNT) {
+        return false;
+    }
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        g_channel = ch;
+        g_next = 0U;
+        g_count = 0U;
+    }
+    return true;
+}
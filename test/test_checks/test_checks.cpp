@@ -0,0 +1,43 @@
+/**
+ * @file test_checks.cpp
+ * @brief Runs the host checks in tools/ as tests: the filter chain against
+ *        its floating-point reference, the EEPROM log round trip and the
+ *        timing wheel against its model.
+ * @details Each check prints its own diagnostics and summary; see the tool's
+ *          header for what it covers. Run with
+ *          `pio test -e native_test -f test_checks`.
+ */
+#include <unity.h>
+#include "native_hal.h"
+
+// tools/filter_check, tools/eelog_check and tools/timerwheel_check, built
+// without their main() under PIO_UNIT_TESTING.
+bool filter_check_run();
+bool eelog_check_run();
+bool timerwheel_check_run();
+
+void setUp() {
+    hal::reset();
+}
+
+void tearDown() {}
+
+void test_filter_chain_matches_reference() {
+    TEST_ASSERT_TRUE_MESSAGE(filter_check_run(), "filter check failed, see the output above");
+}
+
+void test_eelog_round_trip() {
+    TEST_ASSERT_TRUE_MESSAGE(eelog_check_run(), "eelog check failed, see the output above");
+}
+
+void test_timer_wheel_matches_model() {
+    TEST_ASSERT_TRUE_MESSAGE(timerwheel_check_run(), "timer wheel check failed, see the output above");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_filter_chain_matches_reference);
+    RUN_TEST(test_eelog_round_trip);
+    RUN_TEST(test_timer_wheel_matches_model);
+    return UNITY_END();
+}
@@ -0,0 +1,69 @@
+/**
+ * @file test_replay.cpp
+ * @brief Replays every trace in tools/replay/scenarios through the firmware
+ *        and compares the output with the .csv beside it.
+ * @details The same run as `modbus_replay TRACE --expect CSV`, so a field
+ *          capture committed with its output becomes a test without touching
+ *          this file. Paths are relative to the project root, where
+ *          `pio test -e native_test -f test_replay` runs the program.
+ */
+#include <algorithm>
+#include <dirent.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <unity.h>
+#include "native_hal.h"
+
+// tools/replay/modbus_replay.cpp, built without its main() under PIO_UNIT_TESTING.
+int modbus_replay_run(const char* tracePath, const char* expectPath, const char* outPath, uint32_t limitS);
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+const char SCENARIOS[] = "tools/replay/scenarios/";
+const char TRACE_SUFFIX[] = ".trace";
+
+/// Scenario names (without the suffix), sorted so the run order is stable.
+std::vector<std::string> scenarios() {
+    std::vector<std::string> names;
+    DIR* dir = opendir(SCENARIOS);
+    if (dir == nullptr) {
+        return names;
+    }
+    const size_t suffix = sizeof(TRACE_SUFFIX) - 1U;
+    for (const dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+        const size_t length = strlen(entry->d_name);
+        if ((length > suffix) && (strcmp(&entry->d_name[length - suffix], TRACE_SUFFIX) == 0)) {
+            names.push_back(std::string(entry->d_name, length - suffix));
+        }
+    }
+    (void)closedir(dir);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+} // anonymous namespace
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_scenarios_match_expected_output() {
+    const std::vector<std::string> names = scenarios();
+    TEST_ASSERT_TRUE_MESSAGE(!names.empty(), "no traces in tools/replay/scenarios");
+    for (const std::string& name : names) {
+        const std::string trace = SCENARIOS + name + TRACE_SUFFIX;
+        const std::string expect = SCENARIOS + name + ".csv";
+        // Every scenario starts from reset; the output goes to stdout as with the tool.
+        hal::reset();
+        TEST_ASSERT_EQUAL_INT_MESSAGE(0, modbus_replay_run(trace.c_str(), expect.c_str(), nullptr, 0UL),
+                                      trace.c_str());
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_scenarios_match_expected_output);
+    return UNITY_END();
+}
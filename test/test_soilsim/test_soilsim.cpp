@@ -0,0 +1,233 @@
+/**
+ * @file test_soilsim.cpp
+ * @brief Fault injection of lib/soilsim seen through ModbusMaster on a
+ *        9600 baud native_hal port: dropped, delayed, corrupted and
+ *        exception replies and outages, each checked against both the
+ *        probe's and the master's counters.
+ * @details Transactions are polled in STEP_US steps of virtual time, so
+ *          delays are measured to that resolution. Run with
+ *          `pio test -e native_test -f test_soilsim`.
+ */
+#include <math.h>
+#include <unity.h>
+#include <Arduino.h>
+#include "native_hal.h"
+#include "ModbusMaster.h"
+#include "config.h"
+#include "sensor_registers.h"
+#include "soilsim.h"
+#include "soilsim_hal.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint8_t SLAVE = 1U;
+constexpr uint32_t BAUD = 9600UL;
+constexpr uint32_t STEP_US = 10UL;
+/// ModbusMaster's response timeout.
+constexpr uint32_t RESPONSE_TIMEOUT_US = 2000000UL;
+/// Requests for the statistical tests; few enough that the timeouts stay cheap.
+constexpr uint32_t REQUESTS = 400UL;
+
+/// One probe on a bus attached to a begun port, and a master polling it.
+struct Rig {
+    hal::FakeStream port;
+    soilsim::Slave probe;
+    soilsim::Bus bus;
+    soilsim::BusPeer peer;
+    ModbusMaster node;
+
+    Rig() : port(0U), probe(SLAVE, BAUD), bus(BAUD), peer(bus), node() {
+        port.begin(BAUD);
+        bus.attach(probe);
+        port.setPeer(&peer);
+        node.begin(SLAVE, port);
+    }
+
+    ~Rig() {
+        port.setPeer(nullptr);
+    }
+
+    /// Reads the moisture register; @p us receives the virtual time taken.
+    uint8_t read(uint64_t& us) {
+        const uint64_t start = hal::micros64();
+        uint8_t result = node.startReadHoldingRegisters(sensor_registers::SOIL_MOISTURE_REG, 1U);
+        while (result == ModbusMaster::ku8MBPending) {
+            hal::advanceMicros(STEP_US);
+            result = node.pollTransaction();
+        }
+        us = hal::micros64() - start;
+        return result;
+    }
+
+    uint8_t read() {
+        uint64_t us = 0U;
+        return read(us);
+    }
+
+    /// Lets a late reply finish arriving and drops it, as the next poll would.
+    void drain() {
+        hal::advanceMicros(RESPONSE_TIMEOUT_US);
+        while (port.read() >= 0) {
+        }
+    }
+};
+
+/// True if @p count is within four standard deviations of @p permille of @p n.
+bool plausible(uint32_t count, uint32_t n, uint16_t permille) {
+    const double p = permille / 1000.0;
+    const double mean = n * p;
+    const double spread = 4.0 * sqrt(n * p * (1.0 - p));
+    return (count >= (mean - spread)) && (count <= (mean + spread));
+}
+
+} // anonymous namespace
+
+void setUp() {
+    hal::reset();
+}
+
+void tearDown() {}
+
+void test_perfect_probe_replies() {
+    Rig rig;
+    rig.probe.readings().moisture = 412U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read());
+    TEST_ASSERT_EQUAL_UINT16(412U, rig.node.getResponseBuffer(0U));
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().replies);
+    TEST_ASSERT_EQUAL_UINT32(0U, rig.probe.stats().dropped);
+    TEST_ASSERT_EQUAL_UINT32(0U, rig.probe.stats().corrupted);
+}
+
+void test_dropped_reply_times_out() {
+    Rig rig;
+    rig.probe.faults().dropPermille = 1000U;
+    uint64_t us = 0U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBResponseTimedOut, rig.read(us));
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().requests);
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().dropped);
+    TEST_ASSERT_EQUAL_UINT32(0U, rig.probe.stats().replies);
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.node.getStats().timeouts);
+    // The whole timeout, counted from the end of the 8-byte request.
+    TEST_ASSERT_TRUE(us >= RESPONSE_TIMEOUT_US);
+    TEST_ASSERT_TRUE(us <= (RESPONSE_TIMEOUT_US + 20000UL));
+
+    // The next poll recovers once the fault clears.
+    rig.probe.faults().dropPermille = 0U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read());
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().replies);
+}
+
+void test_drop_rate() {
+    Rig rig;
+    rig.probe.faults().dropPermille = 100U;
+    for (uint32_t i = 0U; i < REQUESTS; ++i) {
+        (void)rig.read();
+    }
+    const soilsim::SlaveStats& s = rig.probe.stats();
+    TEST_ASSERT_EQUAL_UINT32(REQUESTS, s.requests);
+    TEST_ASSERT_TRUE(plausible(s.dropped, REQUESTS, 100U));
+    TEST_ASSERT_EQUAL_UINT32(s.dropped, rig.node.getStats().timeouts);
+    TEST_ASSERT_EQUAL_UINT32(REQUESTS - s.dropped, rig.node.getStats().responses);
+}
+
+void test_response_delay_shifts_reply() {
+    Rig rig;
+    uint64_t prompt = 0U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read(prompt));
+    constexpr uint32_t DELAY_US = 150000UL;
+    rig.probe.faults().responseDelayUs = DELAY_US;
+    uint64_t delayed = 0U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read(delayed));
+    TEST_ASSERT_UINT32_WITHIN(2UL * STEP_US, DELAY_US, static_cast<uint32_t>(delayed - prompt));
+
+    // The byte gap stretches the 7-byte reply by six gaps.
+    constexpr uint32_t GAP_US = 500UL;
+    rig.probe.faults().responseDelayUs = 0UL;
+    rig.probe.faults().byteGapUs = GAP_US;
+    uint64_t gapped = 0U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read(gapped));
+    TEST_ASSERT_UINT32_WITHIN(2UL * STEP_US, 6UL * GAP_US, static_cast<uint32_t>(gapped - prompt));
+}
+
+void test_late_reply_times_out() {
+    Rig rig;
+    rig.probe.faults().responseDelayUs = RESPONSE_TIMEOUT_US + 500000UL;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBResponseTimedOut, rig.read());
+    // Sent, just too late: a reply for the probe, a timeout for the master.
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().replies);
+    TEST_ASSERT_EQUAL_UINT32(0U, rig.probe.stats().dropped);
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.node.getStats().timeouts);
+
+    rig.drain();
+    rig.probe.faults().responseDelayUs = 0UL;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read());
+}
+
+void test_corrupted_reply_fails_crc() {
+    Rig rig;
+    rig.probe.faults().corruptPermille = 1000U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBInvalidCRC, rig.read());
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().corrupted);
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().replies);
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.node.getStats().crcErrors);
+    TEST_ASSERT_EQUAL_UINT32(0U, rig.node.getStats().responses);
+
+    rig.probe.faults().corruptPermille = 0U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read());
+}
+
+void test_injected_exception() {
+    Rig rig;
+    rig.probe.faults().exceptionPermille = 1000U;
+    rig.probe.faults().exceptionCode = ModbusMaster::ku8MBSlaveDeviceFailure;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSlaveDeviceFailure, rig.read());
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().exceptions);
+    TEST_ASSERT_EQUAL_UINT32(0U, rig.probe.stats().replies);
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.node.getStats().exceptions);
+}
+
+void test_outage_window() {
+    Rig rig;
+    rig.probe.faults().outageFromUs = 0U;
+    rig.probe.faults().outageUntilUs = 1000000U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBResponseTimedOut, rig.read());
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().dropped);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, rig.read());
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().dropped);
+    TEST_ASSERT_EQUAL_UINT32(1U, rig.probe.stats().replies);
+}
+
+void test_mixed_faults_account_for_every_request() {
+    Rig rig;
+    // No injected exceptions: ModbusMaster returns an exception code at the
+    // fifth byte, before the CRC, so a corrupted one would not count as a CRC error.
+    rig.probe.faults().dropPermille = 100U;
+    rig.probe.faults().corruptPermille = 100U;
+    for (uint32_t i = 0U; i < REQUESTS; ++i) {
+        (void)rig.read();
+    }
+    const soilsim::SlaveStats& s = rig.probe.stats();
+    const ModbusMaster::Stats& m = rig.node.getStats();
+    TEST_ASSERT_TRUE(plausible(s.dropped, REQUESTS, 100U));
+    // Corruption only draws on replies that were not dropped.
+    TEST_ASSERT_TRUE(plausible(s.corrupted, REQUESTS - s.dropped, 100U));
+    TEST_ASSERT_EQUAL_UINT32(s.dropped, m.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(s.corrupted, m.crcErrors);
+    TEST_ASSERT_EQUAL_UINT32(s.replies - s.corrupted, m.responses);
+    TEST_ASSERT_EQUAL_UINT32(REQUESTS, static_cast<uint32_t>(m.timeouts) + m.crcErrors + m.responses);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_perfect_probe_replies);
+    RUN_TEST(test_dropped_reply_times_out);
+    RUN_TEST(test_drop_rate);
+    RUN_TEST(test_response_delay_shifts_reply);
+    RUN_TEST(test_late_reply_times_out);
+    RUN_TEST(test_corrupted_reply_fails_crc);
+    RUN_TEST(test_injected_exception);
+    RUN_TEST(test_outage_window);
+    RUN_TEST(test_mixed_faults_account_for_every_request);
+    return UNITY_END();
+}
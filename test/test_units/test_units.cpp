@@ -0,0 +1,285 @@
+/**
+ * @file test_units.cpp
+ * @brief Unit tests of the CRCs, ModbusMaster framing, SoilSensor decode and
+ *        scheduler_tick() on lib/native_hal.
+ * @details The Modbus port is a hal::FakeStream that is never begun, so the
+ *          wire takes no time: a request is complete in transmitted() when
+ *          start...() returns, and an injected reply is readable at once.
+ *          Run with `pio test -e native_test -f test_units`.
+ */
+#include <unity.h>
+#include <Arduino.h>
+#include "native_hal.h"
+#include "ModbusMaster.h"
+#include "SoilSensor.h"
+#include "cobs.h"
+#include "config.h"
+#include "scheduler.h"
+#include "soilsim.h"
+#include "soilsim_hal.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint8_t SLAVE = 1U;
+constexpr uint8_t RE_PIN = 7U;
+constexpr uint8_t DE_PIN = 6U;
+/// ModbusMaster's response timeout.
+constexpr uint32_t RESPONSE_TIMEOUT_US = 2000000UL;
+
+const uint8_t CHECK_STRING[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+/// Appends the Modbus CRC (low byte first) to the @p length bytes of @p frame.
+void seal(uint8_t* frame, uint8_t length) {
+    uint16_t crc = 0xFFFFU;
+    for (uint8_t i = 0U; i < length; ++i) {
+        crc = crc16_update(crc, frame[i]);
+    }
+    frame[length] = lowByte(crc);
+    frame[length + 1U] = highByte(crc);
+}
+
+/// Polls the transaction in progress until it ends; the reply is already in.
+uint8_t finish(ModbusMaster& node) {
+    uint8_t result = ModbusMaster::ku8MBPending;
+    for (uint16_t i = 0U; (i < 1000U) && (result == ModbusMaster::ku8MBPending); ++i) {
+        result = node.pollTransaction();
+    }
+    return result;
+}
+
+/// Reads one holding register and answers with @p reply.
+uint8_t readWithReply(const uint8_t* reply, uint8_t length, ModbusMaster& node, hal::FakeStream& port) {
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBPending, node.startReadHoldingRegisters(0x0007U, 1U));
+    port.clearTransmitted();
+    port.inject(reply, length);
+    return finish(node);
+}
+
+/// Releases of the three tasks in test_scheduler_tick_releases().
+uint32_t g_runs[3];
+
+int countFast(int state) {
+    ++g_runs[0];
+    return state;
+}
+
+int countMid(int state) {
+    ++g_runs[1];
+    return state;
+}
+
+int countSlow(int state) {
+    ++g_runs[2];
+    return state;
+}
+
+} // anonymous namespace
+
+void setUp() {
+    hal::reset();
+}
+
+void tearDown() {}
+
+void test_modbus_crc_check_value() {
+    uint16_t crc = 0xFFFFU;
+    for (uint8_t b : CHECK_STRING) {
+        crc = crc16_update(crc, b);
+    }
+    // CRC-16/MODBUS check value.
+    TEST_ASSERT_EQUAL_HEX16(0x4B37U, crc);
+    TEST_ASSERT_EQUAL_HEX16(0x4B37U, soilsim::crc(CHECK_STRING, sizeof(CHECK_STRING)));
+}
+
+void test_cobs_crc16_check_value() {
+    // CRC-16/CCITT-FALSE check value, in one pass and split across two.
+    TEST_ASSERT_EQUAL_HEX16(0x29B1U, cobs::crc16(cobs::CRC_INIT, CHECK_STRING, sizeof(CHECK_STRING)));
+    const uint16_t head = cobs::crc16(cobs::CRC_INIT, CHECK_STRING, 4U);
+    TEST_ASSERT_EQUAL_HEX16(0x29B1U, cobs::crc16(head, &CHECK_STRING[4], sizeof(CHECK_STRING) - 4U));
+}
+
+void test_read_request_frame() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBPending, node.startReadHoldingRegisters(0x0000U, 1U));
+    static const uint8_t EXPECTED[] = { 0x01U, 0x03U, 0x00U, 0x00U, 0x00U, 0x01U, 0x84U, 0x0AU };
+    TEST_ASSERT_EQUAL(sizeof(EXPECTED), port.transmitted().size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(EXPECTED, port.transmitted().data(), sizeof(EXPECTED));
+}
+
+void test_write_request_frame() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(0x11U, port);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBPending, node.startWriteSingleRegister(0x0001U, 0x0003U));
+    uint8_t expected[8] = { 0x11U, 0x06U, 0x00U, 0x01U, 0x00U, 0x03U };
+    seal(expected, 6U);
+    TEST_ASSERT_EQUAL(sizeof(expected), port.transmitted().size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, port.transmitted().data(), sizeof(expected));
+}
+
+void test_read_response_decoded() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    uint8_t reply[7] = { SLAVE, 0x03U, 0x02U, 0x12U, 0x34U };
+    seal(reply, 5U);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBSuccess, readWithReply(reply, sizeof(reply), node, port));
+    TEST_ASSERT_EQUAL_HEX16(0x1234U, node.getResponseBuffer(0U));
+    TEST_ASSERT_EQUAL(1U, node.getStats().responses);
+}
+
+void test_bad_crc_rejected() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    uint8_t reply[7] = { SLAVE, 0x03U, 0x02U, 0x12U, 0x34U };
+    seal(reply, 5U);
+    reply[6] ^= 0x01U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBInvalidCRC, readWithReply(reply, sizeof(reply), node, port));
+    TEST_ASSERT_EQUAL(1U, node.getStats().crcErrors);
+}
+
+void test_wrong_slave_rejected() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    uint8_t reply[7] = { SLAVE + 1U, 0x03U, 0x02U, 0x12U, 0x34U };
+    seal(reply, 5U);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBInvalidSlaveID, readWithReply(reply, sizeof(reply), node, port));
+}
+
+void test_wrong_byte_count_rejected() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    // Two registers for a one-register request: well formed, CRC good.
+    uint8_t reply[9] = { SLAVE, 0x03U, 0x04U, 0x12U, 0x34U, 0x56U, 0x78U };
+    seal(reply, 7U);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBInvalidByteCount, readWithReply(reply, sizeof(reply), node, port));
+    TEST_ASSERT_EQUAL(1U, node.getStats().badFrames);
+}
+
+void test_exception_response() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    uint8_t reply[5] = { SLAVE, 0x83U, ModbusMaster::ku8MBIllegalDataAddress };
+    seal(reply, 3U);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBIllegalDataAddress, readWithReply(reply, sizeof(reply), node, port));
+    TEST_ASSERT_EQUAL(1U, node.getStats().exceptions);
+}
+
+void test_no_reply_times_out() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBPending, node.startReadHoldingRegisters(0x0007U, 1U));
+    hal::advanceMicros(RESPONSE_TIMEOUT_US - 1000UL);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBPending, node.pollTransaction());
+    hal::advanceMicros(2000UL);
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBResponseTimedOut, node.pollTransaction());
+    TEST_ASSERT_EQUAL(1U, node.getStats().timeouts);
+}
+
+void test_oversize_request_refused() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    ModbusMaster node;
+    node.begin(SLAVE, port);
+    // The longest read whose reply (5 bytes plus 2 per register) fits the ADU, then one more.
+    constexpr uint16_t FITS = (MODBUS_ADU_BYTES - 5U) / 2U;
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBPending, node.startReadHoldingRegisters(0x0000U, FITS));
+    TEST_ASSERT_EQUAL(8U, port.transmitted().size());
+    hal::advanceMicros(RESPONSE_TIMEOUT_US + 1000UL);
+    (void)node.pollTransaction();
+    port.clearTransmitted();
+    TEST_ASSERT_EQUAL_HEX8(ModbusMaster::ku8MBIllegalDataValue,
+                           node.startReadHoldingRegisters(0x0000U, FITS + 1U));
+    TEST_ASSERT_EQUAL(0U, port.transmitted().size());
+}
+
+void test_soil_sensor_decode() {
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);
+    soilsim::Slave probe(SLAVE, 0UL);
+    soilsim::Readings& r = probe.readings();
+    r = { 412U, -37, 96U, 683U, 21U, 33U, 145U };
+    soilsim::Bus bus(0UL);
+    bus.attach(probe);
+    soilsim::BusPeer peer(bus);
+    port.setPeer(&peer);
+    ModbusMaster node;
+    SoilSensor sensor(node, RE_PIN, DE_PIN);
+    sensor.begin(port, 0L);
+
+    SoilSensor::SensorData data = {};
+    TEST_ASSERT_TRUE(sensor.readAll(data));
+    TEST_ASSERT_EQUAL_UINT16(r.moisture, data.moisture);
+    TEST_ASSERT_EQUAL_INT16(r.temperature, data.temperature);
+    TEST_ASSERT_EQUAL_UINT16(r.conductivity * 10U, data.conductivity);
+    TEST_ASSERT_EQUAL_UINT16(r.ph, data.ph);
+    TEST_ASSERT_EQUAL_UINT16(r.nitrogen, data.nitrogen);
+    TEST_ASSERT_EQUAL_UINT16(r.phosphorus, data.phosphorus);
+    TEST_ASSERT_EQUAL_UINT16(r.potassium, data.potassium);
+    // One request per block: pH, moisture+temperature, conductivity, NPK.
+    TEST_ASSERT_EQUAL_UINT32(SoilSensor::READ_BLOCK_COUNT, probe.stats().replies);
+
+    // A block that fails reads as INVALID and stops readAll() there.
+    probe.faults().exceptionPermille = 1000U;
+    probe.faults().exceptionCode = ModbusMaster::ku8MBSlaveDeviceFailure;
+    TEST_ASSERT_FALSE(sensor.readAll(data));
+    TEST_ASSERT_EQUAL_UINT16(SoilSensor::INVALID, data.ph);
+    TEST_ASSERT_EQUAL_UINT16(r.moisture, data.moisture);
+    port.setPeer(nullptr);
+}
+
+void test_scheduler_tick_releases() {
+    constexpr uint32_t GCD = scheduler::TASK_TICKS_GCD_IN_MS;
+    scheduler::Task tasks[] = {
+        scheduler::Task(GCD, &countFast),
+        scheduler::Task(5U * GCD, &countMid, 2U * GCD),
+        scheduler::Task(20U * GCD, &countSlow),
+    };
+    g_runs[0] = g_runs[1] = g_runs[2] = 0UL;
+    scheduler_init(tasks, 3U);
+    // Ticks at 0, GCD, ..., TICKS * GCD ms; releases at k * period + offset, k >= 1
+    // (k >= 0 with an offset).
+    constexpr uint32_t TICKS = 100U;
+    for (uint32_t i = 0U; i <= TICKS; ++i) {
+        scheduler_tick();
+    }
+    TEST_ASSERT_EQUAL_UINT32(TICKS, g_runs[0]);
+    TEST_ASSERT_EQUAL_UINT32(TICKS / 5U, g_runs[1]);
+    TEST_ASSERT_EQUAL_UINT32(TICKS / 20U, g_runs[2]);
+
+    // A suspended task is skipped; resumed, it runs on its next release.
+    TEST_ASSERT_TRUE(scheduler_task_suspend(0U));
+    for (uint32_t i = 0U; i < 10U; ++i) {
+        scheduler_tick();
+    }
+    TEST_ASSERT_EQUAL_UINT32(TICKS, g_runs[0]);
+    TEST_ASSERT_TRUE(scheduler_task_resume(0U));
+    scheduler_tick();
+    TEST_ASSERT_EQUAL_UINT32(TICKS + 1U, g_runs[0]);
+    TEST_ASSERT_FALSE(scheduler_task_suspend(3U));
+    TEST_ASSERT_FALSE(scheduler_task_set_period(1U, GCD + 1U));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_modbus_crc_check_value);
+    RUN_TEST(test_cobs_crc16_check_value);
+    RUN_TEST(test_read_request_frame);
+    RUN_TEST(test_write_request_frame);
+    RUN_TEST(test_read_response_decoded);
+    RUN_TEST(test_bad_crc_rejected);
+    RUN_TEST(test_wrong_slave_rejected);
+    RUN_TEST(test_wrong_byte_count_rejected);
+    RUN_TEST(test_exception_response);
+    RUN_TEST(test_no_reply_times_out);
+    RUN_TEST(test_oversize_request_refused);
+    RUN_TEST(test_soil_sensor_decode);
+    RUN_TEST(test_scheduler_tick_releases);
+    return UNITY_END();
+}
@@ -0,0 +1,264 @@
+/**
+ * @file avr_bench.cpp
+ * @brief Cycle benchmark image for simavr: replaces src/main.cpp.
+ * @details Links the unmodified firmware sources, runs setupHardware() and
+ *          then each case of avr_bench.h between GPIOR0 markers. The runner
+ *          (simavr_bench.cpp) counts the cycles between them, so the figures
+ *          include soft-float, digitalWrite and the bit-wise CRC exactly as
+ *          the target executes them. Timer0's overflow interrupt is masked
+ *          inside each bracket and nothing else is enabled, so no ISR time
+ *          leaks into a figure.
+ *
+ *          The sensor runs on a replay stream instead of SoftwareSerial: a
+ *          first, unmeasured readAll() records the four requests and builds
+ *          their replies, which are then handed back as soon as each request
+ *          is written. readAll() therefore measures framing, receive, CRC
+ *          check and decode, not the wire. The RS485 pre-transmission wait
+ *          (a fixed delay(10)) is left out for the same reason.
+ *
+ *          Build with `pio run -e simavr_bench`; see simavr_bench.cpp to run.
+ */
+#include <Arduino.h>
+#include "util/crc16.h"
+#include "avr_bench.h"
+#include "ModbusMaster.h"
+#include "SoilSensor.h"
+#include "config.h"
+#include "gpio.h"
+#include "scheduler.h"
+#include "setup.h"
+#include "tasks.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+using Rs485Direction = gpio::Bus<pins::RE_PIN, pins::DE_PIN>;
+
+/// Keeps results observable so the optimiser cannot drop the work.
+volatile uint16_t g_sink;
+
+/**
+ * @brief Runs @p body between a start and a stop marker for case @p id.
+ * @details Timer0 is the only interrupt source left on; it is masked for
+ *          the bracket, so millis() stands still inside it.
+ */
+template <typename Body>
+void measure(avr_bench::Case id, Body body) {
+    const uint8_t timsk = TIMSK0;
+    TIMSK0 = 0U;
+    GPIOR1 = id;
+    GPIOR0 = avr_bench::MARK_START;
+    body();
+    GPIOR0 = avr_bench::MARK_STOP;
+    TIMSK0 = timsk;
+}
+
+/**
+ * @class NullStream
+ * @brief Swallows requests and never answers: framing cost alone.
+ */
+class NullStream : public Stream {
+public:
+    size_t write(uint8_t) override { return 1U; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+};
+
+/**
+ * @class ReplayStream
+ * @brief Answers each 8-byte read request from replies built beforehand.
+ * @details While recording, a request is answered with registers holding
+ *          their address * 7 and the reply is kept; afterwards the kept
+ *          replies are served in order, without CRC work on this side.
+ */
+class ReplayStream : public Stream {
+public:
+    ReplayStream() noexcept
+        : request(), replies(), lengths(), count(0U), next(0U), reply(nullptr), left(0U), requestLength(0U),
+          recording(true) {}
+
+    void stopRecording() noexcept {
+        recording = false;
+        next = 0U;
+    }
+
+    size_t write(uint8_t value) override {
+        request[requestLength++] = value;
+        if (requestLength < REQUEST_BYTES) {
+            return 1U;
+        }
+        requestLength = 0U;
+        if (recording && (count < SoilSensor::READ_BLOCK_COUNT)) {
+            build(replies[count], lengths[count]);
+            ++count;
+        }
+        if (count != 0U) {
+            const uint8_t slot = static_cast<uint8_t>(next % count);
+            reply = replies[slot];
+            left = lengths[slot];
+            ++next;
+        }
+        return 1U;
+    }
+
+    int available() override { return left; }
+    int read() override {
+        if (left == 0U) {
+            return -1;
+        }
+        --left;
+        return *reply++;
+    }
+    int peek() override { return (left != 0U) ? *reply : -1; }
+    void flush() override {}
+
+private:
+    static constexpr uint8_t REQUEST_BYTES = 8U;
+    static constexpr uint8_t MAX_QTY = 3U;
+    static constexpr uint8_t MAX_REPLY = 5U + (2U * MAX_QTY);
+
+    void build(uint8_t* out, uint8_t& length) noexcept {
+        const uint16_t first = word(request[2], request[3]);
+        const uint8_t qty = (request[5] < MAX_QTY) ? request[5] : MAX_QTY;
+        uint8_t n = 0U;
+        out[n++] = request[0];
+        out[n++] = request[1];
+        out[n++] = static_cast<uint8_t>(2U * qty);
+        for (uint8_t i = 0U; i < qty; ++i) {
+            const uint16_t content = static_cast<uint16_t>((first + i) * 7U);
+            out[n++] = highByte(content);
+            out[n++] = lowByte(content);
+        }
+        uint16_t crc = 0xFFFFU;
+        for (uint8_t i = 0U; i < n; ++i) {
+            crc = crc16_update(crc, out[i]);
+        }
+        out[n++] = lowByte(crc);
+        out[n++] = highByte(crc);
+        length = n;
+    }
+
+    // JSF AV C++ Rule 23: All data members shall be private.
+    uint8_t request[REQUEST_BYTES];
+    uint8_t replies[SoilSensor::READ_BLOCK_COUNT][MAX_REPLY];
+    uint8_t lengths[SoilSensor::READ_BLOCK_COUNT];
+    uint8_t count;          ///< Replies recorded.
+    uint8_t next;           ///< Requests answered since recording stopped.
+    const uint8_t* reply;   ///< Unread part of the current reply.
+    uint8_t left;
+    uint8_t requestLength;
+    bool recording;
+};
+
+void rs485Direction(bool transmit) { Rs485Direction::write(transmit ? 0x03U : 0x00U); }
+void benchPreTransmission() { rs485Direction(true); }
+
+void benchCrc() {
+    // A 64-byte pattern read round and round keeps the image's SRAM small.
+    static uint8_t data[64];
+    for (uint16_t i = 0U; i < sizeof(data); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37U);
+    }
+    measure(avr_bench::CRC16_UPDATE, []() {
+        uint16_t crc = 0xFFFFU;
+        for (uint16_t i = 0U; i < avr_bench::OPS[avr_bench::CRC16_UPDATE]; ++i) {
+            crc = crc16_update(crc, data[i & (sizeof(data) - 1U)]);
+        }
+        g_sink = crc;
+    });
+}
+
+void benchModbus() {
+    // The firmware's own master and sensor: the image has no room for a
+    // second ModbusMaster and its ADU buffers.
+    static NullStream sink;
+    node.begin(1U, sink);
+    measure(avr_bench::MODBUS_FRAMING, []() {
+        for (uint16_t i = 0U; i < avr_bench::OPS[avr_bench::MODBUS_FRAMING]; ++i) {
+            (void)node.startReadHoldingRegisters(static_cast<uint16_t>(i & 0x3FU), 3U);
+        }
+    });
+
+    // gSensor is never polled by this image, so it can move to the replay.
+    static ReplayStream replay;
+    gSensor.begin(replay, static_cast<long>(pins::SERIAL_BAUD_RATE));
+    node.preTransmission(&benchPreTransmission);
+    static SoilSensor::SensorData data;
+    (void)gSensor.readAll(data);
+    replay.stopRecording();
+    measure(avr_bench::SOIL_READALL, []() {
+        for (uint16_t i = 0U; i < avr_bench::OPS[avr_bench::SOIL_READALL]; ++i) {
+            g_sink = gSensor.readAll(data) ? data.potassium : 0U;
+        }
+    });
+}
+
+int benchTask(int state) {
+    g_sink = static_cast<uint16_t>(g_sink + 1U);
+    return state;
+}
+
+scheduler::Task g_benchTasks[] = {
+    scheduler::Task(timing::LED_TOGGLE_PERIOD_MS, &benchTask),
+    scheduler::Task(timing::SENSOR_READ_PERIOD_MS, &benchTask),
+    scheduler::Task(timing::LCD_UPDATE_PERIOD_MS, &benchTask),
+};
+constexpr uint8_t BENCH_TASK_COUNT = sizeof(g_benchTasks) / sizeof(g_benchTasks[0]);
+
+void benchScheduler() {
+    scheduler_init(g_benchTasks, BENCH_TASK_COUNT);
+    measure(avr_bench::SCHEDULER_TICK, []() {
+        for (uint16_t i = 0U; i < avr_bench::OPS[avr_bench::SCHEDULER_TICK]; ++i) {
+            scheduler_tick();
+        }
+    });
+}
+
+void benchLcdUpdate() {
+#if ENABLE_LCD
+    Sample sample = {};
+    sample.ok = true;
+    sample.data.moisture = 840U;
+    sample.data.temperature = 291;
+    sample.data.conductivity = 240U;
+    sample.data.ph = 786U;
+    sample.data.nitrogen = 16U;
+    sample.data.phosphorus = 23U;
+    sample.data.potassium = 46U;
+    gLatestSample.publish(sample);
+
+    // One call per bracket; the queued LCD writes are clocked out in between.
+    while (gLcd.pump()) {
+    }
+    for (uint16_t i = 0U; i < avr_bench::OPS[avr_bench::TASK_LCD_UPDATE]; ++i) {
+        measure(avr_bench::TASK_LCD_UPDATE, []() {
+            g_sink = static_cast<uint16_t>(Task_LcdUpdate(0));
+        });
+        while (gLcd.pump()) {
+        }
+    }
+#endif
+}
+
+} // anonymous namespace
+
+int main(void) {
+    init();
+    setupHardware();
+    sei();
+
+    for (uint8_t i = 0U; i < avr_bench::OPS[avr_bench::EMPTY]; ++i) {
+        measure(avr_bench::EMPTY, []() {});
+    }
+    benchCrc();
+    benchModbus();
+    benchScheduler();
+    benchLcdUpdate();
+
+    GPIOR0 = avr_bench::MARK_DONE;
+    cli();
+    while (true) {
+    }
+}
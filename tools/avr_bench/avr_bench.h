@@ -0,0 +1,52 @@
+#ifndef AVR_BENCH_H
+#define AVR_BENCH_H
+
+#include <stdint.h>
+
+/**
+ * @file avr_bench.h
+ * @brief Marker protocol shared by the simavr benchmark image and its runner.
+ * @details The image (avr_bench.cpp) brackets each measured section with
+ *          writes to GPIOR0: it loads the case id into GPIOR1, writes
+ *          MARK_START, runs the section and writes MARK_STOP. The runner
+ *          (simavr_bench.cpp) hooks GPIOR0 and timestamps each write with the
+ *          simulator's cycle counter, so the figures are exact AVR cycles
+ *          independent of Timer0/Timer1. A case may be bracketed several
+ *          times; its cycles add up and are divided by its OPS entry. The
+ *          EMPTY case measures the bracket itself, which the runner subtracts
+ *          once per bracket. MARK_DONE ends the run.
+ */
+namespace avr_bench {
+
+/// Data-space addresses of the general purpose I/O registers (ATmega328P).
+constexpr uint16_t GPIOR0_ADDRESS = 0x3EU;
+constexpr uint16_t GPIOR1_ADDRESS = 0x4AU;
+
+constexpr uint8_t MARK_START = 0x01U;
+constexpr uint8_t MARK_STOP = 0x02U;
+constexpr uint8_t MARK_DONE = 0xFFU;
+
+/// Case ids, written to GPIOR1 before MARK_START.
+enum Case : uint8_t {
+    EMPTY = 0U,           ///< Bracket overhead.
+    CRC16_UPDATE,         ///< crc16_update (lib/modbus/util/crc16.h), per byte.
+    MODBUS_FRAMING,       ///< ModbusMaster::startReadHoldingRegisters, per request.
+    SOIL_READALL,         ///< SoilSensor::readAll with replies already received.
+    SCHEDULER_TICK,       ///< scheduler_tick with three idle tasks, per tick.
+    TASK_LCD_UPDATE,      ///< Task_LcdUpdate, per call (all pages in turn).
+    CASE_COUNT
+};
+
+/// Operations per case; the image runs exactly this many.
+constexpr uint16_t OPS[CASE_COUNT] = {
+    1U,     // EMPTY
+    256U,   // CRC16_UPDATE
+    32U,    // MODBUS_FRAMING
+    4U,     // SOIL_READALL
+    1000U,  // SCHEDULER_TICK
+    8U,     // TASK_LCD_UPDATE
+};
+
+} // namespace avr_bench
+
+#endif // AVR_BENCH_H
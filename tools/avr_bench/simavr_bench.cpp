@@ -0,0 +1,159 @@
+/**
+ * @file simavr_bench.cpp
+ * @brief Runs the avr_bench image in simavr and writes its cycle counts.
+ * @details Loads the ELF on a simulated ATmega328P at 16 MHz, hooks GPIOR0
+ *          and timestamps every marker the image writes (avr_bench.h) with
+ *          the simulator's cycle counter. Each case is reported as cycles per
+ *          operation with the bracket overhead removed. The results file is
+ *          one tab-separated line per case in a fixed order, so committing it
+ *          next to a change makes any cycle regression show up in the diff;
+ *          the same figures are printed in the `bench <label>: ...` form of
+ *          bench_run().
+ *
+ *          Build (needs libsimavr and libelf) and run from the repository root:
+ *
+ *              pio run -e simavr_bench
+ *              g++ -std=gnu++11 -O2 -Itools/avr_bench $(pkg-config --cflags simavr) \
+ *                  tools/avr_bench/simavr_bench.cpp -o simavr_bench $(pkg-config --libs simavr) -lelf
+ *              ./simavr_bench .pio/build/simavr_bench/firmware.elf tools/avr_bench/results.tsv
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/sim_io.h>
+#include "avr_bench.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint32_t FREQUENCY_HZ = 16000000UL;
+/// Give up after this many cycles (~2 minutes of target time).
+constexpr uint64_t CYCLE_LIMIT = 2000000000ULL;
+
+struct CaseInfo {
+    const char* key;    ///< Results file key; never rename, it is the diff anchor.
+    const char* label;  ///< Human-readable name.
+    const char* unit;
+};
+
+// Indexed by avr_bench::Case.
+constexpr CaseInfo CASES[avr_bench::CASE_COUNT] = {
+    { "empty", "marker bracket", "cycles" },
+    { "crc16_update", "modbus crc16_update", "cycles/byte" },
+    { "modbus_framing", "modbus request framing", "cycles/request" },
+    { "soil_readall", "soil readAll decode", "cycles/readAll" },
+    { "scheduler_tick", "scheduler tick", "cycles/tick" },
+    { "task_lcd_update", "Task_LcdUpdate", "cycles/call" },
+};
+
+struct Totals {
+    uint64_t cycles;
+    uint32_t brackets;
+};
+
+struct Run {
+    Totals totals[avr_bench::CASE_COUNT];
+    uint64_t startCycle;
+    uint8_t current;   ///< Case being measured, or CASE_COUNT.
+    bool done;
+    bool error;
+};
+
+void onMarker(avr_t* avr, avr_io_addr_t addr, uint8_t value, void* param) {
+    Run& run = *static_cast<Run*>(param);
+    avr->data[addr] = value;
+    if (value == avr_bench::MARK_START) {
+        const uint8_t id = avr->data[avr_bench::GPIOR1_ADDRESS];
+        if ((run.current != avr_bench::CASE_COUNT) || (id >= avr_bench::CASE_COUNT)) {
+            fprintf(stderr, "bad start marker for case %u at cycle %llu\n", static_cast<unsigned>(id),
+                    static_cast<unsigned long long>(avr->cycle));
+            run.error = true;
+            return;
+        }
+        run.current = id;
+        run.startCycle = avr->cycle;
+    } else if (value == avr_bench::MARK_STOP) {
+        if (run.current == avr_bench::CASE_COUNT) {
+            fprintf(stderr, "stop marker without start at cycle %llu\n", static_cast<unsigned long long>(avr->cycle));
+            run.error = true;
+            return;
+        }
+        run.totals[run.current].cycles += avr->cycle - run.startCycle;
+        ++run.totals[run.current].brackets;
+        run.current = avr_bench::CASE_COUNT;
+    } else if (value == avr_bench::MARK_DONE) {
+        run.done = true;
+    }
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s firmware.elf [results.tsv]\n", argv[0]);
+        return 2;
+    }
+
+    elf_firmware_t firmware = {};
+    if (elf_read_firmware(argv[1], &firmware) != 0) {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    avr_t* avr = avr_make_mcu_by_name("atmega328p");
+    if (avr == nullptr) {
+        fprintf(stderr, "simavr has no atmega328p core\n");
+        return 1;
+    }
+    avr_init(avr);
+    firmware.frequency = FREQUENCY_HZ;
+    avr_load_firmware(avr, &firmware);
+
+    Run run = {};
+    run.current = avr_bench::CASE_COUNT;
+    avr_register_io_write(avr, avr_bench::GPIOR0_ADDRESS, onMarker, &run);
+
+    int state = cpu_Running;
+    while (!run.done && !run.error && (state != cpu_Done) && (state != cpu_Crashed) && (avr->cycle < CYCLE_LIMIT)) {
+        state = avr_run(avr);
+    }
+    if (!run.done || run.error) {
+        fprintf(stderr, "image did not finish (state %d, cycle %llu)\n", state,
+                static_cast<unsigned long long>(avr->cycle));
+        return 1;
+    }
+
+    const Totals& empty = run.totals[avr_bench::EMPTY];
+    const double overhead = (empty.brackets != 0U) ? (static_cast<double>(empty.cycles) / empty.brackets) : 0.0;
+
+    FILE* out = (argc > 2) ? fopen(argv[2], "w") : nullptr;
+    if ((argc > 2) && (out == nullptr)) {
+        perror(argv[2]);
+        return 1;
+    }
+    if (out != nullptr) {
+        fprintf(out, "# case\tops\tcycles\tcycles_per_op\n");
+    }
+    int status = 0;
+    for (uint8_t id = 0U; id < avr_bench::CASE_COUNT; ++id) {
+        const Totals& t = run.totals[id];
+        if (t.brackets == 0U) {
+            fprintf(stderr, "case %s was not measured\n", CASES[id].key);
+            status = 1;
+            continue;
+        }
+        // The EMPTY case is the overhead itself and is reported raw.
+        const double net = (id == avr_bench::EMPTY) ? static_cast<double>(t.cycles)
+                                                    : (static_cast<double>(t.cycles) - (overhead * t.brackets));
+        const double perOp = net / avr_bench::OPS[id];
+        printf("bench %s: %.1f %s\n", CASES[id].label, perOp, CASES[id].unit);
+        if (out != nullptr) {
+            fprintf(out, "%s\t%u\t%.0f\t%.1f\n", CASES[id].key, static_cast<unsigned>(avr_bench::OPS[id]), net, perOp);
+        }
+    }
+    if (out != nullptr) {
+        fclose(out);
+    }
+    avr_terminate(avr);
+    return status;
+}
@@ -0,0 +1,484 @@
+/**
+ * @file bus_bench.cpp
+ * @brief RS485 segment throughput sweep: how many probes fit on one bus.
+ * @details Runs the SoilSensor read path against simulated probes (lib/soilsim)
+ *          on lib/native_hal's virtual clock, so every figure is exact wire
+ *          and turnaround time, repeatable, and computed much faster than real
+ *          time. The master polls its slaves back to back, round robin, for a
+ *          fixed span of virtual time per configuration. The sweep covers:
+ *
+ *          - baud rate of the segment;
+ *          - DE turnaround: the master's wait between raising DE and sending
+ *            (the firmware waits 10 ms in SoilSensor::preTransmission);
+ *          - register coalescing: "blocks" is readAll() itself (four
+ *            requests), "two" reads 0x06-0x15 and 0x1E-0x20, "span" reads
+ *            0x06-0x20 in one request;
+ *          - retries per failed request (the response timeout stays at
+ *            ModbusMaster's 2 s);
+ *          - slaves on the segment.
+ *
+ *          For each configuration it reports good samples per second, bus
+ *          utilisation (fraction of time a character is on the wire), p50 and
+ *          p99 poll latency (first request to last reply of one slave's
+ *          sample) and how many probes fit at the refresh period: the largest
+ *          count whose mean round time stays within it. Probes answer after
+ *          --reply-delay and lose --loss per mille of replies, which is what
+ *          the retry policy is up against.
+ *
+ *          A lost reply costs the 2 s response timeout, so at 1 % loss a
+ *          120 s run sees only a few dozen and its mean poll time is noisy.
+ *          "fit" is therefore not taken from the run: each request of one
+ *          poll is timed once without loss, one lost attempt is timed, and
+ *          the expected poll time follows from independent losses:
+ *          attempts that fail cost the timeout, a request that fails
+ *          every retry ends the poll. "sim" is the 95 % confidence interval
+ *          of the same count from the run's own polls (mean +- 1.96 standard
+ *          errors); a "fit" outside it means the loss model is off.
+ *
+ *          Build and run from the repository root:
+ *
+ *              g++ -std=gnu++11 -O2 -DF_CPU=16000000UL -Ilib/native_hal/include -Iinclude \
+ *                  -Ilib/modbus -Ilib/soilsensor -Ilib/soilsim tools/bus_bench/bus_bench.cpp \
+ *                  lib/modbus/ModbusMaster.cpp lib/soilsensor/SoilSensor.cpp lib/soilsim/soilsim.cpp \
+ *                  lib/soilsim/soilsim_hal.cpp $(find lib/native_hal/src -name '*.cpp') -o bus_bench
+ *              ./bus_bench --baud 9600 --turnaround 0,10000 --slaves 1,8 --csv results.csv
+ *
+ *          or `pio run -e bus_bench && .pio/build/bus_bench/program`. Every
+ *          list option takes comma-separated values; without options the full
+ *          default grid runs.
+ */
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <vector>
+#include <Arduino.h>
+#include "native_hal.h"
+#include "ModbusMaster.h"
+#include "SoilSensor.h"
+#include "sensor_registers.h"
+#include "soilsim_hal.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+/// Empty polls advance 10 us: fine enough for latency, coarse enough to be quick.
+constexpr uint32_t POLL_CYCLES = 10UL * hal::CYCLES_PER_US;
+constexpr uint8_t RE_PIN = 7U;
+constexpr uint8_t DE_PIN = 6U;
+
+enum class Coalesce : uint8_t { BLOCKS, TWO, SPAN };
+
+struct Range {
+    uint16_t first;
+    uint16_t qty;
+};
+
+// Coalesced request plans; BLOCKS goes through SoilSensor::startReadBlock().
+constexpr Range TWO_RANGES[] = {
+    { sensor_registers::SOIL_PH_REG, sensor_registers::SOIL_CONDUCTIVITY_REG - sensor_registers::SOIL_PH_REG + 1U },
+    { sensor_registers::SOIL_NITROGEN_REG, sensor_registers::SOIL_POTASSIUM_REG - sensor_registers::SOIL_NITROGEN_REG + 1U },
+};
+constexpr Range SPAN_RANGES[] = {
+    { sensor_registers::SOIL_PH_REG, sensor_registers::SOIL_POTASSIUM_REG - sensor_registers::SOIL_PH_REG + 1U },
+};
+
+const char* coalesceName(Coalesce mode) {
+    return (mode == Coalesce::BLOCKS) ? "blocks" : ((mode == Coalesce::TWO) ? "two" : "span");
+}
+
+struct Config {
+    uint32_t baud;
+    uint32_t turnaroundUs;
+    Coalesce mode;
+    uint8_t retries;
+    uint8_t slaves;
+};
+
+struct Options {
+    std::vector<uint32_t> bauds{ 2400UL, 4800UL, 9600UL };
+    std::vector<uint32_t> turnarounds{ 0UL, 1000UL, 10000UL };
+    std::vector<Coalesce> modes{ Coalesce::BLOCKS, Coalesce::TWO, Coalesce::SPAN };
+    std::vector<uint32_t> retries{ 0UL, 1UL, 2UL };
+    std::vector<uint32_t> slaves{ 1UL, 4UL, 16UL };
+    uint32_t replyDelayUs = 2000UL;
+    uint32_t lossPermille = 10UL;
+    uint32_t seconds = 120UL;
+    uint32_t refreshMs = 10000UL;
+    const char* csv = nullptr;
+};
+
+struct Result {
+    uint32_t samples;      ///< Polls completed, good or not.
+    uint32_t good;         ///< Polls with every register read.
+    double goodPerS;
+    double utilisation;
+    double p50Ms;
+    double p99Ms;
+    double roundMs;        ///< Mean time for one poll of every slave.
+    uint32_t fit;          ///< Probes per segment at the refresh period, from expectedPollUs().
+    uint32_t simLow;       ///< 95 % interval of the same count from the run's polls.
+    uint32_t simHigh;
+};
+
+/**
+ * @class WireMeter
+ * @brief A BusPeer that also counts the characters on the wire.
+ */
+class WireMeter : public hal::SerialPeer {
+public:
+    explicit WireMeter(soilsim::Bus& bus) noexcept : inner(bus), characters(0UL) {}
+
+    void onTransmit(hal::FakeStream& port, uint8_t value, uint64_t end_cycle) override {
+        const size_t before = port.rxScheduled();
+        inner.onTransmit(port, value, end_cycle);
+        characters += 1UL + static_cast<uint32_t>(port.rxScheduled() - before);
+    }
+
+    uint32_t count() const noexcept { return characters; }
+
+private:
+    soilsim::BusPeer inner;
+    uint32_t characters;   ///< Request plus reply characters.
+};
+
+uint32_t g_turnaroundUs = 0UL;
+
+/// Replaces SoilSensor's fixed 10 ms DE lead with the swept one.
+void preTransmission() {
+    if (g_turnaroundUs != 0UL) {
+        delayMicroseconds(g_turnaroundUs);
+    }
+}
+
+/**
+ * @brief One segment: the probes, the master's port and its SoilSensor.
+ * @details Built after hal::reset(); the virtual clock starts at zero.
+ */
+struct Segment {
+    soilsim::Bus bus;
+    std::vector<std::unique_ptr<soilsim::Slave>> probes;
+    hal::FakeStream port;
+    WireMeter meter;
+    ModbusMaster node;
+    SoilSensor sensor;
+
+    Segment(const Config& config, const Options& options)
+        : bus(config.baud), probes(), port(0U), meter(bus), node(), sensor(node, RE_PIN, DE_PIN) {
+        for (uint8_t i = 0U; i < config.slaves; ++i) {
+            const uint8_t address = static_cast<uint8_t>(i + 1U);
+            probes.emplace_back(new soilsim::Slave(address, config.baud, 0x5EEDUL + address));
+            probes.back()->faults().responseDelayUs = options.replyDelayUs;
+            bus.attach(*probes.back());
+        }
+        setLoss(options.lossPermille);
+        port.begin(config.baud);
+        port.setPeer(&meter);
+        sensor.begin(port, static_cast<long>(config.baud));
+        node.preTransmission(&preTransmission);
+    }
+
+    ~Segment() {
+        port.setPeer(nullptr);
+        port.end();
+    }
+
+    void setLoss(uint32_t permille) {
+        for (std::unique_ptr<soilsim::Slave>& probe : probes) {
+            probe->faults().dropPermille = static_cast<uint16_t>(permille);
+        }
+    }
+};
+
+/// Requests in one poll under @p mode.
+uint8_t requestCount(Coalesce mode) {
+    return (mode == Coalesce::BLOCKS) ? SoilSensor::READ_BLOCK_COUNT : ((mode == Coalesce::TWO) ? 2U : 1U);
+}
+
+/// One attempt at request @p r of a poll; returns the Modbus result.
+uint8_t attempt(const Config& config, Segment& segment, uint8_t r) {
+    SoilSensor::SensorData data;
+    uint8_t result = ModbusMaster::ku8MBPending;
+    if (config.mode == Coalesce::BLOCKS) {
+        result = segment.sensor.startReadBlock(r);
+        while (result == ModbusMaster::ku8MBPending) {
+            result = segment.sensor.pollReadBlock(data);
+        }
+        return result;
+    }
+    const Range& range = ((config.mode == Coalesce::TWO) ? TWO_RANGES : SPAN_RANGES)[r];
+    result = segment.node.startReadHoldingRegisters(range.first, range.qty);
+    while (result == ModbusMaster::ku8MBPending) {
+        result = segment.node.pollTransaction();
+    }
+    return result;
+}
+
+/// One poll of the current slave; true if every register was read.
+bool pollOnce(const Config& config, Segment& segment) {
+    for (uint8_t r = 0U; r < requestCount(config.mode); ++r) {
+        uint8_t result = ModbusMaster::ku8MBResponseTimedOut;
+        for (uint8_t a = 0U; (a <= config.retries) && (result != ModbusMaster::ku8MBSuccess); ++a) {
+            result = attempt(config, segment, r);
+        }
+        if (result != ModbusMaster::ku8MBSuccess) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double elapsedUs(uint64_t since) {
+    return static_cast<double>(hal::cycles() - since) / hal::CYCLES_PER_US;
+}
+
+/**
+ * @brief Expected time of one poll at the configured loss, in us.
+ * @details Times each request once without loss and one attempt whose reply
+ *          is lost. With p the loss per attempt and q = p^(retries + 1) the
+ *          chance a request fails outright, a request costs
+ *          (1 - q) * ok + (p + ... + p^(retries + 1)) * lost, and is only
+ *          reached if every request before it succeeded.
+ */
+double expectedPollUs(const Config& config, const Options& options) {
+    hal::reset();
+    hal::setPollCycles(POLL_CYCLES);
+    g_turnaroundUs = config.turnaroundUs;
+    Segment segment(config, options);
+    segment.sensor.setSlaveAddress(1U);
+
+    segment.setLoss(0UL);
+    std::vector<double> okUs;
+    for (uint8_t r = 0U; r < requestCount(config.mode); ++r) {
+        const uint64_t start = hal::cycles();
+        (void)attempt(config, segment, r);
+        okUs.push_back(elapsedUs(start));
+    }
+    segment.setLoss(1000UL);
+    const uint64_t start = hal::cycles();
+    (void)attempt(config, segment, 0U);
+    const double lostUs = elapsedUs(start);
+
+    const double p = static_cast<double>(std::min<uint32_t>(options.lossPermille, 1000UL)) / 1000.0;
+    double failedAttempts = 0.0;
+    double pk = 1.0;
+    for (uint32_t k = 0U; k <= config.retries; ++k) {
+        pk *= p;
+        failedAttempts += pk;
+    }
+    const double q = pk;
+    double reach = 1.0;
+    double total = 0.0;
+    for (double ok : okUs) {
+        total += reach * (((1.0 - q) * ok) + (failedAttempts * lostUs));
+        reach *= 1.0 - q;
+    }
+    return total;
+}
+
+double percentile(std::vector<uint64_t>& values, uint32_t permille) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    const size_t index = ((values.size() - 1U) * permille) / 1000U;
+    std::nth_element(values.begin(), values.begin() + static_cast<long>(index), values.end());
+    return static_cast<double>(values[index]) / (1000.0 * hal::CYCLES_PER_US);
+}
+
+/// Probes whose polls fit the refresh period at @p pollMs each.
+uint32_t fitFor(const Options& options, double pollMs) {
+    const double n = (pollMs > 0.0) ? (options.refreshMs / pollMs) : 1e9;
+    return static_cast<uint32_t>(std::min(n, 1e9));
+}
+
+Result run(const Config& config, const Options& options) {
+    const double expectedMs = expectedPollUs(config, options) / 1000.0;
+
+    hal::reset();
+    hal::setPollCycles(POLL_CYCLES);
+    g_turnaroundUs = config.turnaroundUs;
+    Segment segment(config, options);
+
+    const uint64_t span = static_cast<uint64_t>(options.seconds) * 1000000ULL * hal::CYCLES_PER_US;
+    std::vector<uint64_t> latencies;
+    Result result = {};
+    uint8_t next = 0U;
+    while (hal::cycles() < span) {
+        segment.sensor.setSlaveAddress(static_cast<uint8_t>(next + 1U));
+        next = static_cast<uint8_t>((next + 1U) % config.slaves);
+        const uint64_t start = hal::cycles();
+        const bool ok = pollOnce(config, segment);
+        latencies.push_back(hal::cycles() - start);
+        ++result.samples;
+        result.good += ok ? 1UL : 0UL;
+        segment.port.clearTransmitted();
+    }
+
+    const double elapsedS = static_cast<double>(hal::cycles()) / F_CPU;
+    const double charS = 10.0 / config.baud;
+    result.goodPerS = result.good / elapsedS;
+    result.utilisation = (segment.meter.count() * charS) / elapsedS;
+    result.roundMs = (elapsedS * 1000.0 * config.slaves) / result.samples;
+    result.p50Ms = percentile(latencies, 500U);
+    result.p99Ms = percentile(latencies, 990U);
+    result.fit = fitFor(options, expectedMs);
+
+    // Mean poll time per probe and its standard error over this run's polls.
+    double sum = 0.0;
+    double sumSq = 0.0;
+    for (uint64_t cycles : latencies) {
+        const double ms = static_cast<double>(cycles) / (1000.0 * hal::CYCLES_PER_US);
+        sum += ms;
+        sumSq += ms * ms;
+    }
+    const double n = static_cast<double>(latencies.size());
+    const double meanMs = sum / n;
+    const double variance = (n > 1.0) ? std::max(0.0, (sumSq - (n * meanMs * meanMs)) / (n - 1.0)) : 0.0;
+    const double marginMs = 1.96 * sqrt(variance / n);
+    result.simLow = fitFor(options, meanMs + marginMs);
+    result.simHigh = fitFor(options, meanMs - marginMs);
+    return result;
+}
+
+template <typename T>
+bool parseList(const char* text, std::vector<T>& out) {
+    out.clear();
+    const char* p = text;
+    while (*p != '\0') {
+        char* end = nullptr;
+        const unsigned long value = strtoul(p, &end, 0);
+        if ((end == p) || ((*end != ',') && (*end != '\0'))) {
+            return false;
+        }
+        out.push_back(static_cast<T>(value));
+        p = (*end == ',') ? (end + 1) : end;
+    }
+    return !out.empty();
+}
+
+bool parseModes(const char* text, std::vector<Coalesce>& out) {
+    out.clear();
+    const char* p = text;
+    while (*p != '\0') {
+        const char* comma = strchr(p, ',');
+        const size_t length = (comma != nullptr) ? static_cast<size_t>(comma - p) : strlen(p);
+        if ((length == 6U) && (strncmp(p, "blocks", length) == 0)) {
+            out.push_back(Coalesce::BLOCKS);
+        } else if ((length == 3U) && (strncmp(p, "two", length) == 0)) {
+            out.push_back(Coalesce::TWO);
+        } else if ((length == 4U) && (strncmp(p, "span", length) == 0)) {
+            out.push_back(Coalesce::SPAN);
+        } else {
+            return false;
+        }
+        p += length + ((comma != nullptr) ? 1U : 0U);
+    }
+    return !out.empty();
+}
+
+void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--baud list] [--turnaround us,...] [--coalesce blocks,two,span]\n"
+                    "       [--retries list] [--slaves list] [--reply-delay us] [--loss permille]\n"
+                    "       [--seconds virtual_s] [--refresh ms] [--csv file]\n", argv0);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    bool ok = true;
+    for (int i = 1; (i < argc) && ok; ++i) {
+        const char* value = ((i + 1) < argc) ? argv[i + 1] : nullptr;
+        ok = (value != nullptr);
+        if (!ok) {
+            break;
+        }
+        ++i;
+        if (strcmp(argv[i - 1], "--baud") == 0) {
+            ok = parseList(value, options.bauds);
+        } else if (strcmp(argv[i - 1], "--turnaround") == 0) {
+            ok = parseList(value, options.turnarounds);
+        } else if (strcmp(argv[i - 1], "--coalesce") == 0) {
+            ok = parseModes(value, options.modes);
+        } else if (strcmp(argv[i - 1], "--retries") == 0) {
+            ok = parseList(value, options.retries);
+        } else if (strcmp(argv[i - 1], "--slaves") == 0) {
+            ok = parseList(value, options.slaves);
+        } else if (strcmp(argv[i - 1], "--reply-delay") == 0) {
+            options.replyDelayUs = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(argv[i - 1], "--loss") == 0) {
+            options.lossPermille = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(argv[i - 1], "--seconds") == 0) {
+            options.seconds = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(argv[i - 1], "--refresh") == 0) {
+            options.refreshMs = static_cast<uint32_t>(strtoul(value, nullptr, 0));
+        } else if (strcmp(argv[i - 1], "--csv") == 0) {
+            options.csv = value;
+        } else {
+            ok = false;
+        }
+    }
+    for (uint32_t slaves : options.slaves) {
+        ok = ok && (slaves != 0UL) && (slaves <= 247UL);
+    }
+    for (uint32_t baud : options.bauds) {
+        ok = ok && (soilsim::baudForCode(static_cast<uint16_t>(baud)) == baud);
+    }
+    if (!ok || (options.seconds == 0UL)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* csv = (options.csv != nullptr) ? fopen(options.csv, "w") : nullptr;
+    if ((options.csv != nullptr) && (csv == nullptr)) {
+        perror(options.csv);
+        return 1;
+    }
+    if (csv != nullptr) {
+        fprintf(csv, "baud,turnaround_us,coalesce,retries,slaves,samples,good,good_per_s,utilisation,p50_ms,p99_ms,"
+                     "round_ms,fit,sim_fit_low,sim_fit_high\n");
+    }
+    printf("reply delay %lu us, loss %lu per mille, %lu s virtual per row, fit at %lu ms refresh\n",
+           static_cast<unsigned long>(options.replyDelayUs), static_cast<unsigned long>(options.lossPermille),
+           static_cast<unsigned long>(options.seconds), static_cast<unsigned long>(options.refreshMs));
+    printf("fit: expected from loss-free request times and the cost of a lost reply; "
+           "sim: 95 %% interval from the run\n");
+    printf("%6s %7s %-6s %3s %4s | %9s %6s %9s %9s %9s %5s %11s\n", "baud", "turn_us", "mode", "rty", "n",
+           "good/s", "util", "p50_ms", "p99_ms", "round_ms", "fit", "sim");
+
+    for (uint32_t baud : options.bauds) {
+        for (uint32_t turnaround : options.turnarounds) {
+            for (Coalesce mode : options.modes) {
+                for (uint32_t retries : options.retries) {
+                    for (uint32_t slaves : options.slaves) {
+                        const Config config = { baud, turnaround, mode, static_cast<uint8_t>(retries),
+                                                static_cast<uint8_t>(slaves) };
+                        const Result r = run(config, options);
+                        printf("%6lu %7lu %-6s %3u %4u | %9.2f %5.1f%% %9.1f %9.1f %9.1f %5lu %5lu-%-5lu\n",
+                               static_cast<unsigned long>(baud), static_cast<unsigned long>(turnaround),
+                               coalesceName(mode), static_cast<unsigned>(retries), static_cast<unsigned>(slaves),
+                               r.goodPerS, 100.0 * r.utilisation, r.p50Ms, r.p99Ms, r.roundMs,
+                               static_cast<unsigned long>(r.fit), static_cast<unsigned long>(r.simLow),
+                               static_cast<unsigned long>(r.simHigh));
+                        if (csv != nullptr) {
+                            fprintf(csv, "%lu,%lu,%s,%u,%u,%lu,%lu,%.3f,%.4f,%.2f,%.2f,%.2f,%lu,%lu,%lu\n",
+                                    static_cast<unsigned long>(baud), static_cast<unsigned long>(turnaround),
+                                    coalesceName(mode), static_cast<unsigned>(retries), static_cast<unsigned>(slaves),
+                                    static_cast<unsigned long>(r.samples), static_cast<unsigned long>(r.good),
+                                    r.goodPerS, r.utilisation, r.p50Ms, r.p99Ms, r.roundMs,
+                                    static_cast<unsigned long>(r.fit), static_cast<unsigned long>(r.simLow),
+                                    static_cast<unsigned long>(r.simHigh));
+                        }
+                        fflush(stdout);
+                    }
+                }
+            }
+        }
+    }
+    if (csv != nullptr) {
+        fclose(csv);
+    }
+    return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file compress_bench.cpp
+ * @brief Host benchmark for lib/tscodec on soil sensor streams.
+ * @details Rebuilds a 2 s poll stream from the field readings recorded in
+ *          reference/SoilData.xlsx (linear interpolation between readings,
+ *          plus optional +-1 count sensor noise and timer jitter), encodes it
+ *          into fixed-size blocks and reports the compression ratio against
+ *          raw samples (4-byte timestamp + 7 x int16) and the encode cost.
+ *          Every block is decoded again and compared with the input, as is
+ *          a stream of timestamp and value extremes that exercises the
+ *          widest delta-of-delta class.
+ *
+ *          Build and run from the repository root:
+ *
+ *              g++ -std=c++11 -O2 -Ilib/tscodec tools/compress_bench/compress_bench.cpp \
+ *                  lib/tscodec/tscodec.cpp -o compress_bench && ./compress_bench
+ *
+ *          or `pio run -e compress_bench && .pio/build/compress_bench/program`.
+ *          The exit status is non-zero if any round trip fails.
+ *
+ *          Cycle figures are host TSC cycles; the on-target cost is printed
+ *          by bench_run() when the firmware is built with ENABLE_BENCHMARKS.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "tscodec.h"
+
+namespace {
+
+constexpr uint8_t CHANNELS = 7U;
+constexpr uint32_t POLL_MS = 2000UL;
+constexpr uint16_t RAW_SAMPLE_BYTES = 4U + (2U * CHANNELS);
+
+/**
+ * @brief One spreadsheet row in SensorData units.
+ * @details Column order follows channels.h: moisture (0.1 %), temperature
+ *          (0.1 degC), conductivity (uS/cm), pH (0.01), N, P, K (mg/kg).
+ */
+struct Reading {
+    uint32_t secondOfDay;
+    int16_t values[CHANNELS];
+};
+
+// reference/SoilData.xlsx, zone "Near Shed - West" (same day, 09:10 to 09:30).
+const Reading WEST_ZONE[] = {
+    { 33000U, { 840, 291, 237, 786, 16, 23, 46 } },
+    { 33060U, { 840, 287, 230, 811, 16, 23, 46 } },
+    { 33600U, { 800, 275, 226, 682, 16, 23, 46 } },
+    { 34200U, { 800, 301, 212, 659, 15, 21, 42 } },
+};
+constexpr size_t WEST_ZONE_COUNT = sizeof(WEST_ZONE) / sizeof(WEST_ZONE[0]);
+
+struct Sample {
+    uint32_t timestampMs;
+    int16_t values[CHANNELS];
+};
+
+std::vector<Sample> buildStream(bool noise, bool jitter) {
+    std::vector<Sample> stream;
+    std::srand(1U);
+    const uint32_t begin = WEST_ZONE[0].secondOfDay * 1000UL;
+    const uint32_t end = WEST_ZONE[WEST_ZONE_COUNT - 1U].secondOfDay * 1000UL;
+    size_t seg = 0U;
+    for (uint32_t t = begin; t <= end; t += POLL_MS) {
+        while ((seg + 2U < WEST_ZONE_COUNT) && (t >= WEST_ZONE[seg + 1U].secondOfDay * 1000UL)) {
+            ++seg;
+        }
+        const Reading& a = WEST_ZONE[seg];
+        const Reading& b = WEST_ZONE[seg + 1U];
+        const double f = static_cast<double>(t - (a.secondOfDay * 1000UL)) /
+                         static_cast<double>((b.secondOfDay - a.secondOfDay) * 1000UL);
+        Sample s = {};
+        s.timestampMs = t + (jitter ? static_cast<uint32_t>(std::rand() % 3) : 0U);
+        for (uint8_t ch = 0U; ch < CHANNELS; ++ch) {
+            const double v = a.values[ch] + ((b.values[ch] - a.values[ch]) * f);
+            s.values[ch] = static_cast<int16_t>(v + 0.5 + (noise ? ((std::rand() % 3) - 1) : 0));
+        }
+        stream.push_back(s);
+    }
+    return stream;
+}
+
+/// Worst case for the delta-of-delta: timestamps jumping across the whole
+/// 32-bit range (deltas and their differences past INT32_MAX) and values
+/// swinging between the int16 extremes.
+std::vector<Sample> buildExtremes() {
+    static const uint32_t TIMESTAMPS[] = { 0UL, 0xFFFFFFFFUL, 0x7FFFFFFFUL, 0x80000000UL, 1UL, 0x80000001UL, 0UL };
+    std::vector<Sample> stream;
+    for (size_t i = 0U; i < 64U; ++i) {
+        Sample s = {};
+        s.timestampMs = TIMESTAMPS[i % (sizeof(TIMESTAMPS) / sizeof(TIMESTAMPS[0]))] + static_cast<uint32_t>(i / 7U);
+        for (uint8_t ch = 0U; ch < CHANNELS; ++ch) {
+            s.values[ch] = static_cast<int16_t>((((i + ch) % 2U) == 0U) ? 32767 : -32768);
+        }
+        stream.push_back(s);
+    }
+    return stream;
+}
+
+uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0U;
+#endif
+}
+
+bool run(const char* label, const std::vector<Sample>& stream, uint16_t blockBytes) {
+    std::vector<uint8_t> block(blockBytes);
+    size_t encodedBytes = 0U;
+    size_t blocks = 0U;
+    uint64_t encodeCycles = 0U;
+    std::chrono::nanoseconds encodeTime(0);
+    bool ok = true;
+
+    size_t next = 0U;
+    while (next < stream.size()) {
+        const size_t first = next;
+        const uint64_t c0 = cycles();
+        const auto t0 = std::chrono::steady_clock::now();
+        tscodec::Encoder enc(block.data(), blockBytes, CHANNELS);
+        while ((next < stream.size()) && enc.append(stream[next].timestampMs, stream[next].values)) {
+            ++next;
+        }
+        const uint16_t used = enc.finish();
+        encodeTime += std::chrono::steady_clock::now() - t0;
+        encodeCycles += cycles() - c0;
+        encodedBytes += used;
+        ++blocks;
+        if (next == first) {
+            std::printf("%s: block of %u bytes cannot hold one sample\n", label, blockBytes);
+            return false;
+        }
+
+        tscodec::Decoder dec(block.data(), used, CHANNELS);
+        uint32_t ts = 0U;
+        int16_t values[CHANNELS];
+        size_t i = first;
+        while (dec.next(ts, values)) {
+            ok = ok && (i < next) && (ts == stream[i].timestampMs);
+            for (uint8_t ch = 0U; ok && (ch < CHANNELS); ++ch) {
+                ok = (values[ch] == stream[i].values[ch]);
+            }
+            ++i;
+        }
+        ok = ok && (i == next);
+    }
+
+    const double raw = static_cast<double>(stream.size()) * RAW_SAMPLE_BYTES;
+    std::printf("%-22s block %4u B: %5zu samples, %3zu blocks, %6.2f B/sample, ratio %5.2fx, "
+                "%6.0f cycles (%5.0f ns)/sample, round trip %s\n",
+                label, blockBytes, stream.size(), blocks,
+                static_cast<double>(encodedBytes) / stream.size(), raw / encodedBytes,
+                static_cast<double>(encodeCycles) / stream.size(),
+                static_cast<double>(encodeTime.count()) / stream.size(), ok ? "ok" : "FAILED");
+    return ok;
+}
+
+} // anonymous namespace
+
+int main() {
+    const uint16_t BLOCK_SIZES[] = { 64U, 128U, 256U };
+    bool ok = true;
+    for (uint16_t size : BLOCK_SIZES) {
+        ok = run("interpolated", buildStream(false, false), size) && ok;
+        ok = run("+ noise", buildStream(true, false), size) && ok;
+        ok = run("+ noise + jitter", buildStream(true, true), size) && ok;
+        ok = run("extremes", buildExtremes(), size) && ok;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
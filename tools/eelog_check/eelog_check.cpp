@@ -0,0 +1,254 @@
+/**
+ * @file eelog_check.cpp
+ * @brief Host round-trip check of the EEPROM sample log (src/eelog.cpp).
+ * @details Two parts, both against the unmodified firmware source on
+ *          lib/native_hal's EEPROM model:
+ *
+ *          - Codec: random and extreme record pairs go through encodeDelta()
+ *            and decodeDelta() and must come back unchanged; END_MARKER, a
+ *            truncated record and a record read under the wrong sequence
+ *            number must be rejected.
+ *          - Ring: a long stream whose deltas vary the record length from
+ *            the minimum to the maximum is logged through eelog_offer() and
+ *            eelog_pump(), so the ring wraps many times over pages still
+ *            holding an older pass. After every record eelog_replay() must
+ *            return exactly the newest records logged, in order, with nothing
+ *            decoded from stale bytes; replay between two pumped bytes of a
+ *            record must return the log without it or with it complete.
+ *
+ *          Exits non-zero on the first mismatch. Build and run from the
+ *          repository root:
+ *
+ *              g++ -std=gnu++11 -O2 -DF_CPU=16000000UL -Ilib/native_hal/include -Iinclude \
+ *                  -Ilib/modbus -Ilib/soilsensor tools/eelog_check/eelog_check.cpp \
+ *                  src/eelog.cpp src/deadband.cpp src/channels.cpp \
+ *                  $(find lib/native_hal/src -name '*.cpp') -o eelog_check && ./eelog_check
+ *
+ *          or `pio run -e eelog_check && .pio/build/eelog_check/program`.
+ *          `pio test -e native_test` runs it through eelog_check_run().
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <Arduino.h>
+#include "native_hal.h"
+#include "channels.h"
+#include "deadband.h"
+#include "eelog.h"
+#include "tasks.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint32_t CODEC_CASES = 200000UL;
+constexpr uint32_t RING_RECORDS = 20000UL;
+/// Longer than any staged record takes to reach the EEPROM (3.4 ms a byte).
+constexpr uint32_t PUMP_STEP_US = 4000UL;
+
+using eelog::Record;
+
+uint32_t g_rng = 0x2545F491UL;
+
+uint32_t next() {
+    // xorshift32: fixed sequence, so a failure reproduces.
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+/// Channel step of widely varying size, so record lengths vary.
+int16_t step(int16_t value) {
+    if (value == channels::GAP) {
+        return 0;
+    }
+    static const int32_t SPANS[] = { 0, 1, 63, 64, 8191, 8192, 32767 };
+    const int32_t span = SPANS[next() % (sizeof(SPANS) / sizeof(SPANS[0]))];
+    const int32_t delta = (span == 0) ? 0 : (static_cast<int32_t>(next() % (2UL * span + 1UL)) - span);
+    int32_t v = value + delta;
+    v = (v > 32767) ? 32767 : ((v < -32767) ? -32767 : v);
+    return static_cast<int16_t>(v);
+}
+
+bool same(const Record& a, const Record& b) {
+    return (a.seconds == b.seconds) && (memcmp(a.values, b.values, sizeof(a.values)) == 0);
+}
+
+void print(const char* label, const Record& r) {
+    fprintf(stderr, "  %s s=%lu", label, static_cast<unsigned long>(r.seconds));
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        fprintf(stderr, " v%u=%d", static_cast<unsigned>(ch), static_cast<int>(r.values[ch]));
+    }
+    fprintf(stderr, "\n");
+}
+
+bool checkCodec() {
+    uint8_t buf[eelog::MAX_DELTA_BYTES + 4U];
+    for (uint32_t i = 0UL; i < CODEC_CASES; ++i) {
+        Record prev = {};
+        Record cur = {};
+        const uint16_t seq = static_cast<uint16_t>(next());
+        prev.seconds = next();
+        cur.seconds = ((i % 16UL) == 0UL) ? (prev.seconds - 1UL) : (prev.seconds + (next() % 100000UL));
+        for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+            // Every fourth case pins the channels to the int16 extremes.
+            const bool extreme = (i % 4UL) == 1UL;
+            prev.values[ch] = extreme ? static_cast<int16_t>(((next() & 1UL) != 0UL) ? 32767 : -32768)
+                                      : static_cast<int16_t>(next());
+            cur.values[ch] = extreme ? static_cast<int16_t>(-1 - prev.values[ch]) : step(prev.values[ch]);
+        }
+        const uint8_t len = eelog::encodeDelta(buf, seq, prev, cur);
+        Record back = {};
+        if ((len > eelog::MAX_DELTA_BYTES) || (len < eelog::MIN_DELTA_BYTES) ||
+            (eelog::decodeDelta(buf, len, seq, prev, back) != len) || !same(back, cur)) {
+            fprintf(stderr, "codec case %lu: round trip failed (%u bytes)\n", static_cast<unsigned long>(i), len);
+            print("in ", cur);
+            print("out", back);
+            return false;
+        }
+        // Reading past the record (as replay does) must not change the result.
+        buf[len] = static_cast<uint8_t>(next());
+        if (eelog::decodeDelta(buf, static_cast<uint8_t>(len + 1U), seq, prev, back) != len) {
+            fprintf(stderr, "codec case %lu: trailing byte changed the decode\n", static_cast<unsigned long>(i));
+            return false;
+        }
+        if ((eelog::decodeDelta(buf, static_cast<uint8_t>(len - 1U), seq, prev, back) != 0U) ||
+            (eelog::decodeDelta(buf, len, static_cast<uint16_t>(seq + 1U), prev, back) != 0U)) {
+            fprintf(stderr, "codec case %lu: truncated or foreign record accepted\n", static_cast<unsigned long>(i));
+            return false;
+        }
+        buf[0] = eelog::END_MARKER;
+        if (eelog::decodeDelta(buf, len, seq, prev, back) != 0U) {
+            fprintf(stderr, "codec case %lu: end marker accepted\n", static_cast<unsigned long>(i));
+            return false;
+        }
+    }
+    printf("codec: %lu round trips ok\n", static_cast<unsigned long>(CODEC_CASES));
+    return true;
+}
+
+struct Replay {
+    std::vector<Record> records;
+};
+
+void collect(const Record& record, void* context) {
+    static_cast<Replay*>(context)->records.push_back(record);
+}
+
+std::vector<Record> replayAll() {
+    Replay replay;
+    (void)eelog_replay(&collect, &replay);
+    return replay.records;
+}
+
+/// True if @p got is the newest records of the first @p count in @p logged.
+bool isSuffix(const std::vector<Record>& got, const std::vector<Record>& logged, size_t count) {
+    if ((got.size() > count) || (got.empty() && (count != 0U))) {
+        return false;
+    }
+    const size_t first = count - got.size();
+    for (size_t i = 0U; i < got.size(); ++i) {
+        if (!same(got[i], logged[first + i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void report(uint32_t at, const std::vector<Record>& got, const std::vector<Record>& logged, size_t count) {
+    fprintf(stderr, "record %lu: replay returned %lu records, not the newest of %lu logged\n",
+            static_cast<unsigned long>(at), static_cast<unsigned long>(got.size()),
+            static_cast<unsigned long>(count));
+    const size_t first = (got.size() <= count) ? (count - got.size()) : 0U;
+    for (size_t i = 0U; (i < got.size()) && ((first + i) < count); ++i) {
+        if (!same(got[i], logged[first + i])) {
+            fprintf(stderr, " first difference at entry %lu:\n", static_cast<unsigned long>(i));
+            print("logged  ", logged[first + i]);
+            print("replayed", got[i]);
+            break;
+        }
+    }
+}
+
+bool checkRing() {
+    hal::reset();
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        (void)deadband_configure(ch, { deadband::Mode::ABSOLUTE, 0U });
+    }
+    eelog_init();
+
+    std::vector<Record> logged;
+    Sample sample = {};
+    sample.ok = true;
+    Record cur = {};
+    size_t shortest = 0xFFFFU;
+    size_t longest = 0U;
+    for (uint32_t i = 0UL; i < RING_RECORDS; ++i) {
+        // Past the gate's minimum interval, now and then after a long outage.
+        const uint32_t gapS = ((next() % 256UL) == 0UL) ? (next() % 20000UL) : (next() % 4UL);
+        sample.timestampMs += storage::LOG_PERIOD_MS + (gapS * 1000UL);
+        // Every 32nd record swings from missing to full scale, the widest delta.
+        const bool swing = (i % 32UL) == 31UL;
+        for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+            const int16_t value = channels::value(sample.data, ch);
+            channels::setValue(sample.data, ch,
+                               swing ? static_cast<int16_t>((value == channels::GAP) ? 32767 : channels::GAP)
+                                     : step(value));
+        }
+        // At least one channel moves, so every sample is due.
+        channels::setValue(sample.data, 0U, static_cast<int16_t>((cur.values[0] == 100) ? 101 : 100));
+        if (!eelog_offer(sample)) {
+            fprintf(stderr, "record %lu: not accepted\n", static_cast<unsigned long>(i));
+            return false;
+        }
+        const Record prev = cur;
+        cur.seconds = sample.timestampMs / 1000UL;
+        for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+            cur.values[ch] = channels::value(sample.data, ch);
+        }
+        uint8_t scratch[eelog::MAX_DELTA_BYTES];
+        const size_t len = eelog::encodeDelta(scratch, 0U, prev, cur);
+        shortest = (len < shortest) ? len : shortest;
+        longest = (len > longest) ? len : longest;
+
+        // Replay between two pumped bytes sees the log with or without the
+        // new record, never a part of it or stale data behind it.
+        logged.push_back(cur);
+        const size_t before = logged.size() - 1U;
+        bool pumped = true;
+        while (pumped) {
+            const std::vector<Record> got = replayAll();
+            if (!isSuffix(got, logged, before) && !isSuffix(got, logged, logged.size())) {
+                report(i, got, logged, logged.size());
+                return false;
+            }
+            hal::advanceMicros(PUMP_STEP_US);
+            pumped = eelog_pump();
+        }
+        const std::vector<Record> got = replayAll();
+        if (!isSuffix(got, logged, logged.size())) {
+            report(i, got, logged, logged.size());
+            return false;
+        }
+    }
+    const size_t kept = replayAll().size();
+    printf("ring: %lu records logged (%lu..%lu bytes), %lu kept, every replay exact\n",
+           static_cast<unsigned long>(RING_RECORDS), static_cast<unsigned long>(shortest),
+           static_cast<unsigned long>(longest), static_cast<unsigned long>(kept));
+    return true;
+}
+
+} // anonymous namespace
+
+bool eelog_check_run() {
+    const bool ok = checkCodec() && checkRing();
+    printf("%s\n", ok ? "eelog check passed" : "eelog check FAILED");
+    return ok;
+}
+
+#ifndef PIO_UNIT_TESTING
+int main() {
+    return eelog_check_run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
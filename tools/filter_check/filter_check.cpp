@@ -0,0 +1,262 @@
+/**
+ * @file filter_check.cpp
+ * @brief Host check of filter::Chain against a floating-point reference.
+ * @details Rebuilds a 2 s poll stream from reference/SoilData.xlsx: the
+ *          "Near Shed - West" readings interpolated as in tools/compress_bench,
+ *          with +-1 count noise, single and double spikes and missing readings,
+ *          followed by the "Just before Shed - North" dry-to-wet step. Every
+ *          channel of the stream goes through filter::Chain (src/filter.cpp)
+ *          under the firmware's default configuration and a sweep
+ *          of median taps and EMA/Kalman settings, and each output is compared
+ *          with a reference:
+ *
+ *          - median: std::sort of the last taps readings, which must match
+ *            exactly (as must the output with no smoothing and every GAP);
+ *          - EMA and Kalman: the same recursions in double. The output may
+ *            differ by 0.5 for rounding plus an error budget carried through
+ *            the same recursion: each step adds one Q4 LSB of truncation and,
+ *            for Kalman, one gain LSB times the innovation, and the budget
+ *            decays by (1 - gain) like the estimate's own error. For the EMA
+ *            this is at most 2^emaShift / 16.
+ *
+ *          Exits non-zero on the first mismatch. Build and run from the
+ *          repository root:
+ *
+ *              g++ -std=gnu++11 -O2 -DF_CPU=16000000UL -Ilib/native_hal/include -Iinclude \
+ *                  -Ilib/modbus -Ilib/soilsensor tools/filter_check/filter_check.cpp \
+ *                  src/filter.cpp src/channels.cpp $(find lib/native_hal/src -name '*.cpp') \
+ *                  -o filter_check && ./filter_check
+ *
+ *          or `pio run -e filter_check && .pio/build/filter_check/program`.
+ *          `pio test -e native_test` runs it through filter_check_run().
+ */
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "channels.h"
+#include "filter.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+using filter::Config;
+using filter::Smoothing;
+
+constexpr uint32_t POLL_MS = 2000UL;
+/// Samples the dry reading is held before the step to the wet one.
+constexpr size_t STEP_HOLD = 60U;
+/// Firmware fixed point: Q4 estimate, 8-bit Kalman gain.
+constexpr double ESTIMATE_LSB = 1.0 / 16.0;
+constexpr double GAIN_LSB = 1.0 / 256.0;
+
+/**
+ * @brief One spreadsheet row in SensorData units.
+ * @details Column order follows channels.h: moisture (0.1 %), temperature
+ *          (0.1 degC), conductivity (uS/cm), pH (0.01), N, P, K (mg/kg).
+ */
+struct Reading {
+    uint32_t secondOfDay;
+    int16_t values[channels::COUNT];
+};
+
+// reference/SoilData.xlsx, zone "Near Shed - West" (same day, 09:10 to 09:30).
+const Reading WEST_ZONE[] = {
+    { 33000U, { 840, 291, 237, 786, 16, 23, 46 } },
+    { 33060U, { 840, 287, 230, 811, 16, 23, 46 } },
+    { 33600U, { 800, 275, 226, 682, 16, 23, 46 } },
+    { 34200U, { 800, 301, 212, 659, 15, 21, 42 } },
+};
+constexpr size_t WEST_ZONE_COUNT = sizeof(WEST_ZONE) / sizeof(WEST_ZONE[0]);
+
+// reference/SoilData.xlsx, zone "Just before Shed - North": dry, then wet soil.
+const Reading NORTH_ZONE[] = {
+    { 46380U, { 91, 427, 0, 727, 0, 0, 0 } },
+    { 46800U, { 186, 441, 1272, 657, 78, 109, 219 } },
+};
+
+// Firmware defaults (src/filter.cpp), then a sweep of the other settings.
+const Config DEFAULTS[channels::COUNT] = {
+    { 3U, Smoothing::EMA,    2U, 0U, 0U },
+    { 3U, Smoothing::EMA,    2U, 0U, 0U },
+    { 5U, Smoothing::KALMAN, 0U, 4U, 400U },
+    { 3U, Smoothing::EMA,    2U, 0U, 0U },
+    { 5U, Smoothing::KALMAN, 0U, 1U, 25U },
+    { 5U, Smoothing::KALMAN, 0U, 1U, 25U },
+    { 5U, Smoothing::KALMAN, 0U, 1U, 25U }
+};
+
+struct KalmanSetting {
+    uint16_t q;
+    uint16_t r;
+};
+
+// Q = 0 is left out: its gain falls as 1/n, below the 8-bit gain within a few hundred samples.
+const KalmanSetting KALMAN_SWEEP[] = { { 1U, 1U }, { 1U, 25U }, { 4U, 400U }, { 100U, 1U }, { 1000U, 1000U } };
+
+std::vector<int16_t> buildChannel(uint8_t ch) {
+    std::vector<int16_t> stream;
+    std::srand(1U + ch);
+    const uint32_t begin = WEST_ZONE[0].secondOfDay * 1000UL;
+    const uint32_t end = WEST_ZONE[WEST_ZONE_COUNT - 1U].secondOfDay * 1000UL;
+    size_t seg = 0U;
+    for (uint32_t t = begin; t <= end; t += POLL_MS) {
+        while ((seg + 2U < WEST_ZONE_COUNT) && (t >= WEST_ZONE[seg + 1U].secondOfDay * 1000UL)) {
+            ++seg;
+        }
+        const Reading& a = WEST_ZONE[seg];
+        const Reading& b = WEST_ZONE[seg + 1U];
+        const double f = static_cast<double>(t - (a.secondOfDay * 1000UL)) /
+                         static_cast<double>((b.secondOfDay - a.secondOfDay) * 1000UL);
+        const double v = a.values[ch] + ((b.values[ch] - a.values[ch]) * f);
+        stream.push_back(static_cast<int16_t>(v + 0.5 + ((std::rand() % 3) - 1)));
+    }
+    // Faults: spikes of either sign (some in pairs) and missing readings.
+    for (size_t i = 5U; i < stream.size(); i += 17U + static_cast<size_t>(std::rand() % 20)) {
+        const int16_t spike = static_cast<int16_t>(((std::rand() % 2) == 0) ? 3000 : -3000);
+        stream[i] = static_cast<int16_t>(stream[i] + spike);
+        if ((std::rand() % 3) == 0) {
+            stream[i + 1U] = static_cast<int16_t>(stream[i + 1U] + spike);
+        }
+    }
+    for (size_t i = 11U; i < stream.size(); i += 29U + static_cast<size_t>(std::rand() % 30)) {
+        stream[i] = channels::GAP;
+    }
+    // Step response: the dry reading held, then the wet one.
+    for (size_t i = 0U; i < (2U * STEP_HOLD); ++i) {
+        stream.push_back(NORTH_ZONE[(i < STEP_HOLD) ? 0U : 1U].values[ch]);
+    }
+    return stream;
+}
+
+/// Brute-force reference of the whole chain for one channel.
+class Reference {
+public:
+    explicit Reference(const Config& config)
+        : cfg(config), history(), estimate(0.0), variance(0.0), budget(0.0), primed(false) {}
+
+    /// Returns the expected output; @p median receives the stage-1 value.
+    double update(int16_t raw, int16_t& median) {
+        history.push_back(raw);
+        const size_t n = std::min<size_t>(cfg.medianTaps, history.size());
+        std::vector<int16_t> last(history.end() - static_cast<std::ptrdiff_t>(n), history.end());
+        std::sort(last.begin(), last.end());
+        median = last[n / 2U];
+        const double x = median;
+        if (!primed) {
+            primed = true;
+            estimate = x;
+            variance = cfg.kalmanR;
+            return x;
+        }
+        if (cfg.smoothing == Smoothing::EMA) {
+            const double k = 1.0 / static_cast<double>(1U << cfg.emaShift);
+            budget = ((1.0 - k) * budget) + ESTIMATE_LSB;
+            estimate += (x - estimate) * k;
+        } else if (cfg.smoothing == Smoothing::KALMAN) {
+            const double p = variance + cfg.kalmanQ;
+            const double k = p / (p + cfg.kalmanR);
+            budget = ((1.0 - k) * budget) + (fabs(x - estimate) * GAIN_LSB) + ESTIMATE_LSB;
+            estimate += (x - estimate) * k;
+            variance = p * (1.0 - k);
+        } else {
+            estimate = x;
+        }
+        return estimate;
+    }
+
+    /// Largest deviation the firmware's fixed point explains.
+    double tolerance() const {
+        return (cfg.smoothing == Smoothing::NONE) ? 0.0 : (0.5 + budget);
+    }
+
+private:
+    const Config& cfg;
+    std::vector<int16_t> history;  ///< Every reading but the gaps.
+    double estimate;
+    double variance;
+    double budget;                 ///< Fixed-point error the estimate may carry.
+    bool primed;
+};
+
+const char* name(Smoothing smoothing) {
+    return (smoothing == Smoothing::EMA) ? "ema" : ((smoothing == Smoothing::KALMAN) ? "kalman" : "none");
+}
+
+/// Runs one channel's stream through a Chain and the reference.
+bool check(uint8_t ch, const std::vector<int16_t>& stream, const Config& cfg, double& worst) {
+    filter::Chain chain;
+    Reference reference(cfg);
+    for (size_t i = 0U; i < stream.size(); ++i) {
+        const int16_t got = chain.update(stream[i], cfg);
+        if (stream[i] == channels::GAP) {
+            if (got != channels::GAP) {
+                fprintf(stderr, "ch %u sample %lu: gap became %d\n", static_cast<unsigned>(ch),
+                        static_cast<unsigned long>(i), static_cast<int>(got));
+                return false;
+            }
+            continue;
+        }
+        int16_t median = 0;
+        const double want = reference.update(stream[i], median);
+        // The first output is the median itself, before any smoothing.
+        const double error = fabs(static_cast<double>(got) - want);
+        const double limit = (i == 0U) ? 0.0 : reference.tolerance();
+        worst = std::max(worst, error);
+        if ((error > (limit + 1e-9)) || ((cfg.smoothing == Smoothing::NONE) && (got != median))) {
+            fprintf(stderr, "ch %u taps %u %s shift %u q %u r %u, sample %lu (raw %d, median %d): "
+                    "chain %d, reference %.2f, tolerance %.2f\n",
+                    static_cast<unsigned>(ch), static_cast<unsigned>(cfg.medianTaps), name(cfg.smoothing),
+                    static_cast<unsigned>(cfg.emaShift), static_cast<unsigned>(cfg.kalmanQ),
+                    static_cast<unsigned>(cfg.kalmanR), static_cast<unsigned long>(i),
+                    static_cast<int>(stream[i]), static_cast<int>(median), static_cast<int>(got), want, limit);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+bool filter_check_run() {
+    static const uint8_t TAPS[] = { 1U, 3U, 5U };
+    std::vector<Config> sweep;
+    for (uint8_t taps : TAPS) {
+        sweep.push_back({ taps, Smoothing::NONE, 0U, 0U, 0U });
+        for (uint8_t shift = 1U; shift <= 7U; ++shift) {
+            sweep.push_back({ taps, Smoothing::EMA, shift, 0U, 0U });
+        }
+        for (const KalmanSetting& k : KALMAN_SWEEP) {
+            sweep.push_back({ taps, Smoothing::KALMAN, 0U, k.q, k.r });
+        }
+    }
+
+    bool ok = true;
+    size_t samples = 0U;
+    double worstEma = 0.0;
+    double worstKalman = 0.0;
+    for (uint8_t ch = 0U; ok && (ch < channels::COUNT); ++ch) {
+        const std::vector<int16_t> stream = buildChannel(ch);
+        std::vector<Config> configs(1U, DEFAULTS[ch]);
+        configs.insert(configs.end(), sweep.begin(), sweep.end());
+        for (size_t c = 0U; ok && (c < configs.size()); ++c) {
+            double worst = 0.0;
+            ok = check(ch, stream, configs[c], worst);
+            samples += stream.size();
+            double& slot = (configs[c].smoothing == Smoothing::KALMAN) ? worstKalman : worstEma;
+            slot = std::max(slot, (configs[c].smoothing == Smoothing::NONE) ? 0.0 : worst);
+        }
+    }
+    printf("%lu samples, %lu configurations per channel; worst deviation ema %.2f, kalman %.2f counts\n",
+           static_cast<unsigned long>(samples), static_cast<unsigned long>(sweep.size() + 1U), worstEma,
+           worstKalman);
+    printf("%s\n", ok ? "filter check passed" : "filter check FAILED");
+    return ok;
+}
+
+#ifndef PIO_UNIT_TESTING
+int main() {
+    return filter_check_run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+#endif
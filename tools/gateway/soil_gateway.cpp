@@ -0,0 +1,438 @@
+/**
+ * @file soil_gateway.cpp
+ * @brief Polls soil probes on one or more RS485 ports from a Linux host.
+ * @details The firmware's ModbusMaster and SoilSensor run unmodified on
+ *          lib/native_hal in wall-clock mode, one instance per port, over
+ *          PosixSerial (lib/posix_serial). Each port polls its slaves in
+ *          turn, one readAll() sequence per slave and period; ports run
+ *          concurrently from a single epoll loop that sleeps until a port has
+ *          input, a response timeout may have passed or the next round is due.
+ *
+ *          Samples are written as CSV lines (the header line starts with #):
+ *          to stdout, appended to a file, or to every client connected to a
+ *          Unix stream socket (--out unix:/path). Fields are register units
+ *          as in SoilSensor::SensorData; a failed block leaves its fields at
+ *          the INVALID values and ok=0.
+ *
+ *          --trace FILE records the port's traffic as a timed byte trace
+ *          (lib/busreplay) that tools/replay plays back into the firmware.
+ *
+ *          Build from the repository root:
+ *
+ *              g++ -std=gnu++11 -O2 -DF_CPU=16000000UL -Ilib/native_hal/include -Iinclude \
+ *                  -Ilib/modbus -Ilib/soilsensor -Ilib/posix_serial -Ilib/busreplay tools/gateway/soil_gateway.cpp \
+ *                  lib/posix_serial/posix_serial.cpp lib/busreplay/busreplay.cpp lib/busreplay/busreplay_recorder.cpp \
+ *                  lib/modbus/ModbusMaster.cpp lib/soilsensor/SoilSensor.cpp \
+ *                  $(find lib/native_hal/src -name '*.cpp') -o soil_gateway
+ *
+ *          Usage (--slaves and --trace apply to the --port before it):
+ *
+ *              ./soil_gateway --port /dev/ttyUSB0:9600 --slaves 1,2,3 \
+ *                             --port /dev/ttyUSB1 --slaves 1 --period 5000 --out samples.csv
+ *
+ *          End to end against the simulator (tools/soilsim):
+ *
+ *              ./soilsim_pty --link /tmp/soil0 --slave 1 --slave 2:drop=200 &
+ *              ./soil_gateway --port /tmp/soil0 --slaves 1,2 --period 1000 --count 10
+ */
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Arduino.h>
+#include "native_hal.h"
+#include "ModbusMaster.h"
+#include "SoilSensor.h"
+#include "posix_serial.h"
+#include "busreplay_recorder.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+constexpr uint32_t DEFAULT_BAUD = 9600UL;
+constexpr uint32_t DEFAULT_PERIOD_MS = 5000UL;
+/// Wake-up interval while a reply is outstanding, for ModbusMaster's timeout.
+constexpr int PENDING_TICK_MS = 5;
+constexpr int MAX_EVENTS = 16;
+constexpr int MAX_CLIENTS = 8;
+
+const char HEADER[] = "# time_ms,port,address,ok,moisture,temperature,conductivity,ph,nitrogen,phosphorus,potassium\n";
+
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int) {
+    g_stop = 1;
+}
+
+/**
+ * @brief One serial port, its Modbus master and the slaves polled through it.
+ */
+struct Port {
+    Port() : serial(), node(), sensor(node, 0U, 0U), path(), tracePath(), trace(nullptr), recorder(), link(nullptr), slaves(),
+             data(), nextRoundMs(0UL), current(0U), block(0U), busy(false), ok(false) {}
+
+    ~Port() {
+        recorder.reset();  // Writes out pending input before the file closes
+        if (trace != nullptr) {
+            (void)fclose(trace);
+        }
+    }
+
+    PosixSerial serial;
+    ModbusMaster node;
+    SoilSensor sensor;
+    std::string path;
+    std::string tracePath;  ///< --trace file, or empty.
+    FILE* trace;
+    std::unique_ptr<busreplay::Recorder> recorder;
+    Stream* link;           ///< serial, or the recorder in front of it.
+    std::vector<uint8_t> slaves;
+    SoilSensor::SensorData data;
+    uint32_t nextRoundMs;   ///< millis() at which the next round starts.
+    size_t current;         ///< Index into slaves being polled.
+    uint8_t block;          ///< readAll() block in flight.
+    bool busy;              ///< A round is in progress.
+    bool ok;                ///< Every block so far succeeded.
+};
+
+/**
+ * @brief Where sample lines go: a stdio stream, or clients of a Unix socket.
+ */
+class Sink {
+public:
+    Sink() noexcept : file(nullptr), listener(-1), clients(), socketPath() {}
+
+    // JSF AV C++ Rule 30, 32: Prohibit copy construction and assignment.
+    Sink(const Sink&) = delete;
+    Sink& operator=(const Sink&) = delete;
+    ~Sink() {
+        for (int client : clients) {
+            (void)::close(client);
+        }
+        if (listener >= 0) {
+            (void)::close(listener);
+            (void)unlink(socketPath.c_str());
+        }
+        if ((file != nullptr) && (file != stdout)) {
+            (void)fclose(file);
+        }
+    }
+
+    bool open(const char* spec, int epoll) {
+        if (strncmp(spec, "unix:", 5U) == 0) {
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            if (strlen(spec + 5) >= sizeof(address.sun_path)) {
+                errno = ENAMETOOLONG;
+                return false;
+            }
+            socketPath = spec + 5;
+            strcpy(address.sun_path, socketPath.c_str());
+            (void)unlink(address.sun_path);
+            listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            if ((listener < 0) || (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) ||
+                (listen(listener, MAX_CLIENTS) != 0)) {
+                return false;
+            }
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.fd = listener;
+            return epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event) == 0;
+        }
+        file = (strcmp(spec, "-") == 0) ? stdout : fopen(spec, "a");
+        if (file != nullptr) {
+            line(HEADER);
+        }
+        return file != nullptr;
+    }
+
+    int listenFd() const noexcept { return listener; }
+
+    void accept() {
+        const int client = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+        if (client < 0) {
+            return;
+        }
+        if (clients.size() >= static_cast<size_t>(MAX_CLIENTS)) {
+            (void)::close(client);
+            return;
+        }
+        clients.push_back(client);
+        const size_t length = sizeof(HEADER) - 1U;
+        if (send(client, HEADER, length, MSG_NOSIGNAL) != static_cast<ssize_t>(length)) {
+            (void)::close(client);
+            clients.pop_back();
+        }
+    }
+
+    void line(const char* text) {
+        if (file != nullptr) {
+            (void)fputs(text, file);
+            (void)fflush(file);
+            return;
+        }
+        // A client that cannot keep up (or has gone) is dropped.
+        const size_t length = strlen(text);
+        for (size_t i = 0U; i < clients.size();) {
+            if (send(clients[i], text, length, MSG_NOSIGNAL) != static_cast<ssize_t>(length)) {
+                (void)::close(clients[i]);
+                clients.erase(clients.begin() + static_cast<long>(i));
+            } else {
+                ++i;
+            }
+        }
+    }
+
+private:
+    FILE* file;
+    int listener;
+    std::vector<int> clients;
+    std::string socketPath;
+};
+
+uint64_t realtimeMs() {
+    timespec ts;
+    (void)clock_gettime(CLOCK_REALTIME, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000ULL) + (static_cast<uint64_t>(ts.tv_nsec) / 1000000ULL);
+}
+
+void clearData(SoilSensor::SensorData& data) {
+    data.moisture = SoilSensor::INVALID;
+    data.temperature = SoilSensor::INVALID_TEMPERATURE;
+    data.conductivity = SoilSensor::INVALID;
+    data.ph = SoilSensor::INVALID;
+    data.nitrogen = SoilSensor::INVALID;
+    data.phosphorus = SoilSensor::INVALID;
+    data.potassium = SoilSensor::INVALID;
+}
+
+void emit(Sink& sink, const Port& port) {
+    const SoilSensor::SensorData& d = port.data;
+    char text[160];
+    (void)snprintf(text, sizeof(text), "%llu,%s,%u,%u,%u,%d,%u,%u,%u,%u,%u\n",
+                   static_cast<unsigned long long>(realtimeMs()), port.path.c_str(),
+                   static_cast<unsigned>(port.slaves[port.current]), port.ok ? 1U : 0U,
+                   static_cast<unsigned>(d.moisture), static_cast<int>(d.temperature),
+                   static_cast<unsigned>(d.conductivity), static_cast<unsigned>(d.ph),
+                   static_cast<unsigned>(d.nitrogen), static_cast<unsigned>(d.phosphorus),
+                   static_cast<unsigned>(d.potassium));
+    sink.line(text);
+}
+
+void startSlave(Port& port) {
+    clearData(port.data);
+    port.ok = true;
+    port.block = 0U;
+    port.sensor.setSlaveAddress(port.slaves[port.current]);
+    (void)port.sensor.startReadBlock(0U);
+}
+
+/**
+ * @brief Advances @p port's poll sequence as far as it can without waiting.
+ * @return Samples completed.
+ */
+uint32_t step(Port& port, Sink& sink) {
+    uint32_t samples = 0U;
+    if (!port.busy) {
+        // Nothing is expected: a late reply, noise or another master. The fd
+        // is level-triggered, so unread input would wake epoll_wait at once,
+        // over and over; read it away (through the recorder, if tracing).
+        while (port.link->read() >= 0) {
+        }
+        if (static_cast<int32_t>(millis() - port.nextRoundMs) < 0) {
+            return 0U;
+        }
+        port.busy = true;
+        port.current = 0U;
+        startSlave(port);
+    }
+    while (port.busy) {
+        const uint8_t result = port.sensor.pollReadBlock(port.data);
+        if (result == ModbusMaster::ku8MBPending) {
+            break;
+        }
+        // Like readAll(): the first failed block ends the slave's sequence.
+        port.ok = port.ok && (result == ModbusMaster::ku8MBSuccess);
+        ++port.block;
+        if (port.ok && (port.block < SoilSensor::READ_BLOCK_COUNT)) {
+            (void)port.sensor.startReadBlock(port.block);
+            continue;
+        }
+        emit(sink, port);
+        ++samples;
+        ++port.current;
+        if (port.current < port.slaves.size()) {
+            startSlave(port);
+        } else {
+            port.busy = false;
+        }
+    }
+    return samples;
+}
+
+bool parseSlaves(const char* list, std::vector<uint8_t>& slaves) {
+    const char* p = list;
+    while (*p != '\0') {
+        char* end = nullptr;
+        const unsigned long address = strtoul(p, &end, 0);
+        if ((end == p) || (address == 0UL) || (address > 247UL) || ((*end != ',') && (*end != '\0'))) {
+            return false;
+        }
+        slaves.push_back(static_cast<uint8_t>(address));
+        p = (*end == ',') ? (end + 1) : end;
+    }
+    return !slaves.empty();
+}
+
+void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s --port DEVICE[:baud] --slaves a,b,... [--port ... --slaves ...]\n"
+                    "       [--trace FILE] [--period ms] [--out - | FILE | unix:PATH] [--count samples]\n", argv0);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::unique_ptr<Port>> ports;
+    uint32_t periodMs = DEFAULT_PERIOD_MS;
+    const char* out = "-";
+    unsigned long limit = 0UL;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = (i + 1) < argc;
+        if ((strcmp(argv[i], "--port") == 0) && hasValue) {
+            ports.emplace_back(new Port());
+            ports.back()->path = argv[++i];
+        } else if ((strcmp(argv[i], "--slaves") == 0) && hasValue && !ports.empty()) {
+            if (!parseSlaves(argv[++i], ports.back()->slaves)) {
+                usage(argv[0]);
+                return 2;
+            }
+        } else if ((strcmp(argv[i], "--trace") == 0) && hasValue && !ports.empty()) {
+            ports.back()->tracePath = argv[++i];
+        } else if ((strcmp(argv[i], "--period") == 0) && hasValue) {
+            periodMs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if ((strcmp(argv[i], "--out") == 0) && hasValue) {
+            out = argv[++i];
+        } else if ((strcmp(argv[i], "--count") == 0) && hasValue) {
+            limit = strtoul(argv[++i], nullptr, 0);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (ports.empty()) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    hal::reset();
+    hal::setWallClock(true);
+    sei();
+
+    const int epoll = epoll_create1(0);
+    Sink sink;
+    if ((epoll < 0) || !sink.open(out, epoll)) {
+        perror(out);
+        return 1;
+    }
+
+    for (std::unique_ptr<Port>& port : ports) {
+        if (port->slaves.empty()) {
+            port->slaves.push_back(1U);
+        }
+        uint32_t baud = DEFAULT_BAUD;
+        const size_t colon = port->path.rfind(':');
+        if (colon != std::string::npos) {
+            baud = static_cast<uint32_t>(strtoul(port->path.c_str() + colon + 1U, nullptr, 0));
+            port->path.erase(colon);
+        }
+        if (!port->serial.open(port->path.c_str(), baud)) {
+            fprintf(stderr, "%s: %s\n", port->path.c_str(), strerror(errno));
+            return 1;
+        }
+        if (!port->tracePath.empty()) {
+            port->trace = fopen(port->tracePath.c_str(), "w");
+            if (port->trace == nullptr) {
+                perror(port->tracePath.c_str());
+                return 1;
+            }
+            fprintf(port->trace, "# %s\n", port->path.c_str());
+            port->recorder.reset(new busreplay::Recorder(port->serial, baud, port->trace));
+        }
+        port->link = port->recorder ? static_cast<Stream*>(port->recorder.get()) : static_cast<Stream*>(&port->serial);
+        port->sensor.begin(*port->link, static_cast<long>(baud));
+        // SoilSensor's transmission hooks belong to one global instance and
+        // pause 10 ms for a hand-switched transceiver; PosixSerial switches
+        // direction itself, so the hooks are dropped.
+        port->node.preTransmission(nullptr);
+        port->node.postTransmission(nullptr);
+        port->nextRoundMs = millis();
+
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = port->serial.fd();
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, port->serial.fd(), &event) != 0) {
+            perror("epoll_ctl");
+            return 1;
+        }
+        fprintf(stderr, "%s: %lu baud, %u slave(s), direction %s\n", port->path.c_str(),
+                static_cast<unsigned long>(baud), static_cast<unsigned>(port->slaves.size()),
+                port->serial.kernelRs485() ? "by kernel RS485" : "by RTS");
+    }
+
+    (void)signal(SIGINT, onSignal);
+    (void)signal(SIGTERM, onSignal);
+
+    unsigned long samples = 0UL;
+    while ((g_stop == 0) && ((limit == 0UL) || (samples < limit))) {
+        int timeout = -1;
+        const uint32_t now = millis();
+        for (const std::unique_ptr<Port>& port : ports) {
+            const int wait = port->busy ? PENDING_TICK_MS
+                                        : ((static_cast<int32_t>(port->nextRoundMs - now) > 0)
+                                               ? static_cast<int>(port->nextRoundMs - now) : 0);
+            timeout = ((timeout < 0) || (wait < timeout)) ? wait : timeout;
+        }
+
+        epoll_event events[MAX_EVENTS];
+        const int ready = epoll_wait(epoll, events, MAX_EVENTS, timeout);
+        if ((ready < 0) && (errno != EINTR)) {
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < ready; ++i) {
+            if (events[i].data.fd == sink.listenFd()) {
+                sink.accept();
+            }
+        }
+        // Input is read by the ports' own available(); epoll only wakes us.
+        for (std::unique_ptr<Port>& port : ports) {
+            const bool wasBusy = port->busy;
+            samples += step(*port, sink);
+            if (wasBusy && !port->busy) {
+                port->nextRoundMs += periodMs;
+                if (static_cast<int32_t>(millis() - port->nextRoundMs) > 0) {
+                    port->nextRoundMs = millis();  // Overrun: start the next round now
+                }
+            }
+        }
+    }
+
+    for (const std::unique_ptr<Port>& port : ports) {
+        const ModbusMaster::Stats& s = port->sensor.stats();
+        fprintf(stderr, "%s: requests %u, responses %u, exceptions %u, timeouts %u, crc errors %u, bad frames %u\n",
+                port->path.c_str(), static_cast<unsigned>(s.requests), static_cast<unsigned>(s.responses),
+                static_cast<unsigned>(s.exceptions), static_cast<unsigned>(s.timeouts),
+                static_cast<unsigned>(s.crcErrors), static_cast<unsigned>(s.badFrames));
+    }
+    (void)close(epoll);
+    return 0;
+}
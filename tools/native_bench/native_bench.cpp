@@ -0,0 +1,220 @@
+/**
+ * @file native_bench.cpp
+ * @brief Host micro-benchmarks of the firmware's hot paths on lib/native_hal.
+ * @details The library and firmware sources are compiled unmodified for the
+ *          host; only Arduino.h and avr-libc are replaced by native_hal. Each
+ *          figure is host nanoseconds per operation (the best of several
+ *          runs), which tracks relative cost between revisions; on-target
+ *          cycle counts come from tools/avr_bench under simavr. The
+ *          last two lines are virtual time from the HAL clock and are exact.
+ *
+ *          Build and run with PlatformIO:
+ *
+ *              pio run -e native && .pio/build/native/program
+ *
+ *          or directly from the repository root:
+ *
+ *              g++ -std=gnu++11 -O2 -DF_CPU=16000000UL -Ilib/native_hal/include -Iinclude \
+ *                  -Ilib/cobs -Ilib/fmt -Ilib/lcd -Ilib/modbus -Ilib/soilsensor -Ilib/soilsim -Ilib/tscodec \
+ *                  tools/native_bench/native_bench.cpp \
+ *                  $(find src lib -name '*.cpp' ! -name main.cpp) -o native_bench && ./native_bench
+ */
+#include <chrono>
+#include <cstdio>
+#include <Arduino.h>
+#include "native_hal.h"
+#include "ModbusMaster.h"
+#include "SoilSensor.h"
+#include "cobs.h"
+#include "config.h"
+#include "scheduler.h"
+#include "soilsim_hal.h"
+#include "tasks.h"
+#include "timebase.h"
+#if ENABLE_TELEMETRY
+#include "telemetry.h"
+#endif
+
+namespace {
+
+constexpr int RUNS = 5;
+constexpr uint8_t RE_PIN = 7U;
+constexpr uint8_t DE_PIN = 6U;
+
+/**
+ * @brief Best-of-RUNS host time of @p body, in nanoseconds per operation.
+ * @param ops Operations performed by one call of @p body.
+ */
+template <typename Body>
+double nsPerOp(uint32_t ops, Body body) {
+    double best = 0.0;
+    for (int run = 0; run < RUNS; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        const double ns = elapsed.count() / ops;
+        if ((run == 0) || (ns < best)) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+void report(const char* label, double value, const char* unit) {
+    std::printf("bench %s: %.1f %s\n", label, value, unit);
+}
+
+/// Keeps results observable so the optimiser cannot drop the work.
+volatile uint32_t g_sink;
+
+void benchCrc() {
+    constexpr uint32_t BYTES = 1U << 20;
+    static uint8_t data[256];
+    for (uint16_t i = 0U; i < sizeof(data); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37U);
+    }
+
+    report("modbus crc16_update", nsPerOp(BYTES, [&]() {
+        uint16_t crc = 0xFFFFU;
+        for (uint32_t i = 0U; i < BYTES; ++i) {
+            crc = crc16_update(crc, data[i & 0xFFU]);
+        }
+        g_sink = crc;
+    }), "ns/byte");
+
+    report("cobs crc16", nsPerOp(BYTES, [&]() {
+        uint16_t crc = 0xFFFFU;
+        for (uint32_t i = 0U; i < BYTES; i += sizeof(data)) {
+            crc = cobs::crc16(crc, data, sizeof(data));
+        }
+        g_sink = crc;
+    }), "ns/byte");
+
+    report("cobs encode", nsPerOp(BYTES, [&]() {
+        uint32_t sum = 0U;
+        for (uint32_t i = 0U; i < BYTES; i += sizeof(data)) {
+            (void)cobs::encode(data, sizeof(data), [](uint8_t b, void* ctx) {
+                *static_cast<uint32_t*>(ctx) += b;
+            }, &sum);
+        }
+        g_sink = sum;
+    }), "ns/byte");
+}
+
+void benchModbus() {
+    constexpr uint32_t OPS = 100000U;
+    hal::FakeStream port(SERIAL_TX_BUFFER_SIZE);  // No begin(): the wire takes no time
+    ModbusMaster node;
+    node.begin(1U, port);
+
+    report("modbus request framing", nsPerOp(OPS, [&]() {
+        for (uint32_t i = 0U; i < OPS; ++i) {
+            (void)node.startReadHoldingRegisters(static_cast<uint16_t>(i & 0x3FU), 3U);
+            port.clearTransmitted();
+        }
+    }), "ns/request");
+
+    // Every reply is already in the RX buffer when polled, so this is the
+    // receive, CRC check and decode work of four transactions.
+    // The port is never begun, so the probe listens at baud 0 as well.
+    soilsim::Slave probe(1U, 0UL);
+    soilsim::Bus bus(0UL);
+    bus.attach(probe);
+    soilsim::BusPeer peer(bus);
+    port.setPeer(&peer);
+    SoilSensor sensor(node, RE_PIN, DE_PIN);
+    sensor.begin(port, 0L);
+    SoilSensor::SensorData data;
+    report("soil readAll decode", nsPerOp(OPS / 10U, [&]() {
+        for (uint32_t i = 0U; i < (OPS / 10U); ++i) {
+            g_sink = sensor.readAll(data) ? data.potassium : 0U;
+            port.clearTransmitted();
+        }
+    }), "ns/readAll");
+    port.setPeer(nullptr);
+}
+
+void benchTelemetry() {
+#if ENABLE_TELEMETRY
+    constexpr uint32_t OPS = 100000U;
+    Sample sample = {};
+    sample.ok = true;
+    report("telemetry sample+frame", nsPerOp(OPS, [&]() {
+        for (uint32_t i = 0U; i < OPS; ++i) {
+            // Every sample leaves the deadband, so each one is batched.
+            sample.timestampMs += 2000U;
+            sample.data.moisture = static_cast<uint16_t>(300U + ((i & 1U) * 100U));
+            telemetry_sample(sample);
+            Serial.clearTransmitted();
+        }
+    }), "ns/sample");
+#endif
+}
+
+int benchTask(int state) {
+    g_sink = g_sink + 1U;
+    return state;
+}
+
+scheduler::Task g_benchTasks[] = {
+    scheduler::Task(timing::LED_TOGGLE_PERIOD_MS, &benchTask),
+    scheduler::Task(timing::SENSOR_READ_PERIOD_MS, &benchTask),
+    scheduler::Task(timing::LCD_UPDATE_PERIOD_MS, &benchTask),
+};
+constexpr uint8_t BENCH_TASK_COUNT = sizeof(g_benchTasks) / sizeof(g_benchTasks[0]);
+
+void benchScheduler() {
+    constexpr uint32_t OPS = 1000000U;
+    scheduler_init(g_benchTasks, BENCH_TASK_COUNT);
+    report("scheduler tick", nsPerOp(OPS, [&]() {
+        for (uint32_t i = 0U; i < OPS; ++i) {
+            scheduler_tick();
+        }
+    }), "ns/tick");
+}
+
+/**
+ * @brief Virtual time: Timer1 driving the scheduler, and one sensor poll on a
+ *        9600 baud bus.
+ */
+void benchVirtual() {
+    hal::reset();
+    scheduler_init(g_benchTasks, BENCH_TASK_COUNT);
+    sei();
+    (void)timebase_init(scheduler::TASK_TICKS_GCD_IN_MS * 1000UL);
+    const uint32_t before = g_sink;
+    const auto start = std::chrono::steady_clock::now();
+    hal::advanceMicros(60000000UL);
+    const std::chrono::duration<double, std::micro> host = std::chrono::steady_clock::now() - start;
+    report("scheduler 60 s virtual, task runs", static_cast<double>(g_sink - before), "runs");
+    report("scheduler 60 s virtual, host time", host.count(), "us");
+
+    hal::FakeStream port(0U);
+    port.begin(pins::SERIAL_BAUD_RATE);
+    soilsim::Slave probe(1U, static_cast<uint32_t>(pins::SERIAL_BAUD_RATE));
+    probe.faults().responseDelayUs = 2000UL;
+    soilsim::Bus bus(static_cast<uint32_t>(pins::SERIAL_BAUD_RATE));
+    bus.attach(probe);
+    soilsim::BusPeer peer(bus);
+    port.setPeer(&peer);
+    ModbusMaster node;
+    SoilSensor sensor(node, RE_PIN, DE_PIN);
+    sensor.begin(port, static_cast<long>(pins::SERIAL_BAUD_RATE));
+    SoilSensor::SensorData data;
+    const uint64_t t0 = hal::micros64();
+    const bool ok = sensor.readAll(data);
+    report(ok ? "soil readAll bus time" : "soil readAll bus time (FAILED)",
+           static_cast<double>(hal::micros64() - t0), "us virtual");
+}
+
+} // anonymous namespace
+
+int main() {
+    hal::reset();
+    benchCrc();
+    benchModbus();
+    benchTelemetry();
+    benchScheduler();
+    benchVirtual();
+    return 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * @file modbus_replay.cpp
+ * @brief Replays a recorded Modbus session into the firmware on the host.
+ * @details The firmware sources (src/ without main.cpp) run on lib/native_hal
+ *          as on the target: setupHardware(), setupScheduler() and Timer1
+ *          driving Task_SoilSensor, whose SoilSensor and ModbusMaster talk to
+ *          mySerial. Instead of a probe, a busreplay::Player holds the other
+ *          end of that port and answers each request with the bytes recorded
+ *          after it, at the recorded delay (lib/busreplay). A field capture
+ *          from the gateway's --trace or a hand-written scenario therefore
+ *          drives decode, timeouts, failure and recovery handling and the
+ *          scheduler exactly as the capture did, on virtual time and much
+ *          faster than real time. A run is bit-exact: the same trace and
+ *          firmware give the same output, byte for byte.
+ *
+ *          The port starts at the trace's first baud rate and the sensor at
+ *          the address of its first request. Output is CSV, one line per
+ *          sample the sensor task publishes (the header and summary lines
+ *          start with #). The run ends with the first sample completed after
+ *          the trace, or at the first byte the firmware sends that the trace
+ *          does not have, which is reported with the trace line.
+ *          --expect compares the output with a previous run's, which turns a
+ *          capture and its output into a regression test; speed goes to
+ *          stderr.
+ *
+ *          Build from the repository root:
+ *
+ *              g++ -std=gnu++11 -O2 -DF_CPU=16000000UL -Ilib/native_hal/include -Iinclude \
+ *                  -Ilib/cobs -Ilib/fmt -Ilib/lcd -Ilib/modbus -Ilib/soilsensor -Ilib/tscodec -Ilib/busreplay \
+ *                  tools/replay/modbus_replay.cpp \
+ *                  $(find src lib/cobs lib/fmt lib/lcd lib/modbus lib/soilsensor lib/tscodec lib/busreplay \
+ *                  lib/native_hal -name '*.cpp' ! -name main.cpp) -o modbus_replay
+ *              ./modbus_replay tools/replay/scenarios/timeout_recovery.trace \
+ *                  --expect tools/replay/scenarios/timeout_recovery.csv
+ *
+ *          or `pio run -e replay` and .pio/build/replay/program.
+ *          `pio test -e native_test` replays every trace in
+ *          tools/replay/scenarios against the .csv beside it.
+ */
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <Arduino.h>
+#include "native_hal.h"
+#include "busreplay_hal.h"
+#include "channels.h"
+#include "config.h"
+#include "setup.h"
+#include "tasks.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+/// Virtual time per idle-loop pass; Timer1 runs the tasks inside it.
+constexpr uint32_t IDLE_STEP_US = 1000UL;
+/// ModbusMaster's response timeout.
+constexpr uint32_t RESPONSE_TIMEOUT_MS = 2000UL;
+
+const char HEADER[] = "# time_ms,ok,moisture,temperature,conductivity,ph,nitrogen,phosphorus,potassium\n";
+
+void append(std::string& out, const char* text) {
+    out += text;
+}
+
+void appendSample(std::string& out, const Sample& sample) {
+    char text[96];
+    (void)snprintf(text, sizeof(text), "%lu,%u", static_cast<unsigned long>(sample.timestampMs), sample.ok ? 1U : 0U);
+    append(out, text);
+    // Channels in SensorData order; a gap is an empty field.
+    for (uint8_t ch = 0U; ch < channels::COUNT; ++ch) {
+        const int16_t value = channels::value(sample.data, ch);
+        if (value == channels::GAP) {
+            append(out, ",");
+        } else {
+            (void)snprintf(text, sizeof(text), ",%d", static_cast<int>(value));
+            append(out, text);
+        }
+    }
+    append(out, "\n");
+}
+
+/// Prints the first line where @p actual and the file at @p path differ.
+bool matches(const std::string& actual, const char* path) {
+    FILE* in = fopen(path, "r");
+    if (in == nullptr) {
+        perror(path);
+        return false;
+    }
+    std::string expected;
+    char chunk[512];
+    size_t n = 0U;
+    while ((n = fread(chunk, 1U, sizeof(chunk), in)) != 0U) {
+        expected.append(chunk, n);
+    }
+    (void)fclose(in);
+    if (expected == actual) {
+        return true;
+    }
+    size_t at = 0U;
+    while ((at < expected.size()) && (at < actual.size()) && (expected[at] == actual[at])) {
+        ++at;
+    }
+    const size_t lineStart = (at == 0U) ? 0U : (actual.rfind('\n', at - 1U) + 1U);
+    unsigned long line = 1UL;
+    for (size_t i = 0U; i < lineStart; ++i) {
+        line += (actual[i] == '\n') ? 1UL : 0UL;
+    }
+    const std::string want = expected.substr(lineStart, expected.find('\n', lineStart) - lineStart);
+    const std::string got = actual.substr(lineStart, actual.find('\n', lineStart) - lineStart);
+    fprintf(stderr, "%s: output differs at line %lu\n  expected: %s\n  actual:   %s\n", path, line, want.c_str(),
+            got.c_str());
+    return false;
+}
+
+#ifndef PIO_UNIT_TESTING
+void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s TRACE [--expect FILE] [--out FILE] [--limit virtual_s]\n", argv0);
+}
+#endif
+
+} // anonymous namespace
+
+/**
+ * @brief Replays @p tracePath once; the body of main() without the arguments.
+ * @param expectPath Output to compare against, or nullptr.
+ * @param outPath File for the output, or nullptr for stdout.
+ * @param limitS Virtual run time limit in seconds; 0 derives it from the trace.
+ * @return 0 on a complete run matching @p expectPath, 1 on divergence,
+ *         an incomplete run or a mismatch, 2 if the trace or output fails.
+ */
+int modbus_replay_run(const char* tracePath, const char* expectPath, const char* outPath, uint32_t limitS) {
+    busreplay::Trace trace;
+    char error[96];
+    if (!busreplay::load(tracePath, trace, error, sizeof(error))) {
+        fprintf(stderr, "%s: %s\n", tracePath, error);
+        return 2;
+    }
+    size_t requests = 0U;
+    const busreplay::Frame* first = nullptr;
+    for (const busreplay::Frame& frame : trace.frames) {
+        if (frame.dir == busreplay::Frame::Dir::TX) {
+            first = (first == nullptr) ? &frame : first;
+            ++requests;
+        }
+    }
+    if (first == nullptr) {
+        fprintf(stderr, "%s: no requests to replay\n", tracePath);
+        return 2;
+    }
+    if (limitS == 0UL) {
+        // Every request may time out, and polls are a period apart.
+        limitS = static_cast<uint32_t>(
+            (requests * (RESPONSE_TIMEOUT_MS + timing::SENSOR_READ_PERIOD_MS)) / 1000UL) + 10UL;
+    }
+
+    hal::reset();
+    init();
+    setupHardware();
+    mySerial.begin(first->baud);
+    gSensor.setSlaveAddress(first->bytes[0]);
+    busreplay::Player player(trace);
+    mySerial.setPeer(&player);
+    player.start(mySerial);
+    setupScheduler();
+    sei();
+
+    std::string out;
+    append(out, HEADER);
+    const uint64_t limit = static_cast<uint64_t>(limitS) * 1000000ULL * hal::CYCLES_PER_US;
+    const auto start = std::chrono::steady_clock::now();
+    bool complete = false;
+    while (!complete && !player.diverged() && (hal::cycles() < limit)) {
+        // Played out before this pass: the next sample is the trace's last.
+        const bool played = player.finished();
+        hal::advanceMicros(IDLE_STEP_US);
+        Sample sample;
+        while (gSampleQueue.pop(sample)) {
+            appendSample(out, sample);
+            complete = complete || played;
+        }
+        Serial.clearTransmitted();
+    }
+    const std::chrono::duration<double> host = std::chrono::steady_clock::now() - start;
+
+    char text[192];
+    const uint32_t endMs = static_cast<uint32_t>(hal::micros64() / 1000ULL);
+    if (player.diverged()) {
+        (void)snprintf(text, sizeof(text), "# diverged at %lu ms: %s\n", static_cast<unsigned long>(endMs),
+                       player.divergence());
+        append(out, text);
+    } else if (!complete) {
+        (void)snprintf(text, sizeof(text), "# stopped at %lu ms with the trace %s\n", static_cast<unsigned long>(endMs),
+                       player.finished() ? "played but no sample completed" : "not played out");
+        append(out, text);
+    }
+    const busreplay::PlayerStats& p = player.stats();
+    const ModbusMaster::Stats& s = gSensor.stats();
+    (void)snprintf(text, sizeof(text),
+                   "# trace requests %lu, replies %lu, extra bytes %lu; modbus requests %u, responses %u, "
+                   "exceptions %u, timeouts %u, crc errors %u, bad frames %u\n",
+                   static_cast<unsigned long>(p.requests), static_cast<unsigned long>(p.replies),
+                   static_cast<unsigned long>(p.extra), static_cast<unsigned>(s.requests),
+                   static_cast<unsigned>(s.responses), static_cast<unsigned>(s.exceptions),
+                   static_cast<unsigned>(s.timeouts), static_cast<unsigned>(s.crcErrors),
+                   static_cast<unsigned>(s.badFrames));
+    append(out, text);
+
+    FILE* file = (outPath != nullptr) ? fopen(outPath, "w") : stdout;
+    if (file == nullptr) {
+        perror(outPath);
+        return 2;
+    }
+    (void)fputs(out.c_str(), file);
+    if (file != stdout) {
+        (void)fclose(file);
+    }
+    const double virtualS = static_cast<double>(hal::micros64()) / 1e6;
+    fprintf(stderr, "replayed %.1f s in %.1f ms (%.0fx real time)\n", virtualS, host.count() * 1e3,
+            (host.count() > 0.0) ? (virtualS / host.count()) : 0.0);
+
+    const bool expected = (expectPath == nullptr) || matches(out, expectPath);
+    return (player.diverged() || !complete || !expected) ? 1 : 0;
+}
+
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char** argv) {
+    const char* tracePath = nullptr;
+    const char* expectPath = nullptr;
+    const char* outPath = nullptr;
+    uint32_t limitS = 0UL;
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = (i + 1) < argc;
+        if ((strcmp(argv[i], "--expect") == 0) && hasValue) {
+            expectPath = argv[++i];
+        } else if ((strcmp(argv[i], "--out") == 0) && hasValue) {
+            outPath = argv[++i];
+        } else if ((strcmp(argv[i], "--limit") == 0) && hasValue) {
+            limitS = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+        } else if ((argv[i][0] != '-') && (tracePath == nullptr)) {
+            tracePath = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (tracePath == nullptr) {
+        usage(argv[0]);
+        return 2;
+    }
+    return modbus_replay_run(tracePath, expectPath, outPath, limitS);
+}
+#endif
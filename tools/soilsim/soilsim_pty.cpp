@@ -0,0 +1,290 @@
+/**
+ * @file soilsim_pty.cpp
+ * @brief Serves simulated soil probes (lib/soilsim) on a pseudo-terminal.
+ * @details Anything that talks Modbus RTU to a serial device (a host port of
+ *          the firmware, a Modbus tool, a USB-RS485 dongle's test script) can
+ *          be pointed at the printed /dev/pts path, or at --link, instead of
+ *          real hardware. A pty has no line rate, so request bytes are stamped
+ *          as if they had arrived back to back at the bus rate and reply bytes
+ *          are paced out at that rate, after each slave's response delay and
+ *          byte gaps. The bus rate follows the client's termios speed when it
+ *          sets one of the probe's rates, else --baud.
+ *
+ *          Build from the repository root:
+ *
+ *              g++ -std=gnu++11 -O2 -Ilib/soilsim -Ilib/soilsensor -Ilib/modbus \
+ *                  tools/soilsim/soilsim_pty.cpp lib/soilsim/soilsim.cpp -o soilsim_pty
+ *
+ *          Usage:
+ *
+ *              ./soilsim_pty [--baud 9600] [--link /tmp/soil0] [--slave SPEC]...
+ *
+ *          SPEC is addr[:key=value,...] with keys delay (us), gap (us), noise
+ *          (counts), drop, crc and excrate (per mille), exc (exception code),
+ *          outage (from_ms-until_ms after start), baud and seed. Without
+ *          --slave a single perfect probe answers at address 1. Ctrl-C prints
+ *          the bus and per-slave counters.
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "soilsim.h"
+
+// JSF AV C++ Rule 12: Use file scope for objects not visible externally.
+namespace {
+
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int) {
+    g_stop = 1;
+}
+
+uint64_t nowUs() {
+    timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000ULL) + (static_cast<uint64_t>(ts.tv_nsec) / 1000ULL);
+}
+
+/// Line rate for a termios speed, or 0 if the probe has no such rate.
+uint32_t baudOf(speed_t speed) {
+    switch (speed) {
+        case B2400: return 2400UL;
+        case B4800: return 4800UL;
+        case B9600: return 9600UL;
+        default: return 0UL;
+    }
+}
+
+bool isKey(const char* p, size_t length, const char* key) {
+    return (strlen(key) == length) && (strncmp(p, key, length) == 0);
+}
+
+bool parseSlave(const char* spec, uint32_t baud, std::vector<std::unique_ptr<soilsim::Slave>>& slaves) {
+    char* end = nullptr;
+    const unsigned long address = strtoul(spec, &end, 0);
+    if ((end == spec) || (address == 0UL) || (address > 247UL)) {
+        return false;
+    }
+    soilsim::Faults faults = soilsim::Faults();
+    uint32_t slaveBaud = baud;
+    uint32_t seed = static_cast<uint32_t>(address);
+    const char* p = end;
+    if (*p == ':') {
+        ++p;
+    }
+    while (*p != '\0') {
+        const char* eq = strchr(p, '=');
+        if (eq == nullptr) {
+            return false;
+        }
+        const size_t keyLength = static_cast<size_t>(eq - p);
+        const unsigned long value = strtoul(eq + 1, &end, 0);
+        if (end == (eq + 1)) {
+            return false;
+        }
+        unsigned long until = 0UL;
+        if ((isKey(p, keyLength, "outage")) && (*end == '-')) {
+            const char* second = end + 1;
+            until = strtoul(second, &end, 0);
+            if (end == second) {
+                return false;
+            }
+        }
+        if ((*end != ',') && (*end != '\0')) {
+            return false;
+        }
+
+        if (isKey(p, keyLength, "delay")) {
+            faults.responseDelayUs = static_cast<uint32_t>(value);
+        } else if (isKey(p, keyLength, "gap")) {
+            faults.byteGapUs = static_cast<uint32_t>(value);
+        } else if (isKey(p, keyLength, "noise")) {
+            faults.noise = static_cast<uint16_t>(value);
+        } else if (isKey(p, keyLength, "drop")) {
+            faults.dropPermille = static_cast<uint16_t>(value);
+        } else if (isKey(p, keyLength, "crc")) {
+            faults.corruptPermille = static_cast<uint16_t>(value);
+        } else if (isKey(p, keyLength, "excrate")) {
+            faults.exceptionPermille = static_cast<uint16_t>(value);
+        } else if (isKey(p, keyLength, "exc")) {
+            faults.exceptionCode = static_cast<uint8_t>(value);
+        } else if (isKey(p, keyLength, "outage")) {
+            faults.outageFromUs = static_cast<uint64_t>(value) * 1000ULL;
+            faults.outageUntilUs = static_cast<uint64_t>(until) * 1000ULL;
+        } else if (isKey(p, keyLength, "baud")) {
+            slaveBaud = soilsim::baudForCode(static_cast<uint16_t>(value));
+            if (slaveBaud == 0UL) {
+                return false;
+            }
+        } else if (isKey(p, keyLength, "seed")) {
+            seed = static_cast<uint32_t>(value);
+        } else {
+            return false;
+        }
+        p = (*end == ',') ? (end + 1) : end;
+    }
+
+    slaves.emplace_back(new soilsim::Slave(static_cast<uint8_t>(address), slaveBaud, seed));
+    slaves.back()->faults() = faults;
+    return true;
+}
+
+void usage(const char* argv0) {
+    fprintf(stderr, "usage: %s [--baud 2400|4800|9600] [--link PATH] [--slave addr[:key=value,...]]...\n"
+                    "keys: delay=us gap=us noise=counts drop=pm crc=pm excrate=pm exc=code\n"
+                    "      outage=from_ms-until_ms baud=rate seed=n\n", argv0);
+}
+
+/// One reply byte waiting for its time on the wire.
+struct Pending {
+    uint64_t dueUs;
+    uint8_t value;
+};
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    uint32_t baud = 9600UL;
+    const char* link = nullptr;
+    std::vector<const char*> specs;
+    for (int i = 1; i < argc; ++i) {
+        if ((strcmp(argv[i], "--baud") == 0) && ((i + 1) < argc)) {
+            baud = soilsim::baudForCode(static_cast<uint16_t>(strtoul(argv[++i], nullptr, 0)));
+        } else if ((strcmp(argv[i], "--link") == 0) && ((i + 1) < argc)) {
+            link = argv[++i];
+        } else if ((strcmp(argv[i], "--slave") == 0) && ((i + 1) < argc)) {
+            specs.push_back(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (baud == 0UL) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (specs.empty()) {
+        specs.push_back("1");
+    }
+
+    std::vector<std::unique_ptr<soilsim::Slave>> slaves;
+    soilsim::Bus bus(baud);
+    for (const char* spec : specs) {
+        if (!parseSlave(spec, baud, slaves)) {
+            fprintf(stderr, "bad slave spec: %s\n", spec);
+            return 2;
+        }
+        bus.attach(*slaves.back());
+    }
+
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((master < 0) || (grantpt(master) != 0) || (unlockpt(master) != 0)) {
+        perror("posix_openpt");
+        return 1;
+    }
+    const char* path = ptsname(master);
+    // Holding the slave side open keeps the master readable between clients.
+    const int follower = (path != nullptr) ? open(path, O_RDWR | O_NOCTTY) : -1;
+    if (follower < 0) {
+        perror("open pty");
+        return 1;
+    }
+    termios tio;
+    (void)tcgetattr(follower, &tio);
+    cfmakeraw(&tio);
+    (void)tcsetattr(follower, TCSANOW, &tio);
+    (void)fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+    if (link != nullptr) {
+        (void)unlink(link);
+        if (symlink(path, link) != 0) {
+            perror("symlink");
+            return 1;
+        }
+    }
+    printf("soilsim: %s%s%s, %lu baud, %u slave(s)\n", path, (link != nullptr) ? " -> " : "",
+           (link != nullptr) ? link : "", static_cast<unsigned long>(baud), static_cast<unsigned>(slaves.size()));
+    fflush(stdout);
+
+    (void)signal(SIGINT, onSignal);
+    (void)signal(SIGTERM, onSignal);
+
+    const uint64_t epoch = nowUs();
+    std::deque<Pending> outgoing;
+    soilsim::Reply reply;
+    while (g_stop == 0) {
+        int timeoutMs = -1;
+        if (!outgoing.empty()) {
+            const uint64_t now = nowUs() - epoch;
+            timeoutMs = (outgoing.front().dueUs > now) ? static_cast<int>((outgoing.front().dueUs - now + 999ULL) / 1000ULL) : 0;
+        }
+        pollfd pfd = { master, POLLIN, 0 };
+        const int ready = poll(&pfd, 1, timeoutMs);
+        if ((ready < 0) && (errno != EINTR)) {
+            perror("poll");
+            break;
+        }
+
+        const uint64_t now = nowUs() - epoch;
+        while (!outgoing.empty() && (outgoing.front().dueUs <= now)) {
+            if (write(master, &outgoing.front().value, 1) != 1) {
+                break;
+            }
+            outgoing.pop_front();
+        }
+
+        if ((ready > 0) && ((pfd.revents & POLLIN) != 0)) {
+            uint8_t chunk[soilsim::MAX_FRAME];
+            const ssize_t n = read(master, chunk, sizeof(chunk));
+            if (n <= 0) {
+                continue;
+            }
+            if (tcgetattr(follower, &tio) == 0) {
+                const uint32_t clientBaud = baudOf(cfgetispeed(&tio));
+                bus.setBaud((clientBaud != 0UL) ? clientBaud : baud);
+            }
+            const uint32_t charUs = bus.charUs();
+            for (ssize_t i = 0; i < n; ++i) {
+                // The chunk arrived together; spread it back over the wire time.
+                const uint64_t end = now - (static_cast<uint64_t>(n - 1 - i) * charUs);
+                if (!bus.receive(chunk[i], end, reply)) {
+                    continue;
+                }
+                uint64_t at = reply.startUs;
+                for (uint16_t b = 0U; b < reply.length; ++b) {
+                    at += charUs;
+                    outgoing.push_back(Pending{ at, reply.bytes[b] });
+                    at += reply.byteGapUs;
+                }
+            }
+        }
+    }
+
+    const soilsim::BusStats& s = bus.stats();
+    printf("\nbus: frames %lu, crc errors %lu, fragments %lu, unanswered %lu\n",
+           static_cast<unsigned long>(s.frames), static_cast<unsigned long>(s.crcErrors),
+           static_cast<unsigned long>(s.fragments), static_cast<unsigned long>(s.unanswered));
+    for (const std::unique_ptr<soilsim::Slave>& slave : slaves) {
+        const soilsim::SlaveStats& t = slave->stats();
+        printf("slave %u: requests %lu, replies %lu, exceptions %lu, dropped %lu, corrupted %lu\n",
+               static_cast<unsigned>(slave->address()), static_cast<unsigned long>(t.requests),
+               static_cast<unsigned long>(t.replies), static_cast<unsigned long>(t.exceptions),
+               static_cast<unsigned long>(t.dropped), static_cast<unsigned long>(t.corrupted));
+    }
+    if (link != nullptr) {
+        (void)unlink(link);
+    }
+    close(follower);
+    close(master);
+    return 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file telemetry_cli.cpp
+ * @brief Prints the firmware's binary telemetry as text lines.
+ * @details Reads a serial device (configured raw at the given baud rate), a
+ *          capture file, or stdin ("-"), decodes every frame and prints one
+ *          line per sample, health report or profiler report. At end of
+ *          input a summary of lost and corrupted frames goes to stderr.
+ *
+ *          On a serial device, lines typed on stdin are sent to the firmware
+ *          console (console.h); its replies print as "> text".
+ *
+ *          Build from the repository root (Linux/macOS):
+ *
+ *              g++ -std=c++11 -O2 -Iinclude -Ilib/cobs -Itools/telemetry \
+ *                  tools/telemetry/telemetry_cli.cpp tools/telemetry/telemetry_decoder.cpp \
+ *                  lib/cobs/cobs.cpp -o telemetry_cli
+ *
+ *              ./telemetry_cli -b 57600 /dev/ttyACM0
+ */
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "telemetry_decoder.h"
+
+namespace {
+
+speed_t toSpeed(long baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        default: return B0;
+    }
+}
+
+bool configureSerial(int fd, long baud) {
+    const speed_t speed = toSpeed(baud);
+    termios tio;
+    if ((speed == B0) || (tcgetattr(fd, &tio) != 0)) {
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+void usage(const char* argv0) {
+    std::fprintf(stderr, "usage: %s [-b baud] <serial-device | capture-file | ->\n", argv0);
+}
+
+} // anonymous namespace
+
+int main(int argc, char** argv) {
+    long baud = 57600;  // telemetry::BAUD_RATE in include/config.h
+    int opt = 0;
+    while ((opt = getopt(argc, argv, "b:h")) != -1) {
+        if (opt == 'b') {
+            baud = std::strtol(optarg, nullptr, 10);
+        } else {
+            usage(argv[0]);
+            return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if (optind != (argc - 1)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char* path = argv[optind];
+    const int fd = (std::strcmp(path, "-") == 0) ? STDIN_FILENO : open(path, O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        std::fprintf(stderr, "%s: %s\n", path, std::strerror(errno));
+        return EXIT_FAILURE;
+    }
+    const bool device = (fd != STDIN_FILENO) && isatty(fd);
+    if (device && !configureSerial(fd, baud)) {
+        std::fprintf(stderr, "%s: cannot configure %ld baud\n", path, baud);
+        return EXIT_FAILURE;
+    }
+
+    telemetry_host::StreamDecoder decoder;
+    telemetry_host::Frame frame;
+    uint8_t chunk[256];
+    pollfd fds[2] = { { fd, POLLIN, 0 }, { STDIN_FILENO, POLLIN, 0 } };
+    nfds_t watched = device ? 2U : 1U;  // Console input only goes to a device
+    while (poll(fds, watched, -1) > 0) {
+        if ((watched > 1U) && ((fds[1].revents & (POLLIN | POLLHUP)) != 0)) {
+            const ssize_t typed = read(STDIN_FILENO, chunk, sizeof(chunk));
+            if (typed <= 0) {
+                watched = 1U;  // stdin closed: keep decoding
+            } else if (write(fd, chunk, static_cast<size_t>(typed)) != typed) {
+                break;
+            }
+        }
+        if ((fds[0].revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+            continue;
+        }
+        const ssize_t got = read(fd, chunk, sizeof(chunk));
+        if (got <= 0) {
+            break;
+        }
+        for (ssize_t i = 0; i < got; ++i) {
+            if (decoder.feed(chunk[i], frame)) {
+                std::printf("%s\n", telemetry_host::formatFrame(frame).c_str());
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    const telemetry_host::Stats& s = decoder.stats();
+    std::fprintf(stderr, "frames=%lu lost=%lu crc_errors=%lu framing_errors=%lu\n",
+                 static_cast<unsigned long>(s.frames), static_cast<unsigned long>(s.lostFrames),
+                 static_cast<unsigned long>(s.crcErrors), static_cast<unsigned long>(s.framingErrors));
+    return EXIT_SUCCESS;
+}
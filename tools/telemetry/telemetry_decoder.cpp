@@ -0,0 +1,196 @@
+#include <cstdio>
+#include "telemetry_decoder.h"
+
+namespace telemetry_host {
+
+namespace {
+
+const char* const CHANNEL_NAMES[telemetry::CHANNELS] = {
+    "moisture", "temp", "ec", "ph", "n", "p", "k"
+};
+// Fixed-point decimals per channel (channels.h).
+const uint8_t CHANNEL_DECIMALS[telemetry::CHANNELS] = { 1U, 1U, 0U, 2U, 0U, 0U, 0U };
+
+const char* const HEALTH_NAMES[telemetry::HEALTH_COUNTER_COUNT] = {
+    "sensor_failures", "queue_drops", "lcd_drops", "log_drops", "frame_drops", "message_drops",
+    "samples_suppressed"
+};
+
+const char* const LEVEL_NAMES[] = { "error", "warn", "info", "debug" };
+
+uint16_t get16(const uint8_t* in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+uint32_t get32(const uint8_t* in) {
+    return static_cast<uint32_t>(get16(in)) | (static_cast<uint32_t>(get16(&in[2])) << 16);
+}
+
+void appendFixed(std::string& out, int16_t value, uint8_t decimals) {
+    char text[32];
+    if (value == MISSING) {
+        out += "--";
+        return;
+    }
+    if (decimals == 0U) {
+        std::snprintf(text, sizeof(text), "%d", value);
+    } else {
+        const int scale = (decimals == 1U) ? 10 : 100;
+        const int magnitude = (value < 0) ? -value : value;
+        std::snprintf(text, sizeof(text), (decimals == 1U) ? "%s%d.%01d" : "%s%d.%02d",
+                      (value < 0) ? "-" : "", magnitude / scale, magnitude % scale);
+    }
+    out += text;
+}
+
+} // anonymous namespace
+
+bool parseFrame(const uint8_t* data, size_t length, Frame& out) {
+    if (length < (telemetry::HEADER_BYTES + telemetry::CRC_BYTES)) {
+        return false;
+    }
+    const size_t bodyEnd = length - telemetry::CRC_BYTES;
+    if (cobs::crc16(cobs::CRC_INIT, data, static_cast<uint16_t>(bodyEnd)) != get16(&data[bodyEnd])) {
+        return false;
+    }
+    out = Frame();
+    out.type = static_cast<telemetry::FrameType>(data[0]);
+    out.sequence = data[1];
+    const uint8_t* body = &data[telemetry::HEADER_BYTES];
+    const size_t bodyBytes = bodyEnd - telemetry::HEADER_BYTES;
+
+    switch (out.type) {
+        case telemetry::FrameType::SAMPLES: {
+            if ((bodyBytes < 1U) || (bodyBytes != (1U + (static_cast<size_t>(body[0]) * telemetry::SAMPLE_BYTES)))) {
+                return false;
+            }
+            const uint8_t* in = &body[1];
+            for (uint8_t i = 0U; i < body[0]; ++i) {
+                SampleRecord s;
+                s.timestampMs = get32(in);
+                s.ok = (in[4] & telemetry::STATUS_OK) != 0U;
+                for (uint8_t ch = 0U; ch < telemetry::CHANNELS; ++ch) {
+                    s.values[ch] = static_cast<int16_t>(get16(&in[5U + (2U * ch)]));
+                }
+                out.samples.push_back(s);
+                in += telemetry::SAMPLE_BYTES;
+            }
+            return true;
+        }
+        case telemetry::FrameType::HEALTH:
+            if (bodyBytes != telemetry::HEALTH_BODY_BYTES) {
+                return false;
+            }
+            out.uptimeMs = get32(body);
+            for (uint8_t i = 0U; i < telemetry::HEALTH_COUNTER_COUNT; ++i) {
+                out.health[i] = get16(&body[4U + (2U * i)]);
+            }
+            return true;
+        case telemetry::FrameType::PROFILER:
+            if ((bodyBytes < 17U) || (bodyBytes != (17U + (4U * static_cast<size_t>(body[16]))))) {
+                return false;
+            }
+            out.ticks = get32(&body[0]);
+            out.totalTickUs = get32(&body[4]);
+            out.maxTickUs = get32(&body[8]);
+            out.overruns = get32(&body[12]);
+            for (uint8_t i = 0U; i < body[16]; ++i) {
+                out.loadHistogram.push_back(get32(&body[17U + (4U * i)]));
+            }
+            return true;
+        case telemetry::FrameType::LOG:
+            if (bodyBytes < telemetry::LOG_HEADER_BYTES) {
+                return false;
+            }
+            out.level = body[0];
+            out.timestampMs = get32(&body[1]);
+            out.text.assign(reinterpret_cast<const char*>(&body[telemetry::LOG_HEADER_BYTES]),
+                            bodyBytes - telemetry::LOG_HEADER_BYTES);
+            return true;
+        case telemetry::FrameType::REPLY:
+            out.text.assign(reinterpret_cast<const char*>(body), bodyBytes);
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::string formatFrame(const Frame& frame) {
+    std::string line;
+    char text[128];
+    switch (frame.type) {
+        case telemetry::FrameType::SAMPLES:
+            for (size_t i = 0U; i < frame.samples.size(); ++i) {
+                const SampleRecord& s = frame.samples[i];
+                std::snprintf(text, sizeof(text), "%ssample seq=%u t=%lu %s", (i != 0U) ? "\n" : "",
+                              frame.sequence, static_cast<unsigned long>(s.timestampMs), s.ok ? "ok" : "ERR");
+                line += text;
+                for (uint8_t ch = 0U; ch < telemetry::CHANNELS; ++ch) {
+                    line += ' ';
+                    line += CHANNEL_NAMES[ch];
+                    line += '=';
+                    appendFixed(line, s.values[ch], CHANNEL_DECIMALS[ch]);
+                }
+            }
+            break;
+        case telemetry::FrameType::HEALTH:
+            std::snprintf(text, sizeof(text), "health seq=%u uptime_ms=%lu", frame.sequence,
+                          static_cast<unsigned long>(frame.uptimeMs));
+            line += text;
+            for (uint8_t i = 0U; i < telemetry::HEALTH_COUNTER_COUNT; ++i) {
+                std::snprintf(text, sizeof(text), " %s=%u", HEALTH_NAMES[i], frame.health[i]);
+                line += text;
+            }
+            break;
+        case telemetry::FrameType::PROFILER:
+            std::snprintf(text, sizeof(text), "profiler seq=%u ticks=%lu max_us=%lu avg_us=%lu overruns=%lu load:",
+                          frame.sequence, static_cast<unsigned long>(frame.ticks),
+                          static_cast<unsigned long>(frame.maxTickUs),
+                          static_cast<unsigned long>((frame.ticks != 0U) ? (frame.totalTickUs / frame.ticks) : 0U),
+                          static_cast<unsigned long>(frame.overruns));
+            line += text;
+            for (size_t i = 0U; i < frame.loadHistogram.size(); ++i) {
+                std::snprintf(text, sizeof(text), " %zu=%lu", i, static_cast<unsigned long>(frame.loadHistogram[i]));
+                line += text;
+            }
+            break;
+        case telemetry::FrameType::LOG:
+            std::snprintf(text, sizeof(text), "log seq=%u t=%lu %s: ", frame.sequence,
+                          static_cast<unsigned long>(frame.timestampMs), LEVEL_NAMES[frame.level & 3U]);
+            line += text;
+            line += frame.text;
+            break;
+        case telemetry::FrameType::REPLY:
+            line += "> ";
+            line += frame.text;
+            break;
+    }
+    return line;
+}
+
+StreamDecoder::StreamDecoder()
+    : buffer(), cobs(buffer, MAX_FRAME_BYTES), counters(), haveSequence(false), lastSequence(0U) {}
+
+bool StreamDecoder::feed(uint8_t byte, Frame& out) {
+    const cobs::Decoder::Status status = cobs.feed(byte);
+    if (status == cobs::Decoder::Status::ERROR) {
+        ++counters.framingErrors;
+        return false;
+    }
+    if (status != cobs::Decoder::Status::FRAME) {
+        return false;
+    }
+    if (!parseFrame(buffer, cobs.length(), out)) {
+        ++counters.crcErrors;
+        return false;
+    }
+    if (haveSequence) {
+        counters.lostFrames += static_cast<uint8_t>(out.sequence - lastSequence - 1U);
+    }
+    haveSequence = true;
+    lastSequence = out.sequence;
+    ++counters.frames;
+    return true;
+}
+
+} // namespace telemetry_host
@@ -0,0 +1,93 @@
+#ifndef TELEMETRY_DECODER_H
+#define TELEMETRY_DECODER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "cobs.h"
+#include "telemetry_protocol.h"
+
+/**
+ * @file telemetry_decoder.h
+ * @brief Host-side decoder for the firmware's binary telemetry stream.
+ * @details Feed raw bytes from the serial port; complete, CRC-checked frames
+ *          come back parsed. Text printed before the stream starts (the boot
+ *          banner) and corrupted frames are counted and skipped.
+ */
+namespace telemetry_host {
+
+struct SampleRecord {
+    uint32_t timestampMs;
+    bool ok;
+    int16_t values[telemetry::CHANNELS];  ///< channels.h units, MISSING if absent.
+};
+
+constexpr int16_t MISSING = -32768;
+
+struct Frame {
+    telemetry::FrameType type;
+    uint8_t sequence;
+    std::vector<SampleRecord> samples;               ///< SAMPLES
+    uint32_t uptimeMs;                               ///< HEALTH
+    uint16_t health[telemetry::HEALTH_COUNTER_COUNT];
+    uint32_t ticks;                                  ///< PROFILER
+    uint32_t totalTickUs;
+    uint32_t maxTickUs;
+    uint32_t overruns;
+    std::vector<uint32_t> loadHistogram;
+    uint8_t level;                                   ///< LOG
+    uint32_t timestampMs;
+    std::string text;                                ///< LOG, REPLY
+};
+
+struct Stats {
+    uint32_t frames;         ///< Valid frames decoded.
+    uint32_t framingErrors;  ///< COBS errors (includes non-telemetry text).
+    uint32_t crcErrors;      ///< Frames failing the CRC or length checks.
+    uint32_t lostFrames;     ///< Gaps in the sequence numbers.
+};
+
+/**
+ * @brief Parses one decoded (un-stuffed) frame.
+ * @return false if the CRC fails or the body does not match the type.
+ */
+bool parseFrame(const uint8_t* data, size_t length, Frame& out);
+
+/**
+ * @brief One line of human-readable text for @p frame.
+ */
+std::string formatFrame(const Frame& frame);
+
+/**
+ * @class StreamDecoder
+ * @brief Byte-stream front end: COBS, CRC, parsing and loss accounting.
+ */
+class StreamDecoder {
+public:
+    StreamDecoder();
+
+    StreamDecoder(const StreamDecoder&) = delete;
+    StreamDecoder& operator=(const StreamDecoder&) = delete;
+
+    /**
+     * @brief Consumes one received byte.
+     * @return true if @p out now holds a complete frame.
+     */
+    bool feed(uint8_t byte, Frame& out);
+
+    const Stats& stats() const { return counters; }
+
+private:
+    static constexpr uint16_t MAX_FRAME_BYTES = 512U;
+
+    uint8_t buffer[MAX_FRAME_BYTES];
+    cobs::Decoder cobs;
+    Stats counters;
+    bool haveSequence;
+    uint8_t lastSequence;
+};
+
+} // namespace telemetry_host
+
+#endif // TELEMETRY_DECODER_H